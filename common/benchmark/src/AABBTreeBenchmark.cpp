@@ -35,6 +35,11 @@
 #include <kdl/overload.h>
 
 #include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <vector>
 
 #include "BenchmarkUtils.h"
 #include "../../test/src/Catch2.h"
@@ -67,5 +72,51 @@ namespace TrenchBroom {
                 ));
             }
         }, "Add objects to AABB tree");
+
+        auto nodes = std::vector<Model::Node*>{};
+        world->accept(kdl::overload(
+            [] (auto&& thisLambda, Model::WorldNode* world_)  { world_->visitChildren(thisLambda); },
+            [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
+            [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
+            [&](auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); nodes.push_back(entity); },
+            [&](Model::BrushNode* brush)                      { nodes.push_back(brush); },
+            [&](Model::PatchNode* patch)                      { nodes.push_back(patch); }
+        ));
+
+        std::vector<AABB> bulkTrees(100);
+        timeLambda([&]() {
+            for (auto& tree : bulkTrees) {
+                tree.clearAndBuild(nodes, [](const auto* node) { return node->physicalBounds(); });
+            }
+        }, "Build AABB tree from objects in bulk");
+
+        // cast rays from points on a sphere around the map towards points near its center
+        const auto& bounds = bulkTrees.front().bounds();
+        const auto radius = vm::length(bounds.size());
+        auto rays = std::vector<vm::ray3>{};
+        for (size_t i = 0; i < 10000; ++i) {
+            const auto angle1 = static_cast<double>(i) * 0.1;
+            const auto angle2 = static_cast<double>(i) * 0.037;
+            const auto direction = vm::vec3(std::cos(angle1) * std::cos(angle2), std::sin(angle1) * std::cos(angle2), std::sin(angle2));
+            const auto origin = bounds.center() + direction * radius;
+            const auto target = bounds.center() + bounds.size() * (0.25 * std::sin(angle1 * 3.0));
+            rays.emplace_back(origin, vm::normalize(target - origin));
+        }
+
+        const auto countIntersectors = [&](const AABB& tree) {
+            auto count = size_t(0);
+            for (const auto& ray : rays) {
+                count += tree.findIntersectors(ray).size();
+            }
+            return count;
+        };
+
+        auto incrementalCount = size_t(0);
+        timeLambda([&]() { incrementalCount = countIntersectors(trees.front()); }, "Find intersectors of 10000 rays in incrementally built tree");
+
+        auto bulkCount = size_t(0);
+        timeLambda([&]() { bulkCount = countIntersectors(bulkTrees.front()); }, "Find intersectors of 10000 rays in tree built in bulk");
+
+        CHECK(bulkCount == incrementalCount);
     }
 }
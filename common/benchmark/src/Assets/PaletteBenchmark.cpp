@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "Assets/Palette.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/Reader.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        // the previous implementation of Palette::indexedToRgba, which summed the color of every pixel
+        static bool referenceIndexedToRgba(const std::vector<unsigned char>& paletteData, const unsigned char* indexedImage, const size_t pixelCount, TextureBuffer& rgbaImage, Color& averageColor) {
+            unsigned char* const rgbaData = rgbaImage.data();
+            for (size_t i = 0; i < pixelCount; ++i) {
+                const int index = static_cast<int>(indexedImage[i]);
+                std::memcpy(rgbaData + (i * 4), &paletteData[static_cast<size_t>(index) * 4], 4);
+            }
+
+            uint32_t colorSum[3] = {0, 0, 0};
+            for (size_t i = 0; i < pixelCount; ++i) {
+                colorSum[0] += static_cast<uint32_t>(rgbaData[(i * 4) + 0]);
+                colorSum[1] += static_cast<uint32_t>(rgbaData[(i * 4) + 1]);
+                colorSum[2] += static_cast<uint32_t>(rgbaData[(i * 4) + 2]);
+            }
+            averageColor = Color(static_cast<float>(colorSum[0]) / (255.0f * static_cast<float>(pixelCount)),
+                                 static_cast<float>(colorSum[1]) / (255.0f * static_cast<float>(pixelCount)),
+                                 static_cast<float>(colorSum[2]) / (255.0f * static_cast<float>(pixelCount)),
+                                 1.0f);
+
+            unsigned char andAlpha = 0xff;
+            for (size_t i = 0; i < pixelCount; ++i) {
+                andAlpha &= rgbaData[(i * 4) + 3];
+            }
+            return andAlpha != 0xff;
+        }
+
+        TEST_CASE("PaletteBenchmark.indexedToRgba", "[PaletteBenchmark]") {
+            // roughly the size of the textures of all Quake wads: 2000 textures of 128*128 pixels with 4 mip levels
+            const size_t textureCount = 2000;
+            const size_t size = 128;
+
+            auto random = std::mt19937{};
+            auto paletteData = std::vector<unsigned char>(768);
+            for (auto& component : paletteData) {
+                component = static_cast<unsigned char>(random() % 256u);
+            }
+            const auto palette = Palette{paletteData};
+
+            auto referencePaletteData = std::vector<unsigned char>{};
+            for (size_t i = 0; i < 256; ++i) {
+                referencePaletteData.insert(std::end(referencePaletteData), { paletteData[3 * i + 0], paletteData[3 * i + 1], paletteData[3 * i + 2], i == 255 ? 0x00 : 0xFF });
+            }
+
+            // textures have large uniform areas, so use short runs of random indices
+            auto mipSizes = std::vector<size_t>{};
+            auto indexedImages = std::vector<std::vector<unsigned char>>{};
+            for (size_t i = 0; i < textureCount; ++i) {
+                for (size_t mip = 0; mip < 4; ++mip) {
+                    const auto mipSize = (size >> mip) * (size >> mip);
+                    auto indexedImage = std::vector<unsigned char>(mipSize);
+                    for (size_t j = 0; j < mipSize; ++j) {
+                        indexedImage[j] = j % 8 == 0 ? static_cast<unsigned char>(random() % 256u) : indexedImage[j - 1];
+                    }
+                    indexedImages.push_back(std::move(indexedImage));
+                }
+            }
+
+            auto referenceBuffers = std::vector<TextureBuffer>{};
+            auto buffers = std::vector<TextureBuffer>{};
+            for (const auto& indexedImage : indexedImages) {
+                referenceBuffers.emplace_back(4 * indexedImage.size());
+                buffers.emplace_back(4 * indexedImage.size());
+            }
+
+            auto referenceColors = std::vector<Color>(indexedImages.size());
+            auto referenceTransparency = std::vector<bool>(indexedImages.size());
+            timeLambda([&]() {
+                for (size_t i = 0; i < indexedImages.size(); ++i) {
+                    auto color = Color{};
+                    referenceTransparency[i] = referenceIndexedToRgba(referencePaletteData, indexedImages[i].data(), indexedImages[i].size(), referenceBuffers[i], color);
+                    referenceColors[i] = color;
+                }
+            }, "Convert " + std::to_string(indexedImages.size()) + " mips with per pixel loops");
+
+            auto colors = std::vector<Color>(indexedImages.size());
+            auto transparency = std::vector<bool>(indexedImages.size());
+            timeLambda([&]() {
+                for (size_t i = 0; i < indexedImages.size(); ++i) {
+                    const auto& indexedImage = indexedImages[i];
+                    auto reader = IO::Reader::from(reinterpret_cast<const char*>(indexedImage.data()), reinterpret_cast<const char*>(indexedImage.data() + indexedImage.size())).buffer();
+                    auto color = Color{};
+                    transparency[i] = palette.indexedToRgba(reader, indexedImage.size(), buffers[i], PaletteTransparency::Index255Transparent, color);
+                    colors[i] = color;
+                }
+            }, "Convert " + std::to_string(indexedImages.size()) + " mips with Palette::indexedToRgba");
+
+            for (size_t i = 0; i < indexedImages.size(); ++i) {
+                CHECK(std::memcmp(buffers[i].data(), referenceBuffers[i].data(), buffers[i].size()) == 0);
+                CHECK(colors[i] == referenceColors[i]);
+                CHECK(transparency[i] == referenceTransparency[i]);
+            }
+        }
+    }
+}
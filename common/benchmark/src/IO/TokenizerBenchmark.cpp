@@ -0,0 +1,76 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/StandardMapParser.h"
+
+#include <kdl/string_utils.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST_CASE("TokenizerBenchmark.tokenizeMap", "[TokenizerBenchmark]") {
+            const auto mapPath = Disk::getCurrentWorkingDir() + Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+            const auto str = fileReader.stringView();
+
+            auto numbers = std::vector<std::string_view>{};
+            timeLambda([&]() {
+                for (size_t i = 0; i < 10; ++i) {
+                    numbers.clear();
+
+                    auto tokenizer = QuakeMapTokenizer{str};
+                    auto token = tokenizer.nextToken();
+                    while (!token.hasType(QuakeMapToken::Eof)) {
+                        if (token.hasType(QuakeMapToken::Number)) {
+                            numbers.emplace_back(token.begin(), token.length());
+                        }
+                        token = tokenizer.nextToken();
+                    }
+                }
+            }, "Tokenize map 10 times");
+
+            auto sum = 0.0;
+            timeLambda([&]() {
+                for (const auto& number : numbers) {
+                    sum += kdl::str_to_double(std::string{number}).value_or(0.0);
+                }
+            }, "Convert " + std::to_string(numbers.size()) + " numbers with str_to_double");
+
+            auto fastSum = 0.0;
+            timeLambda([&]() {
+                for (const auto& number : numbers) {
+                    fastSum += kdl::str_parse_double(number).value_or(0.0);
+                }
+            }, "Convert " + std::to_string(numbers.size()) + " numbers with str_parse_double");
+
+            CHECK(fastSum == sum);
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "AABBTree.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/EditorContext.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/PatchNode.h"
+#include "Model/PickResult.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        TEST_CASE("BrushNodeBenchmark.pick", "[BrushNodeBenchmark]") {
+            const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = IO::Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            IO::TestParserStatus status;
+            IO::WorldReader worldReader(fileReader.stringView(), MapFormat::Standard);
+
+            const vm::bbox3 worldBounds(8192.0);
+            auto world = worldReader.read(worldBounds, status);
+
+            auto brushNodes = std::vector<BrushNode*>{};
+            world->accept(kdl::overload(
+                [] (auto&& thisLambda, WorldNode* world_)  { world_->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, LayerNode* layer)   { layer->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, GroupNode* group)   { group->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, EntityNode* entity) { entity->visitChildren(thisLambda); },
+                [&](BrushNode* brush)                      { brushNodes.push_back(brush); },
+                [] (PatchNode*)                            {}
+            ));
+
+            auto tree = AABBTree<double, 3, BrushNode*>{};
+            tree.clearAndBuild(brushNodes, [](const auto* brushNode) { return brushNode->physicalBounds(); });
+
+            // cast rays from points near the map center in all directions so that they pass through dense areas
+            const auto& bounds = tree.bounds();
+            auto rays = std::vector<vm::ray3>{};
+            for (size_t i = 0; i < 10000; ++i) {
+                const auto angle1 = static_cast<double>(i) * 0.1;
+                const auto angle2 = static_cast<double>(i) * 0.037;
+                const auto direction = vm::vec3(std::cos(angle1) * std::cos(angle2), std::sin(angle1) * std::cos(angle2), std::sin(angle2));
+                const auto origin = bounds.center() + bounds.size() * (0.25 * std::sin(angle1 * 3.0));
+                rays.emplace_back(origin, direction);
+            }
+
+            auto candidates = std::vector<std::vector<BrushNode*>>{};
+            candidates.reserve(rays.size());
+            auto candidateCount = size_t(0);
+            for (const auto& ray : rays) {
+                candidates.push_back(tree.findIntersectors(ray));
+                candidateCount += candidates.back().size();
+            }
+
+            const auto editorContext = EditorContext{};
+
+            // warm up the face plane caches
+            for (size_t i = 0; i < rays.size(); ++i) {
+                for (auto* brushNode : candidates[i]) {
+                    auto pickResult = PickResult{};
+                    brushNode->pick(editorContext, rays[i], pickResult);
+                }
+            }
+
+            auto polygonHitCount = size_t(0);
+            timeLambda([&]() {
+                for (size_t i = 0; i < rays.size(); ++i) {
+                    for (const auto* brushNode : candidates[i]) {
+                        for (const auto& face : brushNode->brush().faces()) {
+                            if (!vm::is_nan(face.intersectWithRay(rays[i]))) {
+                                ++polygonHitCount;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }, "Test face polygons of " + std::to_string(candidateCount) + " candidate brushes");
+
+            auto pickHitCount = size_t(0);
+            timeLambda([&]() {
+                for (size_t i = 0; i < rays.size(); ++i) {
+                    auto pickResult = PickResult{};
+                    for (auto* brushNode : candidates[i]) {
+                        brushNode->pick(editorContext, rays[i], pickResult);
+                    }
+                    pickHitCount += pickResult.size();
+                }
+            }, "Pick " + std::to_string(candidateCount) + " candidate brushes");
+
+            CHECK(pickHitCount == polygonHitCount);
+        }
+    }
+}
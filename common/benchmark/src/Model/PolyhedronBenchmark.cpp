@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/PatchNode.h"
+#include "Model/Polyhedron.h"
+#include "Model/Polyhedron3.h"
+#include "Model/Polyhedron_Instantiation.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static std::vector<std::vector<vm::vec3>> loadBrushVertices() {
+            const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = IO::Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            IO::TestParserStatus status;
+            IO::WorldReader worldReader(fileReader.stringView(), MapFormat::Standard);
+
+            const vm::bbox3 worldBounds(8192.0);
+            auto world = worldReader.read(worldBounds, status);
+
+            auto result = std::vector<std::vector<vm::vec3>>{};
+            world->accept(kdl::overload(
+                [] (auto&& thisLambda, WorldNode* worldNode)   { worldNode->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, LayerNode* layerNode)   { layerNode->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, GroupNode* groupNode)   { groupNode->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, EntityNode* entityNode) { entityNode->visitChildren(thisLambda); },
+                [&](BrushNode* brushNode)                      { result.push_back(brushNode->brush().vertexPositions()); },
+                [] (PatchNode*)                                {}
+            ));
+            return result;
+        }
+
+        TEST_CASE("PolyhedronBenchmark.buildCopyTraverse", "[PolyhedronBenchmark]") {
+            const auto brushVertices = loadBrushVertices();
+            const auto repetitions = size_t(10);
+
+            auto polyhedra = std::vector<Polyhedron3>{};
+            polyhedra.reserve(repetitions * brushVertices.size());
+            timeLambda([&]() {
+                for (size_t i = 0; i < repetitions; ++i) {
+                    for (const auto& vertices : brushVertices) {
+                        polyhedra.emplace_back(vertices);
+                    }
+                }
+            }, "Build " + std::to_string(polyhedra.capacity()) + " polyhedra");
+
+            auto copies = std::vector<Polyhedron3>{};
+            copies.reserve(polyhedra.size());
+            timeLambda([&]() {
+                for (const auto& polyhedron : polyhedra) {
+                    copies.push_back(polyhedron);
+                }
+            }, "Copy " + std::to_string(polyhedra.size()) + " polyhedra");
+
+            auto sum = vm::vec3::zero();
+            timeLambda([&]() {
+                for (size_t i = 0; i < 10; ++i) {
+                    for (const auto& polyhedron : copies) {
+                        for (const auto* face : polyhedron.faces()) {
+                            for (const auto* halfEdge : face->boundary()) {
+                                sum = sum + halfEdge->origin()->position();
+                            }
+                        }
+                    }
+                }
+            }, "Traverse the faces of " + std::to_string(copies.size()) + " polyhedra 10 times");
+
+            timeLambda([&]() {
+                polyhedra.clear();
+                copies.clear();
+            }, "Destroy " + std::to_string(2u * brushVertices.size() * repetitions) + " polyhedra");
+
+            CHECK(sum != vm::vec3::zero());
+        }
+    }
+}
@@ -21,14 +21,21 @@
 
 #include "Exceptions.h"
 
+#include <kdl/thread_pool.h>
+
 #include <vecmath/scalar.h>
 #include <vecmath/bbox.h>
 #include <vecmath/bbox_io.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <iosfwd>
+#include <iterator>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 
@@ -36,6 +43,10 @@ namespace TrenchBroom {
 /**
  * An axis aligned bounding box tree that allows for quick ray intersection queries.
  *
+ * The tree can be built incrementally by inserting, removing and updating single objects, or in bulk using
+ * clearAndBuild. A tree that was built in bulk additionally keeps a flattened copy of its nodes which speeds up queries
+ * until the tree is modified again.
+ *
  * @tparam T the floating point type
  * @tparam S the number of dimensions for vector types
  * @tparam U the node data to store in the leafs
@@ -52,6 +63,22 @@ namespace TrenchBroom {
         class InnerNode;
         class LeafNode;
 
+        /**
+         * A node of the flattened tree. The nodes are stored in depth first order, so the first child of an inner node
+         * immediately follows its parent, and a subtree can be skipped by jumping to the index stored in `next`.
+         *
+         * The nodes are aligned to cache lines. For double precision 3D boxes, a node fills exactly one cache line.
+         */
+        struct alignas(64) FlatNode {
+            Box bounds;
+            /** The index of the first node that is not part of the subtree rooted at this node. */
+            size_t next;
+            /** The index of this node's data in m_flatData, or NoData if this is an inner node. */
+            size_t dataIndex;
+        };
+
+        static constexpr auto NoData = std::numeric_limits<size_t>::max();
+
         class Visitor {
         public:
             virtual ~Visitor() = default;
@@ -128,6 +155,15 @@ namespace TrenchBroom {
              * @param visitor the visitor to accept
              */
             virtual void accept(Visitor& visitor) const = 0;
+
+            /**
+             * Appends the nodes of the subtree rooted at this node to the given vector in depth first order, and
+             * appends the data of its leafs to the given data vector.
+             *
+             * @param nodes the flattened nodes
+             * @param data the data of the flattened leafs
+             */
+            virtual void flatten(std::vector<FlatNode>& nodes, std::vector<U>& data) const = 0;
         public:
             /**
              * Appends a textual representation of this node to the given output stream.
@@ -365,6 +401,14 @@ namespace TrenchBroom {
                     m_right->accept(visitor);
                 }
             }
+
+            void flatten(std::vector<FlatNode>& nodes, std::vector<U>& data) const override {
+                const auto index = nodes.size();
+                nodes.push_back(FlatNode{this->bounds(), 0u, NoData});
+                m_left->flatten(nodes, data);
+                m_right->flatten(nodes, data);
+                nodes[index].next = nodes.size();
+            }
         public:
             void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
                 for (size_t i = 0; i < level; ++i)
@@ -448,6 +492,11 @@ namespace TrenchBroom {
                 visitor.visit(this);
             }
 
+            void flatten(std::vector<FlatNode>& nodes, std::vector<U>& data) const override {
+                nodes.push_back(FlatNode{this->bounds(), nodes.size() + 1u, data.size()});
+                data.push_back(m_data);
+            }
+
             void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
                 for (size_t i = 0; i < level; ++i)
                     str << indent;
@@ -464,6 +513,12 @@ namespace TrenchBroom {
     private:
         Node* m_root;
         std::unordered_map<U, LeafNode*> m_leafForData;
+
+        /**
+         * The flattened nodes and their data, only valid if the tree was built in bulk and wasn't modified since.
+         */
+        std::vector<FlatNode> m_flatNodes;
+        std::vector<U> m_flatData;
     public:
         AABBTree() : m_root(nullptr) {}
 
@@ -483,19 +538,182 @@ namespace TrenchBroom {
         }
 
         /**
-         * Clears this tree and rebuilds it by inserting given objects.
+         * Clears this tree and rebuilds it from the given objects.
+         *
+         * The tree is built top down by splitting the objects according to the surface area heuristic, and large
+         * subtrees are built in parallel. This yields a better tree in much less time than inserting the objects one
+         * by one. Afterwards, the nodes are also stored in a flattened form that is used for queries until the tree is
+         * modified again.
          *
          * @param objects the objects to insert, a list of DataType
          * @param getBounds a function from DataType -> Box to compute the bounds of each object
+         *
+         * @throws NodeTreeException if the given objects contain duplicates, or if any bounds contains NaN; the tree is
+         * empty afterwards
          */
         template <typename DataList, typename GetBounds>
         void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
             clear();
-            for (const U& object : objects) {
-                insert(getBounds(object), object);
+
+            auto leafs = std::vector<LeafNode*>{};
+            leafs.reserve(std::size(objects));
+
+            try {
+                for (const U& object : objects) {
+                    const auto bounds = getBounds(object);
+                    check(bounds);
+
+                    leafs.push_back(new LeafNode(bounds, object));
+                    if (!m_leafForData.emplace(object, leafs.back()).second) {
+                        throw NodeTreeException("Data already in tree");
+                    }
+                }
+            } catch (...) {
+                for (auto* leaf : leafs) {
+                    delete leaf;
+                }
+                m_leafForData.clear();
+                throw;
+            }
+
+            if (!leafs.empty()) {
+                m_root = buildSubtree(leafs.data(), leafs.data() + leafs.size());
+                m_flatNodes.reserve(2u * leafs.size() - 1u);
+                m_flatData.reserve(leafs.size());
+                m_root->flatten(m_flatNodes, m_flatData);
+            }
+        }
+    private:
+        /**
+         * Builds a subtree containing the given leafs and returns its root. The order of the leafs is changed.
+         */
+        static Node* buildSubtree(LeafNode** begin, LeafNode** end) {
+            assert(begin < end);
+            if (end - begin == 1) {
+                return *begin;
+            }
+
+            auto** mid = splitLeafs(begin, end);
+            if (end - begin < ParallelBuildThreshold) {
+                auto* left = buildSubtree(begin, mid);
+                auto* right = buildSubtree(mid, end);
+                return new InnerNode(left, right);
+            }
+
+            Node* left = nullptr;
+            auto group = kdl::task_group{};
+            group.run([&]() { left = buildSubtree(begin, mid); });
+            auto* right = buildSubtree(mid, end);
+            group.wait();
+
+            return new InnerNode(left, right);
+        }
+
+        /**
+         * Partitions the given range of at least two leafs into two non empty ranges such that the sum of the surface
+         * areas of the bounds of both ranges, weighted by the number of leafs in them, is approximately minimal.
+         *
+         * The leafs are partitioned along the axis on which the centers of their bounds are spread the most. To find
+         * the best split, the centers are sorted into equally sized bins along that axis, and only splits between
+         * bins are considered.
+         *
+         * @return an iterator to the first leaf of the second range
+         */
+        static LeafNode** splitLeafs(LeafNode** begin, LeafNode** end) {
+            auto centerBoundsBuilder = typename Box::builder{};
+            for (auto** it = begin; it != end; ++it) {
+                centerBoundsBuilder.add((*it)->bounds().center());
+            }
+
+            const auto centerMin = centerBoundsBuilder.bounds().min;
+            const auto centerSize = centerBoundsBuilder.bounds().size();
+            size_t axis = 0;
+            for (size_t i = 1; i < S; ++i) {
+                if (centerSize[i] > centerSize[axis]) {
+                    axis = i;
+                }
+            }
+
+            if (centerSize[axis] <= T(0)) {
+                // all centers coincide, any split is as good as any other
+                return begin + (end - begin) / 2;
+            }
+
+            const auto binScale = T(BinCount) / centerSize[axis];
+            const auto binIndex = [&](const LeafNode* leaf) {
+                const auto offset = leaf->bounds().center()[axis] - centerMin[axis];
+                return std::min(static_cast<size_t>(offset * binScale), BinCount - 1u);
+            };
+
+            struct Bin {
+                typename Box::builder bounds;
+                size_t count = 0u;
+            };
+
+            auto bins = std::array<Bin, BinCount>{};
+            for (auto** it = begin; it != end; ++it) {
+                auto& bin = bins[binIndex(*it)];
+                bin.bounds.add((*it)->bounds());
+                ++bin.count;
+            }
+
+            // The first and the last bin contain at least one leaf each, so every split yields two non empty ranges.
+            // Compute the cost of the leafs to the right of each split first.
+            auto rightCosts = std::array<T, BinCount>{};
+            auto rightBounds = typename Box::builder{};
+            auto rightCount = size_t(0);
+            for (size_t i = BinCount - 1u; i > 0u; --i) {
+                if (bins[i].count > 0u) {
+                    rightBounds.add(bins[i].bounds.bounds());
+                    rightCount += bins[i].count;
+                }
+                rightCosts[i - 1u] = T(rightCount) * surfaceArea(rightBounds.bounds());
+            }
+
+            auto bestSplit = size_t(0);
+            auto bestCost = std::numeric_limits<T>::max();
+            auto leftBounds = typename Box::builder{};
+            auto leftCount = size_t(0);
+            for (size_t i = 0; i < BinCount - 1u; ++i) {
+                if (bins[i].count > 0u) {
+                    leftBounds.add(bins[i].bounds.bounds());
+                    leftCount += bins[i].count;
+                }
+
+                const auto cost = T(leftCount) * surfaceArea(leftBounds.bounds()) + rightCosts[i];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = i;
+                }
             }
+
+            return std::partition(begin, end, [&](const LeafNode* leaf) { return binIndex(leaf) <= bestSplit; });
+        }
+
+        /**
+         * Returns a value proportional to the surface area of the given box, or its perimeter if S < 3.
+         */
+        static T surfaceArea(const Box& bounds) {
+            const auto size = bounds.size();
+            auto result = T(0);
+            if constexpr (S < 3) {
+                for (size_t i = 0; i < S; ++i) {
+                    result += size[i];
+                }
+            } else {
+                for (size_t i = 0; i < S; ++i) {
+                    for (size_t j = i + 1u; j < S; ++j) {
+                        result += size[i] * size[j];
+                    }
+                }
+            }
+            return result;
         }
 
+        static constexpr size_t BinCount = 16u;
+        static constexpr std::ptrdiff_t ParallelBuildThreshold = 4096;
+    public:
+
         /**
          * Insert a node with the given bounds and data into this tree.
          *
@@ -506,6 +724,7 @@ namespace TrenchBroom {
          */
         void insert(const Box& bounds, const U& data) {
             check(bounds);
+            clearFlatNodes();
 
             // Check that the data isn't already inserted
             if (m_leafForData.find(data) != m_leafForData.end()) {
@@ -540,6 +759,7 @@ namespace TrenchBroom {
             LeafNode* leaf = it->second;
             assert(leaf->data() == data);
             m_leafForData.erase(it);
+            clearFlatNodes();
 
             m_root = leaf->deleteThis();
 
@@ -568,6 +788,38 @@ namespace TrenchBroom {
                 throw NodeTreeException("Cannot add node to AABB tree with invalid bounds");
             }
         }
+
+        void clearFlatNodes() {
+            if (!m_flatNodes.empty()) {
+                m_flatNodes = std::vector<FlatNode>{};
+                m_flatData = std::vector<U>{};
+            }
+        }
+
+        static bool intersects(const vm::ray<T,S>& ray, const Box& bounds) {
+            return bounds.contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds));
+        }
+
+        /**
+         * Appends the data of every flattened leaf whose bounds satisfy the given predicate to the given output
+         * iterator, skipping every subtree whose bounds don't satisfy it.
+         */
+        template <typename P, typename O>
+        void findInFlatNodes(const P& predicate, O out) const {
+            size_t i = 0;
+            while (i < m_flatNodes.size()) {
+                const auto& node = m_flatNodes[i];
+                if (predicate(node.bounds)) {
+                    if (node.dataIndex != NoData) {
+                        out = m_flatData[node.dataIndex];
+                        ++out;
+                    }
+                    ++i;
+                } else {
+                    i = node.next;
+                }
+            }
+        }
     public:
         /**
          * Clears this node tree.
@@ -575,6 +827,7 @@ namespace TrenchBroom {
         void clear() {
             if (!empty()) {
                 m_leafForData.clear();
+                clearFlatNodes();
                 delete m_root;
                 m_root = nullptr;
             }
@@ -636,14 +889,15 @@ namespace TrenchBroom {
          */
         template <typename O>
         void findIntersectors(const vm::ray<T,S>& ray, O out) const {
-            if (!empty()) {
+            if (!m_flatNodes.empty()) {
+                findInFlatNodes([&](const Box& bounds) { return intersects(ray, bounds); }, out);
+            } else if (!empty()) {
                 LambdaVisitor visitor(
                     [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(ray.origin) || !vm::is_nan(
-                            vm::intersect_ray_bbox(ray, innerNode->bounds()));
+                        return intersects(ray, innerNode->bounds());
                     },
                     [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, leaf->bounds()))) {
+                        if (intersects(ray, leaf->bounds())) {
                             out = leaf->data();
                             ++out;
                         }
@@ -675,7 +929,9 @@ namespace TrenchBroom {
          */
         template <typename O>
         void findContainers(const vm::vec<T,S>& point, O out) const {
-            if (!empty()) {
+            if (!m_flatNodes.empty()) {
+                findInFlatNodes([&](const Box& bounds) { return bounds.contains(point); }, out);
+            } else if (!empty()) {
                 LambdaVisitor visitor(
                     [&](const InnerNode* innerNode) {
                         return innerNode->bounds().contains(point);
@@ -691,6 +947,69 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Indicates whether the given box is entirely in front of the given plane, i.e., on the side that the plane's
+         * normal points to.
+         */
+        static bool isInFrontOf(const Box& bounds, const vm::plane<T,S>& plane) {
+            // the distance of the box corner that is farthest behind the plane
+            auto minDistance = -plane.distance;
+            for (size_t i = 0; i < S; ++i) {
+                minDistance += plane.normal[i] * (plane.normal[i] >= T(0) ? bounds.min[i] : bounds.max[i]);
+            }
+            return minDistance > T(0);
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects the frustum bounded by the given planes and
+         * returns a list of those items.
+         *
+         * @param frustumPlanes the planes that bound the frustum, their normals must point out of the frustum
+         * @return a list containing all found data items
+         */
+        List findInFrustum(const std::vector<vm::plane<T,S>>& frustumPlanes) const {
+            List result;
+            findInFrustum(frustumPlanes, std::back_inserter(result));
+            return result;
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects the frustum bounded by the given planes and
+         * appends it to the given output iterator.
+         *
+         * A bounding box is only rejected if it is entirely in front of one of the planes. Therefore, some items whose
+         * bounding boxes are close to the corners of the frustum are found even though they don't intersect it.
+         *
+         * @tparam O the output iterator type
+         * @param frustumPlanes the planes that bound the frustum, their normals must point out of the frustum
+         * @param out the output iterator to append to
+         */
+        template <typename O>
+        void findInFrustum(const std::vector<vm::plane<T,S>>& frustumPlanes, O out) const {
+            const auto intersectsFrustum = [&](const Box& bounds) {
+                return std::none_of(std::begin(frustumPlanes), std::end(frustumPlanes), [&](const auto& plane) {
+                    return isInFrontOf(bounds, plane);
+                });
+            };
+
+            if (!m_flatNodes.empty()) {
+                findInFlatNodes(intersectsFrustum, out);
+            } else if (!empty()) {
+                LambdaVisitor visitor(
+                    [&](const InnerNode* innerNode) {
+                        return intersectsFrustum(innerNode->bounds());
+                    },
+                    [&](const LeafNode* leaf) {
+                        if (intersectsFrustum(leaf->bounds())) {
+                            out = leaf->data();
+                            ++out;
+                        }
+                    }
+                );
+                m_root->accept(visitor);
+            }
+        }
+
         /**
          * Prints a textual representation of this tree to the given output stream.
          *
@@ -28,6 +28,10 @@
 #include "Model/EntityNode.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 
+#include <kdl/vector_utils.h>
+
+#include <utility>
+
 namespace TrenchBroom {
     namespace Assets {
         EntityModelManager::EntityModelManager(const int magFilter, const int minFilter, Logger& logger) :
@@ -42,6 +46,8 @@ namespace TrenchBroom {
         }
 
         void EntityModelManager::clear() {
+            waitForPendingModels();
+
             m_renderers.clear();
             m_models.clear();
             m_rendererMismatches.clear();
@@ -49,6 +55,7 @@ namespace TrenchBroom {
 
             m_unpreparedModels.clear();
             m_unpreparedRenderers.clear();
+            m_loadedModelPaths.clear();
 
             // Remove logging because it might fail when the document is already destroyed.
         }
@@ -65,7 +72,7 @@ namespace TrenchBroom {
         }
 
         Renderer::TexturedRenderer* EntityModelManager::renderer(const Assets::ModelSpecification& spec) const {
-            auto* entityModel = safeGetModel(spec.path);
+            auto* entityModel = model(spec.path, spec.frameIndex);
 
             if (entityModel == nullptr) {
                 return nullptr;
@@ -97,24 +104,41 @@ namespace TrenchBroom {
         }
 
         const EntityModelFrame* EntityModelManager::frame(const Assets::ModelSpecification& spec) const {
-            auto* model = this->safeGetModel(spec.path);
+            auto* model = this->model(spec.path, spec.frameIndex);
             if (model == nullptr) {
                 return nullptr;
             } else if (spec.frameIndex >= model->frameCount()) {
                 return nullptr;
             } else {
                 if (!model->frame(spec.frameIndex)->loaded()) {
+                    // the model is shared with the main thread now, so the frame must be loaded here
                     loadFrame(spec, *model);
                 }
                 return model->frame(spec.frameIndex);
             }
         }
 
-        EntityModel* EntityModelManager::model(const IO::Path& path) const {
+        bool EntityModelManager::hasPendingModels() const {
+            const auto lock = std::lock_guard<std::mutex>{m_pendingMutex};
+            return !m_pendingModels.empty() || !m_finishedModels.empty();
+        }
+
+        std::vector<IO::Path> EntityModelManager::takeLoadedModelPaths() {
+            collectLoadedModels();
+            return std::exchange(m_loadedModelPaths, {});
+        }
+
+        /**
+         * Returns the model at the given path if it is loaded. Otherwise, starts loading the model along with the
+         * given frame on a worker thread unless that is already in progress, and returns null.
+         */
+        EntityModel* EntityModelManager::model(const IO::Path& path, const size_t frameIndex) const {
             if (path.isEmpty()) {
                 return nullptr;
             }
 
+            collectLoadedModels();
+
             auto it = m_models.find(path);
             if (it != std::end(m_models)) {
                 return it->second.get();
@@ -124,34 +148,59 @@ namespace TrenchBroom {
                 return nullptr;
             }
 
-            try {
-                const auto [pos, success] = m_models.insert({ path, loadModel(path) });
-                assert(success); unused(success);
-
-                auto* model = pos->second.get();
-                m_unpreparedModels.push_back(model);
+            loadModel(path, frameIndex);
+            return nullptr;
+        }
 
-                m_logger.debug() << "Loaded entity model " << path;
+        void EntityModelManager::loadModel(const IO::Path& path, const size_t frameIndex) const {
+            ensure(m_loader != nullptr, "loader is null");
 
-                return model;
-            } catch (const GameException& e) {
-                m_logger.error() << e.what();
-                m_modelMismatches.insert(path);
-                throw;
+            {
+                const auto lock = std::lock_guard<std::mutex>{m_pendingMutex};
+                const auto [it, inserted] = m_pendingModels.try_emplace(path);
+                if (!kdl::vec_contains(it->second, frameIndex)) {
+                    it->second.push_back(frameIndex);
+                }
+                if (!inserted) {
+                    // the worker will pick up the requested frame
+                    return;
+                }
             }
-        }
 
-        EntityModel* EntityModelManager::safeGetModel(const IO::Path& path) const {
-            try {
-                return model(path);
-            } catch (const GameException&) {
-                return nullptr;
-            }
-        }
+            m_loadTasks.run([this, loader = m_loader, path]() {
+                auto model = std::unique_ptr<EntityModel>{};
+                try {
+                    model = loader->initializeModel(path, m_workerLogger);
+                    m_workerLogger.debug() << "Loaded entity model " << path;
+                } catch (const Exception& e) {
+                    m_workerLogger.error() << e.what();
+                }
 
-        std::unique_ptr<EntityModel> EntityModelManager::loadModel(const IO::Path& path) const {
-            ensure(m_loader != nullptr, "loader is null");
-            return m_loader->initializeModel(path, m_logger);
+                // load the requested frames, including the frames that are requested while we are loading
+                while (true) {
+                    auto frameIndices = std::vector<size_t>{};
+                    {
+                        const auto lock = std::lock_guard<std::mutex>{m_pendingMutex};
+                        auto& requestedFrames = m_pendingModels[path];
+                        if (model == nullptr || requestedFrames.empty()) {
+                            m_pendingModels.erase(path);
+                            m_finishedModels.emplace_back(path, std::move(model));
+                            return;
+                        }
+                        std::swap(frameIndices, requestedFrames);
+                    }
+
+                    for (const auto index : frameIndices) {
+                        if (index < model->frameCount() && !model->frame(index)->loaded()) {
+                            try {
+                                loader->loadFrame(path, index, *model, m_workerLogger);
+                            } catch (const Exception& e) {
+                                m_workerLogger.error() << "Could not load entity model frame " << index << " of " << path << ": " << e.what();
+                            }
+                        }
+                    }
+                }
+            });
         }
 
         void EntityModelManager::loadFrame(const Assets::ModelSpecification& spec, Assets::EntityModel& model) const {
@@ -164,7 +213,45 @@ namespace TrenchBroom {
             }
         }
 
+        void EntityModelManager::collectLoadedModels() const {
+            auto finishedModels = std::vector<std::tuple<IO::Path, std::unique_ptr<EntityModel>>>{};
+            {
+                const auto lock = std::lock_guard<std::mutex>{m_pendingMutex};
+                if (m_finishedModels.empty()) {
+                    return;
+                }
+                std::swap(finishedModels, m_finishedModels);
+            }
+
+            m_workerLogger.flush(m_logger);
+
+            for (auto& [path, model] : finishedModels) {
+                if (model != nullptr) {
+                    const auto [pos, success] = m_models.insert({ path, std::move(model) });
+                    assert(success); unused(success);
+
+                    m_unpreparedModels.push_back(pos->second.get());
+                    m_loadedModelPaths.push_back(path);
+                } else {
+                    m_modelMismatches.insert(path);
+                }
+            }
+        }
+
+        void EntityModelManager::waitForPendingModels() {
+            m_loadTasks.wait();
+
+            const auto lock = std::lock_guard<std::mutex>{m_pendingMutex};
+            m_pendingModels.clear();
+            m_finishedModels.clear();
+
+            // the messages can't be logged here because the logger might already be gone
+            auto nullLogger = NullLogger{};
+            m_workerLogger.flush(nullLogger);
+        }
+
         void EntityModelManager::prepare(Renderer::VboManager& vboManager) {
+            collectLoadedModels();
             resetTextureMode();
             prepareModels();
             prepareRenderers(vboManager);
@@ -19,12 +19,16 @@
 
 #pragma once
 
+#include "BufferedLogger.h"
 #include "IO/Path.h"
 
+#include <kdl/thread_pool.h>
 #include <kdl/vector_set.h>
 
 #include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
@@ -48,6 +52,14 @@ namespace TrenchBroom {
         class EntityModelFrame;
         struct ModelSpecification;
 
+        /**
+         * Loads entity models on demand and caches them.
+         *
+         * Models are parsed on worker threads. While a model is being loaded, frame() and renderer() return null, so
+         * entities fall back to their definition bounds. The frames that are requested while a model is being loaded
+         * are loaded on the worker thread too. Loaded models are collected on the main thread, and
+         * takeLoadedModelPaths() reports them so that the entities using them can be updated.
+         */
         class EntityModelManager {
         private:
             using ModelCache = std::map<IO::Path, std::unique_ptr<EntityModel>>;
@@ -72,6 +84,18 @@ namespace TrenchBroom {
 
             mutable ModelList m_unpreparedModels;
             mutable RendererList m_unpreparedRenderers;
+
+            // the paths of the models that were collected since the last call to takeLoadedModelPaths
+            mutable std::vector<IO::Path> m_loadedModelPaths;
+
+            mutable std::mutex m_pendingMutex;
+            // guarded by m_pendingMutex: maps the models that are being loaded to the frames requested for them
+            mutable std::map<IO::Path, std::vector<size_t>> m_pendingModels;
+            // guarded by m_pendingMutex: the models that were loaded but not collected yet, null if loading failed
+            mutable std::vector<std::tuple<IO::Path, std::unique_ptr<EntityModel>>> m_finishedModels;
+            // collects the messages of the worker threads until the loaded models are collected
+            mutable BufferedLogger m_workerLogger;
+            mutable kdl::task_group m_loadTasks;
         public:
             EntityModelManager(int magFilter, int minFilter, Logger& logger);
             ~EntityModelManager();
@@ -83,11 +107,22 @@ namespace TrenchBroom {
             Renderer::TexturedRenderer* renderer(const ModelSpecification& spec) const;
 
             const EntityModelFrame* frame(const ModelSpecification& spec) const;
+
+            /**
+             * Indicates whether any models are being loaded or wait to be collected.
+             */
+            bool hasPendingModels() const;
+
+            /**
+             * Returns the paths of the models that became available since the last call and forgets them.
+             */
+            std::vector<IO::Path> takeLoadedModelPaths();
         private:
-            EntityModel* model(const IO::Path& path) const;
-            EntityModel* safeGetModel(const IO::Path& path) const;
-            std::unique_ptr<EntityModel> loadModel(const IO::Path& path) const;
+            EntityModel* model(const IO::Path& path, size_t frameIndex) const;
+            void loadModel(const IO::Path& path, size_t frameIndex) const;
             void loadFrame(const ModelSpecification& spec, EntityModel& model) const;
+            void collectLoadedModels() const;
+            void waitForPendingModels();
         public:
             void prepare(Renderer::VboManager& vboManager);
         private:
@@ -29,6 +29,8 @@
 
 #include <kdl/string_format.h>
 
+#include <array>
+#include <cstdint>
 #include <cstring>
 #include <string>
 
@@ -36,37 +38,41 @@ namespace TrenchBroom {
     namespace Assets {
         struct PaletteData {
             /**
-             * 1024 bytes, RGBA order.
+             * 256 colors, each packed into a 32 bit word whose bytes are in RGBA order.
              */
-            std::vector<unsigned char> opaqueData;
+            std::array<uint32_t, 256> opaqueColors;
             /**
-             * 1024 bytes, RGBA order.
+             * 256 colors, each packed into a 32 bit word whose bytes are in RGBA order.
              */
-            std::vector<unsigned char> index255TransparentData;
+            std::array<uint32_t, 256> index255TransparentColors;
+            /**
+             * 768 bytes, RGB order.
+             */
+            std::vector<unsigned char> rgbData;
         };
 
+        static uint32_t packRgba(const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char a) {
+            const unsigned char bytes[] = { r, g, b, a };
+            uint32_t result;
+            std::memcpy(&result, bytes, sizeof(result));
+            return result;
+        }
+
         static std::shared_ptr<PaletteData> makePaletteData(const std::vector<unsigned char>& data) {
             if (data.size() != 768) {
                 throw AssetException("Could not load palette, expected 768 bytes, got " + std::to_string(data.size()));
             }
 
             PaletteData result;
-            result.opaqueData.reserve(1024);
-
             for (size_t i = 0; i < 256; ++i) {
                 const auto r = data[3 * i + 0];
                 const auto g = data[3 * i + 1];
                 const auto b = data[3 * i + 2];
 
-                result.opaqueData.push_back(r);
-                result.opaqueData.push_back(g);
-                result.opaqueData.push_back(b);
-                result.opaqueData.push_back(0xFF);
+                result.opaqueColors[i] = packRgba(r, g, b, 0xFF);
+                result.index255TransparentColors[i] = packRgba(r, g, b, i == 255 ? 0x00 : 0xFF);
             }
-
-            // build index255TransparentData from opaqueData
-            result.index255TransparentData = result.opaqueData;
-            result.index255TransparentData[1023] = 0;
+            result.rgbData = data;
 
             return std::make_shared<PaletteData>(std::move(result));
         }
@@ -129,43 +135,58 @@ namespace TrenchBroom {
             ensure(rgbaImage.size() == 4 * pixelCount, "incorrect destination buffer size");
             ensure(initialized(), "indexedToRgba called on uninitialized palette");
 
-            const unsigned char* paletteData =
+            const auto& colors =
                 (transparency == PaletteTransparency::Opaque)
-                ? m_data->opaqueData.data()
-                : m_data->index255TransparentData.data();
+                ? m_data->opaqueColors
+                : m_data->index255TransparentColors;
 
             const unsigned char* indexedImage = reinterpret_cast<const unsigned char*>(reader.begin() + reader.position());
             reader.seekForward(pixelCount); // throws ReaderException if there aren't pixelCount bytes available
 
-            // Write rgba pixels
+            // Write rgba pixels and count how often each index occurs. The pixels are processed in groups of four
+            // that update separate histograms, so that runs of the same index don't stall on the counter updates.
+            auto histograms = std::array<std::array<uint32_t, 256>, 4>{};
             unsigned char* const rgbaData = rgbaImage.data();
-            for (size_t i = 0; i < pixelCount; ++i) {
-                const int index = static_cast<int>(indexedImage[i]);
 
-                std::memcpy(rgbaData + (i * 4), &paletteData[index * 4], 4);
+            size_t i = 0;
+            for (; i + 4 <= pixelCount; i += 4) {
+                const auto i0 = indexedImage[i + 0];
+                const auto i1 = indexedImage[i + 1];
+                const auto i2 = indexedImage[i + 2];
+                const auto i3 = indexedImage[i + 3];
+
+                const uint32_t pixels[] = { colors[i0], colors[i1], colors[i2], colors[i3] };
+                std::memcpy(rgbaData + (i * 4), pixels, sizeof(pixels));
+
+                ++histograms[0][i0];
+                ++histograms[1][i1];
+                ++histograms[2][i2];
+                ++histograms[3][i3];
+            }
+            for (; i < pixelCount; ++i) {
+                const auto index = indexedImage[i];
+                std::memcpy(rgbaData + (i * 4), &colors[index], 4);
+                ++histograms[0][index];
             }
 
-            // Check average color
-            uint32_t colorSum[3] = {0, 0, 0};
-            for (size_t i = 0; i < pixelCount; ++i) {
-                colorSum[0] += static_cast<uint32_t>(rgbaData[(i * 4) + 0]);
-                colorSum[1] += static_cast<uint32_t>(rgbaData[(i * 4) + 1]);
-                colorSum[2] += static_cast<uint32_t>(rgbaData[(i * 4) + 2]);
+            // The average color is the weighted sum of the palette colors, which is much cheaper than summing the
+            // color of every pixel.
+            uint64_t colorSum[3] = {0, 0, 0};
+            for (size_t index = 0; index < 256; ++index) {
+                const auto count = uint64_t(histograms[0][index]) + histograms[1][index] + histograms[2][index] + histograms[3][index];
+                colorSum[0] += count * m_data->rgbData[3 * index + 0];
+                colorSum[1] += count * m_data->rgbData[3 * index + 1];
+                colorSum[2] += count * m_data->rgbData[3 * index + 2];
             }
             averageColor = Color(static_cast<float>(colorSum[0]) / (255.0f * static_cast<float>(pixelCount)),
                                  static_cast<float>(colorSum[1]) / (255.0f * static_cast<float>(pixelCount)),
                                  static_cast<float>(colorSum[2]) / (255.0f * static_cast<float>(pixelCount)),
                                  1.0f);
 
-            // Check for transparency
+            // Only index 255 is transparent
             bool hasTransparency = false;
             if (transparency == PaletteTransparency::Index255Transparent) {
-                // Take the bitwise AND of the alpha channel of all pixels
-                unsigned char andAlpha = 0xff;
-                for (size_t i = 0; i < pixelCount; ++i) {
-                    andAlpha &= rgbaData[(i * 4) + 3];
-                }
-                hasTransparency = (andAlpha != 0xff);
+                hasTransparency = histograms[0][255] + histograms[1][255] + histograms[2][255] + histograms[3][255] > 0;
             }
 
             return hasTransparency;
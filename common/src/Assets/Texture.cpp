@@ -20,6 +20,7 @@
 #include "Texture.h"
 #include "Assets/TextureBuffer.h"
 #include "Assets/TextureCollection.h"
+#include "Assets/TextureUploadQueue.h"
 #include "Renderer/GL.h"
 
 #include <algorithm> // for std::max
@@ -27,6 +28,19 @@
 
 namespace TrenchBroom {
     namespace Assets {
+        // counts the texture activations, which happen on the main thread only
+        static size_t activationCounter = 0;
+
+        static size_t fullMipLevelCount(size_t width, size_t height) {
+            size_t result = 1;
+            while (width > 1 || height > 1) {
+                width = std::max(size_t(1), width / 2);
+                height = std::max(size_t(1), height / 2);
+                ++result;
+            }
+            return result;
+        }
+
         Texture::Texture(const std::string& name, const size_t width, const size_t height, const Color& averageColor, Buffer&& buffer, const GLenum format, const TextureType type) :
         m_name(name),
         m_width(width),
@@ -38,7 +52,14 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {
+        m_textureId(0),
+        m_hasAverageColor(true),
+        m_uploadQueue(nullptr),
+        m_uploaded(false),
+        m_uploadedSize(0),
+        m_lastActivation(0),
+        m_minFilter(0),
+        m_magFilter(0) {
             assert(m_width > 0);
             assert(m_height > 0);
             assert(buffer.size() >= m_width * m_height * bytesPerPixelForFormat(format));
@@ -57,7 +78,14 @@ namespace TrenchBroom {
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
         m_textureId(0),
-        m_buffers(std::move(buffers)) {
+        m_buffers(std::move(buffers)),
+        m_hasAverageColor(true),
+        m_uploadQueue(nullptr),
+        m_uploaded(false),
+        m_uploadedSize(0),
+        m_lastActivation(0),
+        m_minFilter(0),
+        m_magFilter(0) {
             assert(m_width > 0);
             assert(m_height > 0);
 
@@ -81,9 +109,20 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {}
-
-        Texture::~Texture() = default;
+        m_textureId(0),
+        m_hasAverageColor(true),
+        m_uploadQueue(nullptr),
+        m_uploaded(false),
+        m_uploadedSize(0),
+        m_lastActivation(0),
+        m_minFilter(0),
+        m_magFilter(0) {}
+
+        Texture::~Texture() {
+            if (m_uploadQueue) {
+                m_uploadQueue->remove(*this);
+            }
+        }
 
         TextureType Texture::selectTextureType(const bool masked) {
             if (masked) {
@@ -122,7 +161,9 @@ namespace TrenchBroom {
         }
 
         const Color& Texture::averageColor() const {
-            return m_averageColor;
+            // this is called for every rendered texture, so we must not decode deferred pixel data here
+            static const auto PlaceholderColor = Color(0.5f, 0.5f, 0.5f, 1.0f);
+            return m_hasAverageColor ? m_averageColor : PlaceholderColor;
         }
 
         bool Texture::masked() const {
@@ -180,14 +221,76 @@ namespace TrenchBroom {
             m_overridden = overridden;
         }
 
+        void Texture::deferPixels(TexturePixelLoader pixelLoader) {
+            assert(!isPrepared());
+
+            m_hasAverageColor = !m_buffers.empty();
+            m_buffers.clear();
+            m_pixelLoader = std::move(pixelLoader);
+        }
+
+        bool Texture::hasDeferredPixels() const {
+            return m_pixelLoader != nullptr;
+        }
+
+        TexturePixels Texture::takePixels() {
+            assert(!isPrepared());
+            return TexturePixels{m_averageColor, std::move(m_buffers)};
+        }
+
         bool Texture::isPrepared() const {
             return m_textureId != 0;
         }
 
-        void Texture::prepare(const GLuint textureId, const int minFilter, const int magFilter) {
+        void Texture::prepare(const GLuint textureId, const int minFilter, const int magFilter, TextureUploadQueue* uploadQueue) {
             assert(textureId > 0);
             assert(m_textureId == 0);
 
+            if (!m_buffers.empty() || hasDeferredPixels()) {
+                m_textureId = textureId;
+                m_minFilter = minFilter;
+                m_magFilter = magFilter;
+                m_uploadQueue = uploadQueue;
+
+                // deferred pixel data is uploaded when the texture is activated
+                if (!hasDeferredPixels()) {
+                    if (m_uploadQueue) {
+                        m_uploadQueue->push(*this, std::nullopt);
+                    } else {
+                        uploadPixels();
+                    }
+                }
+            }
+        }
+
+        bool Texture::isResident() const {
+            return m_uploaded;
+        }
+
+        std::optional<TextureUploadPriority> Texture::uploadRequest() const {
+            return m_uploadRequest;
+        }
+
+        size_t Texture::upload() const {
+            assert(isPrepared());
+
+            if (!m_uploaded) {
+                uploadPixels();
+                glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+            }
+            return m_uploadedSize;
+        }
+
+        void Texture::uploadPixels() const {
+            if (m_buffers.empty() && hasDeferredPixels()) {
+                auto pixels = m_pixelLoader();
+                m_buffers = std::move(pixels.buffers);
+                if (!m_hasAverageColor) {
+                    m_averageColor = pixels.averageColor;
+                    m_hasAverageColor = true;
+                }
+            }
+
             if (!m_buffers.empty()) {
                 glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
                 glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
@@ -196,9 +299,9 @@ namespace TrenchBroom {
                 glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
                 glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
 
-                glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
+                glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_minFilter));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_magFilter));
                 glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
                 glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
 
@@ -217,6 +320,7 @@ namespace TrenchBroom {
                 // Upload only the first mipmap for masked textures.
                 const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
 
+                auto uploadedSize = size_t(0);
                 for (size_t j = 0; j < mipmapsToUpload; ++j) {
                     const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
 
@@ -225,15 +329,23 @@ namespace TrenchBroom {
                                           static_cast<GLsizei>(mipSize.x()),
                                           static_cast<GLsizei>(mipSize.y()),
                                           0, m_format, GL_UNSIGNED_BYTE, data));
+                    uploadedSize += 4u * mipSize.x() * mipSize.y();
                 }
 
+                // generated mipmaps take another third of the memory of the first mipmap
+                m_uploadedSize = m_type != TextureType::Masked && m_buffers.size() == 1 ? uploadedSize * 4u / 3u : uploadedSize;
                 m_buffers.clear();
-                m_textureId = textureId;
             }
+
+            m_uploaded = true;
+            m_uploadRequest = std::nullopt;
         }
 
         void Texture::setMode(const int minFilter, const int magFilter) {
-            if (isPrepared()) {
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
+
+            if (isPrepared() && m_uploaded) {
                 activate();
                 if (m_type == TextureType::Masked) {
                     // Force GL_NEAREST filtering for masked textures.
@@ -247,8 +359,20 @@ namespace TrenchBroom {
             }
         }
 
-        void Texture::activate() const {
+        bool Texture::activate(const TextureUploadPriority priority) const {
             if (isPrepared()) {
+                m_lastActivation = ++activationCounter;
+                if (!m_uploaded) {
+                    if (m_uploadQueue) {
+                        if (!m_uploadRequest || priority < *m_uploadRequest) {
+                            m_uploadRequest = priority;
+                            m_uploadQueue->push(*this, priority);
+                        }
+                    } else {
+                        uploadPixels();
+                    }
+                }
+
                 glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
 
                 switch (m_culling) {
@@ -277,6 +401,7 @@ namespace TrenchBroom {
                     }
                 }
             }
+            return m_uploaded;
         }
 
         void Texture::deactivate() const {
@@ -304,6 +429,33 @@ namespace TrenchBroom {
             }
         }
 
+        size_t Texture::evictableSize() const {
+            return hasDeferredPixels() ? m_uploadedSize : 0u;
+        }
+
+        size_t Texture::lastActivation() const {
+            return m_lastActivation;
+        }
+
+        void Texture::evict() {
+            if (hasDeferredPixels() && m_uploaded) {
+                // replace all mipmaps by empty images to release their memory
+                glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
+                for (size_t j = 0; j < fullMipLevelCount(m_width, m_height); ++j) {
+                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA, 0, 0, 0, m_format, GL_UNSIGNED_BYTE, nullptr));
+                }
+                glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+
+                m_uploaded = false;
+                m_uploadedSize = 0;
+            }
+        }
+
+        size_t Texture::activationCount() {
+            return activationCounter;
+        }
+
         const Texture::BufferList& Texture::buffersIfUnprepared() const {
             return m_buffers;
         }
@@ -26,6 +26,8 @@
 
 #include <vecmath/forward.h>
 
+#include <functional>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -33,6 +35,7 @@
 namespace TrenchBroom {
     namespace Assets {
         class TextureCollection;
+        class TextureUploadQueue;
 
         enum class TextureType {
             Opaque,
@@ -71,6 +74,31 @@ namespace TrenchBroom {
             GLenum destFactor;
         };
 
+        /**
+         * The decoded pixel data of a texture. The buffers are empty if the pixel data could not be decoded.
+         */
+        struct TexturePixels {
+            Color averageColor;
+            TextureBufferList buffers;
+        };
+
+        /**
+         * Decodes the pixel data of a texture when it is needed. The buffers must match the dimensions and the format
+         * of the texture.
+         */
+        using TexturePixelLoader = std::function<TexturePixels()>;
+
+        /**
+         * The urgency with which a texture whose upload is scheduled is uploaded when it is activated, see
+         * Texture::activate.
+         */
+        enum class TextureUploadPriority {
+            // the texture is applied to visible faces
+            Visible = 0,
+            // the texture is shown in the texture browser
+            Browser = 1
+        };
+
         class Texture {
         private:
             using Buffer = TextureBuffer;
@@ -82,7 +110,7 @@ namespace TrenchBroom {
 
             size_t m_width;
             size_t m_height;
-            Color m_averageColor;
+            mutable Color m_averageColor;
 
             size_t m_usageCount;
             bool m_overridden;
@@ -101,6 +129,17 @@ namespace TrenchBroom {
 
             mutable GLuint m_textureId;
             mutable BufferList m_buffers;
+
+            // set if the pixel data is decoded on demand, see deferPixels
+            TexturePixelLoader m_pixelLoader;
+            mutable bool m_hasAverageColor;
+            TextureUploadQueue* m_uploadQueue;
+            mutable bool m_uploaded;
+            mutable size_t m_uploadedSize;
+            mutable std::optional<TextureUploadPriority> m_uploadRequest;
+            mutable size_t m_lastActivation;
+            int m_minFilter;
+            int m_magFilter;
         public:
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, Buffer&& buffer, GLenum format, TextureType type);
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, BufferList&& buffers, GLenum format, TextureType type);
@@ -136,6 +175,11 @@ namespace TrenchBroom {
 
             size_t width() const;
             size_t height() const;
+
+            /**
+             * Returns the average color of this texture's pixels, or a neutral placeholder color if it is not known
+             * yet because the pixel data is decoded on demand and was not decoded yet. Never decodes the pixel data.
+             */
             const Color& averageColor() const;
 
             bool masked() const;
@@ -156,12 +200,88 @@ namespace TrenchBroom {
             bool overridden() const;
             void setOverridden(bool overridden);
 
+            /**
+             * Discards the pixel data of this texture. The given loader decodes it again when the texture is activated
+             * for the first time after it was prepared or evicted.
+             *
+             * If the texture was created without pixel data, its average color is unknown until the pixel data is
+             * decoded for uploading the texture, see averageColor().
+             */
+            void deferPixels(TexturePixelLoader pixelLoader);
+            bool hasDeferredPixels() const;
+
+            /**
+             * Moves the pixel data of this texture out of it. The texture must not be prepared.
+             */
+            TexturePixels takePixels();
+
             bool isPrepared() const;
-            void prepare(GLuint textureId, int minFilter, int magFilter);
+
+            /**
+             * Assigns the given texture ID to this texture. The pixel data is uploaded immediately unless it is decoded
+             * on demand or an upload queue is given. Otherwise, the pixel data is uploaded when the texture is
+             * activated, or, if an upload queue is given, the texture is added to it when it is activated or, if its
+             * pixel data is in memory, right away, and its pixel data is uploaded when upload() is called.
+             *
+             * The texture removes itself from the given queue when it is destroyed, and it must not be moved once it
+             * is prepared.
+             */
+            void prepare(GLuint textureId, int minFilter, int magFilter, TextureUploadQueue* uploadQueue = nullptr);
             void setMode(int minFilter, int magFilter);
 
-            void activate() const;
+            /**
+             * Indicates whether the pixel data of this texture is in video memory.
+             */
+            bool isResident() const;
+
+            /**
+             * Returns the highest priority with which this texture was activated since it was prepared or evicted if
+             * its upload is scheduled and it is not resident, and an empty optional otherwise.
+             */
+            std::optional<TextureUploadPriority> uploadRequest() const;
+
+            /**
+             * Uploads the pixel data of this texture, decoding it first if necessary. The texture must be prepared.
+             *
+             * @return the number of bytes of video memory occupied by the uploaded pixel data
+             */
+            size_t upload() const;
+
+            /**
+             * Binds this texture and applies its culling and blend settings.
+             *
+             * If the upload of this texture is scheduled and it is not resident yet, its upload is requested with the
+             * given priority instead.
+             *
+             * @return true if the texture's pixel data can be used for rendering and false otherwise, in which case
+             * the caller should use the average color
+             */
+            bool activate(TextureUploadPriority priority = TextureUploadPriority::Visible) const;
             void deactivate() const;
+
+            /**
+             * Returns the number of bytes of video memory that the pixel data of this texture occupies if it was
+             * decoded on demand and is currently uploaded, and 0 otherwise.
+             */
+            size_t evictableSize() const;
+
+            /**
+             * Returns the value of activationCount() when this texture was activated last.
+             */
+            size_t lastActivation() const;
+
+            /**
+             * Releases the video memory occupied by the pixel data of this texture if it was decoded on demand. The
+             * pixel data is decoded and uploaded again when the texture is activated the next time.
+             */
+            void evict();
+
+            /**
+             * Returns the number of texture activations so far. Used to determine the least recently used textures.
+             */
+            static size_t activationCount();
+        private:
+            void uploadPixels() const;
         public: // exposed for tests only
             /**
              * Returns the texture data in the format returned by format().
@@ -19,13 +19,20 @@
 
 #include "TextureBuffer.h"
 
+#include "Color.h"
 #include "Ensure.h"
 
+#include <kdl/parallel.h>
+
 #include <vecmath/vec.h>
 
 #include <FreeImage.h>
 
 #include <algorithm> // for std::max
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -111,5 +118,133 @@ namespace TrenchBroom {
                 FreeImage_Unload(newBitmap);
             }
         }
+    
+        size_t mipLevelCount(size_t width, size_t height) {
+            assert(width > 0);
+            assert(height > 0);
+
+            auto result = size_t(1);
+            while (width > 1 || height > 1) {
+                width = std::max(size_t(1), width >> 1);
+                height = std::max(size_t(1), height >> 1);
+                ++result;
+            }
+            return result;
+        }
+
+        namespace {
+            /**
+             * Lookup tables to convert 8 bit sRGB values to 16 bit linear values and back.
+             */
+            struct SrgbTables {
+                std::array<uint16_t, 256> toLinear;
+                std::vector<uint8_t> fromLinear;
+
+                SrgbTables() :
+                fromLinear(65536u) {
+                    for (size_t i = 0; i < toLinear.size(); ++i) {
+                        const auto c = static_cast<double>(i) / 255.0;
+                        const auto l = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+                        toLinear[i] = static_cast<uint16_t>(std::round(l * 65535.0));
+                    }
+                    for (size_t i = 0; i < fromLinear.size(); ++i) {
+                        const auto l = static_cast<double>(i) / 65535.0;
+                        const auto c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+                        fromLinear[i] = static_cast<uint8_t>(std::round(std::clamp(c, 0.0, 1.0) * 255.0));
+                    }
+                }
+            };
+
+            const SrgbTables& srgbTables() {
+                static const auto tables = SrgbTables{};
+                return tables;
+            }
+
+            /**
+             * Computes the given row of a mip level from the previous level. The fourth channel, if any, is alpha.
+             */
+            template <size_t BytesPerPixel>
+            void downsampleRow(const SrgbTables& tables, const unsigned char* src, const size_t srcWidth, const size_t srcHeight, unsigned char* dst, const size_t dstWidth, const size_t y) {
+                const auto srcPitch = srcWidth * BytesPerPixel;
+                const auto* srcRow0 = src + std::min(2u * y, srcHeight - 1u) * srcPitch;
+                const auto* srcRow1 = src + std::min(2u * y + 1u, srcHeight - 1u) * srcPitch;
+                auto* dstRow = dst + y * dstWidth * BytesPerPixel;
+
+                for (size_t x = 0; x < dstWidth; ++x) {
+                    const auto* p0 = srcRow0 + std::min(2u * x, srcWidth - 1u) * BytesPerPixel;
+                    const auto* p1 = srcRow0 + std::min(2u * x + 1u, srcWidth - 1u) * BytesPerPixel;
+                    const auto* p2 = srcRow1 + std::min(2u * x, srcWidth - 1u) * BytesPerPixel;
+                    const auto* p3 = srcRow1 + std::min(2u * x + 1u, srcWidth - 1u) * BytesPerPixel;
+                    auto* q = dstRow + x * BytesPerPixel;
+
+                    for (size_t c = 0; c < 3; ++c) {
+                        const auto sum = uint32_t(tables.toLinear[p0[c]]) + tables.toLinear[p1[c]] + tables.toLinear[p2[c]] + tables.toLinear[p3[c]];
+                        q[c] = tables.fromLinear[(sum + 2u) >> 2];
+                    }
+                    if constexpr (BytesPerPixel == 4) {
+                        q[3] = static_cast<unsigned char>((uint32_t(p0[3]) + p1[3] + p2[3] + p3[3] + 2u) >> 2);
+                    }
+                }
+            }
+
+            template <size_t BytesPerPixel>
+            void generateMipBuffers(TextureBufferList& buffers, const size_t width, const size_t height) {
+                const auto& tables = srgbTables();
+
+                for (size_t level = 1; level < buffers.size(); ++level) {
+                    const auto srcSize = sizeAtMipLevel(width, height, level - 1);
+                    const auto dstSize = sizeAtMipLevel(width, height, level);
+                    const auto* src = buffers[level - 1].data();
+                    auto* dst = buffers[level].data();
+
+                    // small levels are not worth distributing
+                    const auto grainSize = std::max(size_t(1), size_t(16384) / dstSize.x());
+                    kdl::parallel_for(dstSize.y(), [&](const size_t y) {
+                        downsampleRow<BytesPerPixel>(tables, src, srcSize.x(), srcSize.y(), dst, dstSize.x(), y);
+                    }, grainSize);
+                }
+            }
+        }
+
+        void generateMipBuffers(TextureBufferList& buffers, const size_t width, const size_t height, const GLenum format) {
+            ensure(!buffers.empty(), "buffers must contain the first mip level");
+
+            auto mip0 = std::move(buffers.front());
+            setMipBufferSize(buffers, mipLevelCount(width, height), width, height, format);
+            ensure(mip0.size() == buffers.front().size(), "first mip level has the expected size");
+            buffers.front() = std::move(mip0);
+
+            if (bytesPerPixelForFormat(format) == 4u) {
+                generateMipBuffers<4u>(buffers, width, height);
+            } else {
+                generateMipBuffers<3u>(buffers, width, height);
+            }
+        }
+
+        Color averageColor(const TextureBuffer& buffer, const GLenum format) {
+            const auto bytesPerPixel = bytesPerPixelForFormat(format);
+            const auto pixelCount = buffer.size() / bytesPerPixel;
+            if (pixelCount == 0) {
+                return Color{};
+            }
+
+            const auto* data = buffer.data();
+            auto sum = std::array<uint64_t, 4>{0, 0, 0, 0};
+            for (size_t i = 0; i < pixelCount; ++i) {
+                const auto* p = data + i * bytesPerPixel;
+                sum[0] += p[0];
+                sum[1] += p[1];
+                sum[2] += p[2];
+                sum[3] += bytesPerPixel == 4u ? p[3] : 0xFF;
+            }
+
+            const auto isBgr = format == GL_BGR || format == GL_BGRA;
+            const auto divisor = 255.0f * static_cast<float>(pixelCount);
+            return Color{
+                static_cast<float>(sum[isBgr ? 2 : 0]) / divisor,
+                static_cast<float>(sum[1]) / divisor,
+                static_cast<float>(sum[isBgr ? 0 : 2]) / divisor,
+                static_cast<float>(sum[3]) / divisor};
+        }
     }
 }
@@ -27,6 +27,8 @@
 #include <vector>
 
 namespace TrenchBroom {
+    class Color;
+
     namespace Assets {
         class TextureBuffer {
         private:
@@ -47,6 +49,27 @@ namespace TrenchBroom {
         size_t bytesPerPixelForFormat(GLenum format);
         void setMipBufferSize(TextureBufferList& buffers, size_t mipLevels, size_t width, size_t height, GLenum format);
 
+        /**
+         * Returns the number of mip levels of a full mip chain for a texture of the given size, i.e., the number of
+         * levels down to and including the 1x1 level.
+         */
+        size_t mipLevelCount(size_t width, size_t height);
+
+        /**
+         * Generates a full mip chain from the first buffer in the given list, which must contain an image of the given
+         * size and format. Any other buffers are replaced.
+         *
+         * Every mip level is computed from the previous level with a 2x2 box filter. The color channels are averaged
+         * in linear space (the images are assumed to be sRGB encoded) and the alpha channel is averaged as is. The
+         * rows of each level are computed in parallel.
+         */
+        void generateMipBuffers(TextureBufferList& buffers, size_t width, size_t height, GLenum format);
+
+        /**
+         * Computes the average color of the given image buffer with the given format.
+         */
+        Color averageColor(const TextureBuffer& buffer, GLenum format);
+
         void resizeMips(TextureBufferList& buffers, const vm::vec2s& oldSize, const vm::vec2s& newSize);
     }
 }
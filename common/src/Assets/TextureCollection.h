@@ -68,7 +68,10 @@ namespace TrenchBroom {
             Texture* textureByName(const std::string& name);
 
             bool prepared() const;
-            void prepare(int minFilter, int magFilter);
+            /**
+             * Prepares the textures of this collection, see Texture::prepare.
+             */
+            void prepare(int minFilter, int magFilter, TextureUploadQueue* uploadQueue = nullptr);
             void setTextureMode(int minFilter, int magFilter);
         };
     }
@@ -26,13 +26,19 @@
 #include "IO/TextureLoader.h"
 
 #include <kdl/map_utils.h>
+#include <kdl/overload.h>
+#include <kdl/result.h>
 #include <kdl/string_format.h>
 #include <kdl/vector_utils.h>
 
 #include <algorithm>
 #include <chrono>
+#include <deque>
 #include <iterator>
+#include <optional>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -56,11 +62,21 @@ namespace TrenchBroom {
             }
         };
 
+        // spread the uploads over several frames so that loading many textures doesn't stall the UI
+        static const size_t DefaultUploadBudgetBytes = 32u * 1024u * 1024u;
+        static const auto DefaultUploadBudgetTime = std::chrono::milliseconds{8};
+
+        // textures that were used within this time span are not evicted since they are probably visible in some view
+        static const auto RecentActivationTime = std::chrono::milliseconds{1000};
+
         TextureManager::TextureManager(int magFilter, int minFilter, Logger& logger) :
         m_logger(logger),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false),
+        m_memoryBudget(0),
+        m_uploadBudgetBytes(DefaultUploadBudgetBytes),
+        m_uploadBudgetTime(DefaultUploadBudgetTime) {}
 
         TextureManager::~TextureManager() = default;
 
@@ -68,31 +84,47 @@ namespace TrenchBroom {
             auto collections = std::move(m_collections);
             clear();
 
+            // keep the collections that are already loaded and load the others concurrently
+            auto keptCollections = std::vector<std::optional<TextureCollection>>{};
+            auto pathsToLoad = std::vector<IO::Path>{};
+            auto isNewPath = std::vector<bool>{};
             for (const auto& path : paths) {
                 const auto it = std::find_if(std::begin(collections), std::end(collections), [&](const auto& c) { return c.path() == path; });
                 if (it == std::end(collections) || !it->loaded()) {
-                    try {
-                        const auto startTime = std::chrono::high_resolution_clock::now();
-                        auto collection = loader.loadTextureCollection(path);
-                        const auto endTime = std::chrono::high_resolution_clock::now();
-
-                        m_logger.info() << "Loaded texture collection '" << path << "' in "
-                                        << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() << "ms";
-                        addTextureCollection(std::move(collection));
-                    } catch (const Exception& e) {
-                        addTextureCollection(Assets::TextureCollection(path));
-                        if (it == std::end(collections)) {
-                            m_logger.error() << "Could not load texture collection '" << path << "': " << e.what();
-                        }
-                    }
+                    keptCollections.push_back(std::nullopt);
+                    pathsToLoad.push_back(path);
+                    isNewPath.push_back(it == std::end(collections));
                 } else {
-                    addTextureCollection(std::move(*it));
+                    keptCollections.push_back(std::move(*it));
                 }
                 if (it != std::end(collections)) {
                     collections.erase(it);
                 }
             }
 
+            auto loadResults = loader.loadTextureCollections(pathsToLoad);
+            size_t loadIndex = 0;
+            for (size_t i = 0; i < paths.size(); ++i) {
+                if (keptCollections[i]) {
+                    addTextureCollection(std::move(*keptCollections[i]));
+                    continue;
+                }
+
+                const auto& path = paths[i];
+                const auto isNew = isNewPath[loadIndex];
+                std::move(loadResults[loadIndex++]).visit(kdl::overload(
+                    [&](TextureCollection&& collection) {
+                        addTextureCollection(std::move(collection));
+                    },
+                    [&](const IO::TextureCollectionLoadError& e) {
+                        addTextureCollection(Assets::TextureCollection(path));
+                        if (isNew) {
+                            m_logger.error() << "Could not load texture collection '" << path << "': " << e.msg;
+                        }
+                    }
+                ));
+            }
+
             updateTextures();
             m_toRemove = kdl::vec_concat(std::move(m_toRemove), std::move(collections));
         }
@@ -120,6 +152,7 @@ namespace TrenchBroom {
 
             m_toPrepare.clear();
             m_texturesByName.clear();
+            m_texturesByInternedName.clear();
             m_textures.clear();
 
             // Remove logging because it might fail when the document is already destroyed.
@@ -131,12 +164,31 @@ namespace TrenchBroom {
             m_resetTextureMode = true;
         }
 
+        void TextureManager::setMemoryBudget(const size_t memoryBudget) {
+            m_memoryBudget = memoryBudget;
+        }
+
+        void TextureManager::setUploadBudget(const size_t maxBytes, const std::chrono::milliseconds maxTime) {
+            m_uploadBudgetBytes = maxBytes;
+            m_uploadBudgetTime = maxTime;
+        }
+
         void TextureManager::commitChanges() {
             resetTextureMode();
             prepare();
+            uploadTextures();
+            evictTextures();
             m_toRemove.clear();
         }
 
+        bool TextureManager::hasPendingUploads() const {
+            return m_uploadQueue.requestedCount() > 0u;
+        }
+
+        const TextureUploadStats& TextureManager::uploadStats() const {
+            return m_uploadStats;
+        }
+
         const Texture* TextureManager::texture(const std::string& name) const {
             auto it = m_texturesByName.find(kdl::str_to_lower(name));
             if (it == std::end(m_texturesByName)) {
@@ -150,6 +202,17 @@ namespace TrenchBroom {
             return const_cast<Texture*>(const_cast<const TextureManager*>(this)->texture(name));
         }
 
+        Texture* TextureManager::cachedTexture(const kdl::interned_string& name) {
+            const auto it = m_texturesByInternedName.find(name);
+            if (it != std::end(m_texturesByInternedName)) {
+                return it->second;
+            }
+
+            auto* texture = this->texture(name.str());
+            m_texturesByInternedName.emplace(name, texture);
+            return texture;
+        }
+
         const std::vector<const Texture*>& TextureManager::textures() const {
             return m_textures;
         }
@@ -170,13 +233,68 @@ namespace TrenchBroom {
         void TextureManager::prepare() {
             for (const size_t index : m_toPrepare) {
                 auto& collection = m_collections[index];
-                collection.prepare(m_minFilter, m_magFilter);
+                collection.prepare(m_minFilter, m_magFilter, &m_uploadQueue);
             }
             m_toPrepare.clear();
         }
 
+        void TextureManager::uploadTextures() {
+            const auto totalUploadedBytes = m_uploadStats.totalUploadedBytes;
+            m_uploadStats = m_uploadQueue.upload(m_uploadBudgetBytes, m_uploadBudgetTime, [](const Texture& texture) {
+                return texture.upload();
+            });
+            m_uploadStats.totalUploadedBytes = totalUploadedBytes + m_uploadStats.uploadedBytes;
+        }
+
+        void TextureManager::evictTextures() {
+            // every view commits the changes once per frame, so we must not only protect the textures that were
+            // activated since the last commit; instead we protect all textures activated since the last commit that
+            // lies at least RecentActivationTime in the past
+            const auto now = std::chrono::steady_clock::now();
+            m_commitActivations.emplace_back(now, Texture::activationCount());
+            while (m_commitActivations.size() > 1u && now - std::get<0>(m_commitActivations[1]) >= RecentActivationTime) {
+                m_commitActivations.pop_front();
+            }
+
+            if (m_memoryBudget == 0) {
+                return;
+            }
+
+            const auto& [oldestCommitTime, oldestCommitActivation] = m_commitActivations.front();
+            if (now - oldestCommitTime < RecentActivationTime) {
+                // all textures were used recently
+                return;
+            }
+
+            auto evictableSize = size_t(0);
+            auto evictableTextures = std::vector<Texture*>{};
+            for (auto& collection : m_collections) {
+                for (auto& texture : collection.textures()) {
+                    if (texture.evictableSize() > 0) {
+                        evictableSize += texture.evictableSize();
+                        evictableTextures.push_back(&texture);
+                    }
+                }
+            }
+
+            if (evictableSize > m_memoryBudget) {
+                std::sort(std::begin(evictableTextures), std::end(evictableTextures), [](const auto* lhs, const auto* rhs) {
+                    return lhs->lastActivation() < rhs->lastActivation();
+                });
+
+                for (auto* texture : evictableTextures) {
+                    if (evictableSize <= m_memoryBudget || texture->lastActivation() > oldestCommitActivation) {
+                        break;
+                    }
+                    evictableSize -= texture->evictableSize();
+                    texture->evict();
+                }
+            }
+        }
+
         void TextureManager::updateTextures() {
             m_texturesByName.clear();
+            m_texturesByInternedName.clear();
             m_textures.clear();
 
             for (auto& collection : m_collections) {
@@ -20,9 +20,16 @@
 #pragma once
 
 #include "Assets/TextureCollection.h"
+#include "Assets/TextureUploadQueue.h"
 
+#include <kdl/interned_string.h>
+
+#include <chrono>
+#include <deque>
 #include <map>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -40,20 +47,33 @@ namespace TrenchBroom {
         class TextureManager {
         private:
             using TextureMap = std::map<std::string, Texture*>;
+            using InternedTextureMap = std::unordered_map<kdl::interned_string, Texture*>;
 
             Logger& m_logger;
 
+            // must outlive the textures, which remove themselves from it when they are destroyed
+            TextureUploadQueue m_uploadQueue;
+
             std::vector<TextureCollection> m_collections;
 
             std::vector<size_t> m_toPrepare;
             std::vector<TextureCollection> m_toRemove;
 
             TextureMap m_texturesByName;
+            InternedTextureMap m_texturesByInternedName;
             std::vector<const Texture*> m_textures;
 
             int m_minFilter;
             int m_magFilter;
             bool m_resetTextureMode;
+
+            size_t m_memoryBudget;
+            // the time and the activation count of the recent commits, see evictTextures()
+            std::deque<std::tuple<std::chrono::steady_clock::time_point, size_t>> m_commitActivations;
+
+            size_t m_uploadBudgetBytes;
+            std::chrono::milliseconds m_uploadBudgetTime;
+            TextureUploadStats m_uploadStats;
         public:
             TextureManager(int magFilter, int minFilter, Logger& logger);
             ~TextureManager();
@@ -66,16 +86,55 @@ namespace TrenchBroom {
             void clear();
 
             void setTextureMode(int minFilter, int magFilter);
+
+            /**
+             * Sets the number of bytes of video memory that textures whose pixel data is decoded on demand may occupy.
+             * If they exceed the budget, the least recently used textures are evicted when changes are committed.
+             * Textures that were used within the last second are never evicted because changes are committed once per
+             * view and frame, so these textures are probably visible in some view. A budget of 0 means no limit.
+             */
+            void setMemoryBudget(size_t memoryBudget);
+
+            /**
+             * Limits the number of bytes and the time spent for uploading textures per commit. At least one texture is
+             * uploaded per commit if any are waiting. A limit of 0 means no limit.
+             */
+            void setUploadBudget(size_t maxBytes, std::chrono::milliseconds maxTime);
+
+            /**
+             * Prepares the added texture collections and uploads the pixel data of their textures within the upload
+             * budget. Textures that were requested for visible faces are uploaded first, followed by the textures
+             * requested by the texture browser and then by any other textures whose pixel data is in memory. Textures
+             * that are decoded on demand are only uploaded when requested.
+             *
+             * Until a texture is uploaded, it is rendered using its average color.
+             */
             void commitChanges();
 
+            /**
+             * Indicates whether any textures were requested for rendering but are not uploaded yet. In that case,
+             * another commit is necessary to render them.
+             */
+            bool hasPendingUploads() const;
+            const TextureUploadStats& uploadStats() const;
+
             const Texture* texture(const std::string& name) const;
             Texture* texture(const std::string& name);
-            
+
+            /**
+             * Finds the texture with the given name like texture(), but caches the result by the identity of the
+             * interned name. Repeated lookups of the same name, such as for the faces of a map, then only cost a
+             * pointer hash lookup.
+             */
+            Texture* cachedTexture(const kdl::interned_string& name);
+
             const std::vector<const Texture*>& textures() const;
             const std::vector<TextureCollection>& collections() const;
         private:
             void resetTextureMode();
             void prepare();
+            void uploadTextures();
+            void evictTextures();
 
             void updateTextures();
         };
@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureUploadQueue.h"
+
+#include "Assets/Texture.h"
+
+#include <cassert>
+#include <chrono>
+#include <optional>
+
+namespace TrenchBroom {
+    namespace Assets {
+        TextureUploadQueue::TextureUploadQueue() :
+        m_counts{} {}
+
+        void TextureUploadQueue::push(const Texture& texture, const std::optional<TextureUploadPriority> priority) {
+            const auto newRank = rank(priority);
+            const auto [it, inserted] = m_ranks.emplace(&texture, newRank);
+            if (!inserted) {
+                if (newRank >= it->second) {
+                    return;
+                }
+                // the entry at the old rank becomes stale
+                --m_counts[it->second];
+                it->second = newRank;
+            }
+
+            m_entries[newRank].push_back(&texture);
+            ++m_counts[newRank];
+        }
+
+        void TextureUploadQueue::remove(const Texture& texture) {
+            const auto it = m_ranks.find(&texture);
+            if (it != std::end(m_ranks)) {
+                --m_counts[it->second];
+                m_ranks.erase(it);
+            }
+        }
+
+        size_t TextureUploadQueue::size() const {
+            return m_ranks.size();
+        }
+
+        size_t TextureUploadQueue::requestedCount() const {
+            return size() - m_counts[RankCount - 1u];
+        }
+
+        TextureUploadStats TextureUploadQueue::upload(const size_t maxBytes, const std::chrono::milliseconds maxTime, const UploadFunction& uploadTexture) {
+            const auto startTime = std::chrono::steady_clock::now();
+            auto stats = TextureUploadStats{};
+
+            for (auto& entries : m_entries) {
+                while (!entries.empty()) {
+                    if (stats.uploadedTextures > 0u) {
+                        const auto elapsed = std::chrono::steady_clock::now() - startTime;
+                        if ((maxBytes > 0u && stats.uploadedBytes >= maxBytes) ||
+                            (maxTime.count() > 0 && elapsed >= maxTime)) {
+                            stats.queuedTextures = size();
+                            stats.requestedTextures = requestedCount();
+                            return stats;
+                        }
+                    }
+
+                    const auto* texture = entries.front();
+                    entries.pop_front();
+
+                    const auto rankIt = m_ranks.find(texture);
+                    if (rankIt == std::end(m_ranks) || &m_entries[rankIt->second] != &entries) {
+                        // stale entry of a texture that was removed or raised to a higher priority
+                        continue;
+                    }
+
+                    --m_counts[rankIt->second];
+                    m_ranks.erase(rankIt);
+
+                    stats.uploadedBytes += uploadTexture(*texture);
+                    ++stats.uploadedTextures;
+                }
+            }
+
+            assert(size() == 0u);
+            return stats;
+        }
+
+        size_t TextureUploadQueue::rank(const std::optional<TextureUploadPriority> priority) {
+            return priority ? static_cast<size_t>(*priority) : RankCount - 1u;
+        }
+    }
+}
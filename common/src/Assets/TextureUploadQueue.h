@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+        enum class TextureUploadPriority;
+
+        /**
+         * Statistics about the texture uploads of a TextureManager.
+         */
+        struct TextureUploadStats {
+            // the number of textures that wait to be uploaded after the last commit
+            size_t queuedTextures = 0;
+            // the number of queued textures that were requested for rendering
+            size_t requestedTextures = 0;
+            // the number of textures and bytes uploaded by the last commit
+            size_t uploadedTextures = 0;
+            size_t uploadedBytes = 0;
+            // the number of bytes uploaded by all commits
+            size_t totalUploadedBytes = 0;
+        };
+
+        /**
+         * Orders the textures that wait to be uploaded. Textures that were requested with a higher priority are
+         * uploaded first, followed by the textures that were not requested at all. Textures of the same priority are
+         * uploaded in the order in which they were added.
+         *
+         * Textures that are raised to a higher priority leave a stale entry behind which is skipped when it is
+         * reached, so that adding and removing textures takes constant time.
+         */
+        class TextureUploadQueue {
+        public:
+            using UploadFunction = std::function<size_t(const Texture&)>;
+        private:
+            // one rank per upload priority and one for textures that were not requested
+            static constexpr size_t RankCount = 3u;
+
+            std::array<std::deque<const Texture*>, RankCount> m_entries;
+            std::unordered_map<const Texture*, size_t> m_ranks;
+            std::array<size_t, RankCount> m_counts;
+        public:
+            TextureUploadQueue();
+
+            /**
+             * Adds the given texture to this queue or raises its priority if it is queued with a lower priority. An
+             * empty priority means that the texture was not requested.
+             */
+            void push(const Texture& texture, std::optional<TextureUploadPriority> priority);
+
+            /**
+             * Removes the given texture from this queue if it is queued.
+             */
+            void remove(const Texture& texture);
+
+            /**
+             * Returns the number of queued textures.
+             */
+            size_t size() const;
+
+            /**
+             * Returns the number of queued textures that were requested with some priority.
+             */
+            size_t requestedCount() const;
+
+            /**
+             * Removes textures from this queue by priority and passes them to the given function, which must upload
+             * them and return the number of uploaded bytes. Stops once the given number of bytes was uploaded or the
+             * given time has passed, but uploads at least one texture if any are queued. A limit of 0 means no limit.
+             *
+             * @return statistics about the uploaded and the remaining textures, except for the total number of
+             * uploaded bytes, which is left at 0
+             */
+            TextureUploadStats upload(size_t maxBytes, std::chrono::milliseconds maxTime, const UploadFunction& uploadTexture);
+        private:
+            static size_t rank(std::optional<TextureUploadPriority> priority);
+        };
+    }
+}
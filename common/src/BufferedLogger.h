@@ -0,0 +1,50 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Logger.h"
+
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+class QString;
+
+namespace TrenchBroom {
+    /**
+     * Collects messages that may be logged from several threads at once and passes them on to another logger when
+     * flushed. This allows worker threads to log to a logger that may only be used on the main thread.
+     */
+    class BufferedLogger : public Logger {
+    private:
+        std::mutex m_mutex;
+        std::vector<std::tuple<LogLevel, std::string>> m_messages;
+    public:
+        /**
+         * Logs the collected messages to the given logger in the order in which they were collected and discards
+         * them.
+         */
+        void flush(Logger& logger);
+    private:
+        void doLog(LogLevel level, const std::string& message) override;
+        void doLog(LogLevel level, const QString& message) override;
+    };
+}
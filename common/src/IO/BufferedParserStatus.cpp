@@ -0,0 +1,57 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BufferedParserStatus.h"
+
+#include "Logger.h"
+
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static Logger& nullLogger() {
+            static auto logger = NullLogger();
+            return logger;
+        }
+
+        // messages are recorded without a prefix, the prefix of the receiving status is prepended when they are logged
+        BufferedParserStatus::BufferedParserStatus() :
+        ParserStatus(nullLogger(), "") {}
+
+        const BufferedParserStatus::Messages& BufferedParserStatus::messages() const {
+            return m_messages;
+        }
+
+        BufferedParserStatus::Messages BufferedParserStatus::takeMessages() {
+            return std::move(m_messages);
+        }
+
+        void BufferedParserStatus::doProgress(const double /* progress */) {}
+
+        void BufferedParserStatus::doLog(const LogLevel level, const std::string& str) {
+            m_messages.emplace_back(level, str);
+        }
+
+        void logMessages(ParserStatus& status, const BufferedParserStatus::Messages& messages) {
+            for (const auto& [level, message] : messages) {
+                status.logFormatted(level, message);
+            }
+        }
+    }
+}
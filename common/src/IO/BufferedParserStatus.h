@@ -0,0 +1,54 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/ParserStatus.h"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Records the logged messages so that they can be passed on to another parser status later, e.g. in a
+         * deterministic order after parsing on worker threads. Progress is ignored.
+         */
+        class BufferedParserStatus : public ParserStatus {
+        public:
+            using Messages = std::vector<std::tuple<LogLevel, std::string>>;
+        private:
+            Messages m_messages;
+        public:
+            BufferedParserStatus();
+
+            const Messages& messages() const;
+            Messages takeMessages();
+        private:
+            void doProgress(double progress) override;
+            void doLog(LogLevel level, const std::string& str) override;
+        };
+
+        /**
+         * Logs the given recorded messages to the given parser status.
+         */
+        void logMessages(ParserStatus& status, const BufferedParserStatus::Messages& messages);
+    }
+}
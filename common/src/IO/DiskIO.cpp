@@ -30,12 +30,21 @@
 #include <fstream>
 #include <string>
 
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 
 namespace TrenchBroom {
     namespace IO {
         namespace Disk {
+            bool operator==(const FileStamp& lhs, const FileStamp& rhs) {
+                return lhs.modificationTime == rhs.modificationTime && lhs.size == rhs.size;
+            }
+
+            bool operator!=(const FileStamp& lhs, const FileStamp& rhs) {
+                return !(lhs == rhs);
+            }
+
             bool doCheckCaseSensitive();
             Path findCaseSensitivePath(const std::vector<Path>& list, const Path& path);
             Path fixCase(const Path& path);
@@ -117,6 +126,15 @@ namespace TrenchBroom {
                 return fileInfo.exists() && fileInfo.isFile();
             }
 
+            std::optional<FileStamp> fileStamp(const Path& path) {
+                const Path fixedPath = fixPath(path);
+                QFileInfo fileInfo = QFileInfo(pathAsQString(fixedPath));
+                if (!fileInfo.exists() || !fileInfo.isFile()) {
+                    return std::nullopt;
+                }
+                return FileStamp{fileInfo.lastModified().toMSecsSinceEpoch(), fileInfo.size()};
+            }
+
             std::vector<Path> getDirectoryContents(const Path& path) {
                 const Path fixedPath = fixPath(path);
                 QDir dir(pathAsQString(fixedPath));
@@ -139,7 +157,12 @@ namespace TrenchBroom {
                     throw FileNotFoundException(fixedPath.asString());
                 }
 
-                return std::make_shared<CFile>(fixedPath);
+                try {
+                    return std::make_shared<MappedFile>(fixedPath);
+                } catch (const FileSystemException&) {
+                    // some file systems don't support memory mapping, fall back to regular file access
+                    return std::make_shared<CFile>(fixedPath);
+                }
             }
 
             std::string readTextFile(const Path& path) {
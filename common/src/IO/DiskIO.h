@@ -21,7 +21,9 @@
 
 #include "IO/Path.h"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace TrenchBroom {
@@ -29,6 +31,17 @@ namespace TrenchBroom {
         class File;
 
         namespace Disk {
+            /**
+             * Identifies a version of a file by its modification time and size.
+             */
+            struct FileStamp {
+                int64_t modificationTime;
+                int64_t size;
+            };
+
+            bool operator==(const FileStamp& lhs, const FileStamp& rhs);
+            bool operator!=(const FileStamp& lhs, const FileStamp& rhs);
+
             bool isCaseSensitive();
 
             Path fixPath(const Path& path);
@@ -36,6 +49,11 @@ namespace TrenchBroom {
             bool directoryExists(const Path& path);
             bool fileExists(const Path& path);
 
+            /**
+             * Returns the stamp of the file at the given path or an empty optional if no such file exists.
+             */
+            std::optional<FileStamp> fileStamp(const Path& path);
+
             std::vector<Path> getDirectoryContents(const Path& path);
             std::shared_ptr<File> openFile(const Path& path);
             std::string readTextFile(const Path& path);
@@ -23,12 +23,21 @@
 #include "Assets/EntityDefinition.h"
 #include "Assets/ModelDefinition.h"
 #include "Assets/PropertyDefinition.h"
+#include "IO/BufferedParserStatus.h"
+#include "IO/DiskIO.h"
 #include "IO/EntityDefinitionClassInfo.h"
 #include "IO/ParserStatus.h"
+#include "IO/Path.h"
 #include "Model/EntityProperties.h"
 
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -343,5 +352,82 @@ namespace TrenchBroom {
             auto classInfos = parseClassInfos(status);
             return createDefinitions(status, std::move(classInfos));
         }
+
+        namespace {
+            struct CachedClassInfos {
+                /** The stamps of the parsed file and the included files, empty if an included file didn't exist. */
+                EntityDefinitionParser::FileStamps files;
+                std::vector<EntityDefinitionClassInfo> classInfos;
+                BufferedParserStatus::Messages messages;
+            };
+
+            class ClassInfoCache {
+            private:
+                std::mutex m_mutex;
+                std::map<Path, std::shared_ptr<const CachedClassInfos>> m_entries;
+            public:
+                std::shared_ptr<const CachedClassInfos> find(const Path& path) {
+                    const auto lock = std::lock_guard<std::mutex>{m_mutex};
+                    const auto it = m_entries.find(path);
+                    return it != std::end(m_entries) ? it->second : nullptr;
+                }
+
+                void insert(const Path& path, std::shared_ptr<const CachedClassInfos> entry) {
+                    const auto lock = std::lock_guard<std::mutex>{m_mutex};
+                    m_entries[path] = std::move(entry);
+                }
+            };
+
+            ClassInfoCache& classInfoCache() {
+                static auto cache = ClassInfoCache{};
+                return cache;
+            }
+
+            bool isUpToDate(const CachedClassInfos& entry) {
+                return std::all_of(std::begin(entry.files), std::end(entry.files), [](const auto& file) {
+                    const auto& [path, stamp] = file;
+                    return Disk::fileStamp(path) == stamp;
+                });
+            }
+        }
+
+        EntityDefinitionParser::EntityDefinitionList EntityDefinitionParser::parseDefinitions(ParserStatus& status, const Path& path) {
+            auto& cache = classInfoCache();
+            if (const auto cached = cache.find(path); cached && isUpToDate(*cached)) {
+                logMessages(status, cached->messages);
+                return createDefinitions(status, cached->classInfos);
+            }
+
+            // take the stamp before parsing so that changes made while parsing invalidate the cached class infos
+            const auto stamp = Disk::fileStamp(path);
+
+            auto bufferedStatus = BufferedParserStatus{};
+            auto classInfos = std::vector<EntityDefinitionClassInfo>{};
+            try {
+                classInfos = parseClassInfos(bufferedStatus);
+            } catch (...) {
+                logMessages(status, bufferedStatus.messages());
+                throw;
+            }
+            logMessages(status, bufferedStatus.messages());
+
+            if (stamp) {
+                auto entry = std::make_shared<CachedClassInfos>();
+                entry->files = kdl::vec_concat(FileStamps{{path, stamp}}, includedFiles());
+                entry->classInfos = classInfos;
+                entry->messages = bufferedStatus.takeMessages();
+                cache.insert(path, std::move(entry));
+            }
+
+            return createDefinitions(status, classInfos);
+        }
+
+        const Color& EntityDefinitionParser::defaultEntityColor() const {
+            return m_defaultEntityColor;
+        }
+
+        EntityDefinitionParser::FileStamps EntityDefinitionParser::includedFiles() const {
+            return {};
+        }
     }
 }
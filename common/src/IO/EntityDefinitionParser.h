@@ -20,9 +20,12 @@
 #pragma once
 
 #include "Color.h"
+#include "IO/DiskIO.h"
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -35,6 +38,7 @@ namespace TrenchBroom {
     namespace IO {
         struct EntityDefinitionClassInfo;
         class ParserStatus;
+        class Path;
 
         // exposed for testing
         std::vector<EntityDefinitionClassInfo> resolveInheritance(ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos);
@@ -47,16 +51,37 @@ namespace TrenchBroom {
             using PropertyDefinitionPtr = std::shared_ptr<Assets::PropertyDefinition>;
             using PropertyDefinitionList = std::vector<PropertyDefinitionPtr>;
             using PropertyDefinitionMap = std::unordered_map<std::string, PropertyDefinitionPtr>;
+            /**
+             * Absolute file paths and the stamps of the files, or empty optionals if the files didn't exist.
+             */
+            using FileStamps = std::vector<std::tuple<Path, std::optional<Disk::FileStamp>>>;
         public:
             EntityDefinitionParser(const Color& defaultEntityColor);
             virtual ~EntityDefinitionParser();
             
             EntityDefinitionList parseDefinitions(ParserStatus& status);
+
+            /**
+             * Parses the definitions from the file at the given path, which must be the file that this parser reads.
+             *
+             * The parsed class infos are cached along with the modification times and sizes of the file and of all
+             * files it includes. If none of these files has changed when the same path is parsed again, the cached
+             * class infos are used and the messages that were logged when they were parsed are logged again.
+             */
+            EntityDefinitionList parseDefinitions(ParserStatus& status, const Path& path);
+        protected:
+            const Color& defaultEntityColor() const;
         private:
             std::unique_ptr<Assets::EntityDefinition> createDefinition(const EntityDefinitionClassInfo& classInfo) const;
             std::vector<Assets::EntityDefinition*> createDefinitions(ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos) const;
  
             virtual std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) = 0;
+
+            /**
+             * Returns the absolute paths of the files that the parsed file included or tried to include, along with
+             * the stamps that the files had before they were read.
+             */
+            virtual FileStamps includedFiles() const;
         };
     }
 }
@@ -19,7 +19,10 @@
 
 #include "FgdParser.h"
 
+#include "Exceptions.h"
 #include "Assets/PropertyDefinition.h"
+#include "IO/BufferedParserStatus.h"
+#include "IO/DiskIO.h"
 #include "IO/EntityDefinitionClassInfo.h"
 #include "IO/File.h"
 #include "IO/DiskFileSystem.h"
@@ -30,10 +33,13 @@
 #include <kdl/string_compare.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
+#include <kdl/thread_pool.h>
 #include <kdl/vector_utils.h>
 
+#include <iterator>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
@@ -132,13 +138,19 @@ namespace TrenchBroom {
         m_tokenizer(FgdTokenizer(std::move(str))) {
             if (!path.isEmpty() && path.isAbsolute()) {
                 m_fs = std::make_shared<DiskFileSystem>(path.deleteLastComponent());
-                pushIncludePath(path.lastComponent());
+                m_paths.push_back(path.lastComponent());
             }
         }
 
         FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor) :
         FgdParser(std::move(str), defaultEntityColor, Path()) {}
 
+        FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor, std::shared_ptr<FileSystem> fs, std::vector<Path> paths) :
+        EntityDefinitionParser(defaultEntityColor),
+        m_paths(std::move(paths)),
+        m_fs(std::move(fs)),
+        m_tokenizer(FgdTokenizer(std::move(str))) {}
+
         FgdParser::TokenNameMap FgdParser::tokenNames() const {
             using namespace FgdToken;
 
@@ -159,30 +171,6 @@ namespace TrenchBroom {
             return names;
         }
 
-        class FgdParser::PushIncludePath {
-        private:
-            FgdParser* m_parser;
-        public:
-            PushIncludePath(FgdParser* parser, const Path& path) :
-                m_parser(parser) {
-                m_parser->pushIncludePath(path);
-            }
-
-            ~PushIncludePath() {
-                m_parser->popIncludePath();
-            }
-        };
-
-        void FgdParser::pushIncludePath(const Path& path) {
-            assert(!isRecursiveInclude(path));
-            m_paths.push_back(path);
-        }
-
-        void FgdParser::popIncludePath() {
-            assert(!m_paths.empty());
-            m_paths.pop_back();
-        }
-
         Path FgdParser::currentRoot() const {
             if (!m_paths.empty()) {
                 assert(!m_paths.back().isEmpty());
@@ -201,31 +189,99 @@ namespace TrenchBroom {
             return false;
         }
 
-        std::vector<EntityDefinitionClassInfo> FgdParser::parseClassInfos(ParserStatus& status) {
+        /**
+         * An included file that is parsed by its own parser, possibly on another thread.
+         */
+        struct FgdParser::IncludedFile {
+            size_t line;
+            std::shared_ptr<File> file;
+            BufferedReader reader;
+            std::unique_ptr<FgdParser> parser;
+            BufferedParserStatus status;
             std::vector<EntityDefinitionClassInfo> classInfos;
-            auto token = m_tokenizer.peekToken();
-            while (!token.hasType(FgdToken::Eof)) {
-                parseClassInfoOrInclude(status, classInfos);
-                token = m_tokenizer.peekToken();
-            }
-            return classInfos;
-        }
 
-        void FgdParser::parseClassInfoOrInclude(ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos) {
-            auto token = expect(status, FgdToken::Eof | FgdToken::Word, m_tokenizer.peekToken());
-            if (token.hasType(FgdToken::Eof)) {
-                return;
+            void parse() {
+                try {
+                    classInfos = parser->parseClassInfos(status);
+                } catch (const Exception& e) {
+                    classInfos.clear();
+                    status.error(line, kdl::str_to_string("Failed to parse included file: ", e.what()));
+                }
             }
+        };
 
-            if (kdl::ci::str_is_equal(token.data(), "@include")) {
-                auto includedClassInfos = parseInclude(status);
-                classInfos = kdl::vec_concat(classInfos, std::move(includedClassInfos));
-            } else {
-                if (auto classInfo = parseClassInfo(status)) {
-                    classInfos.push_back(std::move(*classInfo));
+        std::vector<EntityDefinitionClassInfo> FgdParser::parseClassInfos(ParserStatus& status) {
+            // Included files are parsed concurrently while this file is parsed. Their class infos are inserted at the
+            // positions of the include directives afterwards. The messages of this file are buffered so that the
+            // messages of the included files can be logged at the positions of the include directives, too.
+            struct Include {
+                size_t classInfoPosition;
+                size_t messagePosition;
+                std::unique_ptr<IncludedFile> file;
+            };
+            auto includes = std::vector<Include>{};
+            auto includeTasks = kdl::task_group{};
+
+            auto bufferedStatus = BufferedParserStatus{};
+            const auto logMessagesInOrder = [&]() {
+                const auto& messages = bufferedStatus.messages();
+                auto next = std::begin(messages);
+                for (const auto& include : includes) {
+                    const auto includePosition = std::next(std::begin(messages), static_cast<std::ptrdiff_t>(include.messagePosition));
+                    logMessages(status, BufferedParserStatus::Messages{next, includePosition});
+                    logMessages(status, include.file->status.messages());
+                    next = includePosition;
                 }
-                status.progress(m_tokenizer.progress());
+                logMessages(status, BufferedParserStatus::Messages{next, std::end(messages)});
+            };
+
+            auto classInfos = std::vector<EntityDefinitionClassInfo>{};
+            try {
+                auto token = m_tokenizer.peekToken();
+                while (!token.hasType(FgdToken::Eof)) {
+                    token = expect(bufferedStatus, FgdToken::Eof | FgdToken::Word, token);
+                    if (kdl::ci::str_is_equal(token.data(), "@include")) {
+                        if (auto includedFile = parseInclude(bufferedStatus)) {
+                            auto* includedFilePtr = includedFile.get();
+                            includeTasks.run([includedFilePtr]() { includedFilePtr->parse(); });
+                            includes.push_back(Include{classInfos.size(), bufferedStatus.messages().size(), std::move(includedFile)});
+                        }
+                    } else {
+                        if (auto classInfo = parseClassInfo(bufferedStatus)) {
+                            classInfos.push_back(std::move(*classInfo));
+                        }
+                        status.progress(m_tokenizer.progress());
+                    }
+                    token = m_tokenizer.peekToken();
+                }
+            } catch (...) {
+                includeTasks.wait();
+                logMessagesInOrder();
+                throw;
+            }
+
+            includeTasks.wait();
+            logMessagesInOrder();
+            if (includes.empty()) {
+                return classInfos;
             }
+
+            auto result = std::vector<EntityDefinitionClassInfo>{};
+            auto next = std::begin(classInfos);
+            for (auto& include : includes) {
+                const auto includePosition = std::next(std::begin(classInfos), static_cast<std::ptrdiff_t>(include.classInfoPosition));
+                result.insert(std::end(result), std::make_move_iterator(next), std::make_move_iterator(includePosition));
+                result.insert(std::end(result), std::make_move_iterator(std::begin(include.file->classInfos)), std::make_move_iterator(std::end(include.file->classInfos)));
+                next = includePosition;
+
+                m_includedFiles = kdl::vec_concat(std::move(m_includedFiles), include.file->parser->m_includedFiles);
+            }
+            result.insert(std::end(result), std::make_move_iterator(next), std::make_move_iterator(std::end(classInfos)));
+            return result;
+        }
+
+        EntityDefinitionParser::FileStamps FgdParser::includedFiles() const {
+            return m_includedFiles;
         }
 
         std::optional<EntityDefinitionClassInfo> FgdParser::parseClassInfo(ParserStatus& status) {
@@ -700,43 +756,55 @@ namespace TrenchBroom {
             }
         }
 
-        std::vector<EntityDefinitionClassInfo> FgdParser::parseInclude(ParserStatus& status) {
+        std::unique_ptr<FgdParser::IncludedFile> FgdParser::parseInclude(ParserStatus& status) {
             auto token = expect(status, FgdToken::Word, m_tokenizer.nextToken());
             assert(kdl::ci::str_is_equal(token.data(), "@include"));
 
             expect(status, FgdToken::String, token = m_tokenizer.nextToken());
             const auto path = Path(token.data());
-            return handleInclude(status, path);
+            return openInclude(status, path);
         }
 
-        std::vector<EntityDefinitionClassInfo> FgdParser::handleInclude(ParserStatus& status, const Path& path) {
+        std::unique_ptr<FgdParser::IncludedFile> FgdParser::openInclude(ParserStatus& status, const Path& path) {
             if (m_fs == nullptr) {
-                status.error(m_tokenizer.line(), kdl::str_to_string("Cannot include file without host file path"));
-                return {};
+                status.error(m_tokenizer.line(), kdl::str_to_string("Cannot include file without host file path"));
+                return nullptr;
             }
-        
-            const auto snapshot = m_tokenizer.snapshotStateAndSource();
-            auto result = std::vector<EntityDefinitionClassInfo>();
+
+            const auto line = m_tokenizer.line();
             try {
-                status.debug(m_tokenizer.line(), "Parsing included file '" + path.asString() + "'");
-                const auto file = m_fs->openFile(currentRoot() + path);
+                status.debug(line, "Parsing included file '" + path.asString() + "'");
+                addIncludedFile(currentRoot() + path);
+
+                auto file = m_fs->openFile(currentRoot() + path);
                 const auto filePath = file->path();
-                status.debug(m_tokenizer.line(), "Resolved '" + path.asString() + "' to '" + filePath.asString() + "'");
+                status.debug(line, "Resolved '" + path.asString() + "' to '" + filePath.asString() + "'");
 
-                if (!isRecursiveInclude(filePath)) {
-                    const PushIncludePath pushIncludePath(this, filePath);
-                    auto reader = file->reader().buffer();
-                    m_tokenizer.replaceState(reader.stringView());
-                    result = parseClassInfos(status);
-                } else {
-                    status.error(m_tokenizer.line(), kdl::str_to_string("Skipping recursively included file: ", path.asString(), " (", filePath, ")"));
+                if (isRecursiveInclude(filePath)) {
+                    status.error(line, kdl::str_to_string("Skipping recursively included file: ", path.asString(), " (", filePath, ")"));
+                    return nullptr;
                 }
-            } catch (const Exception &e) {
-                status.error(m_tokenizer.line(), kdl::str_to_string("Failed to parse included file: ", e.what()));
+
+                auto reader = file->reader().buffer();
+                auto parser = std::unique_ptr<FgdParser>{new FgdParser{reader.stringView(), defaultEntityColor(), m_fs, kdl::vec_concat(m_paths, std::vector<Path>{filePath})}};
+                return std::unique_ptr<IncludedFile>{new IncludedFile{line, std::move(file), std::move(reader), std::move(parser), BufferedParserStatus{}, {}}};
+            } catch (const Exception& e) {
+                status.error(line, kdl::str_to_string("Failed to parse included file: ", e.what()));
+                return nullptr;
             }
+        }
 
-            m_tokenizer.restoreStateAndSource(snapshot);
-            return result;
+        /**
+         * Records the stamp of the given file before it is read so that changes made while it is parsed invalidate
+         * the cached class infos.
+         */
+        void FgdParser::addIncludedFile(const Path& path) {
+            try {
+                const auto absolutePath = m_fs->makeAbsolute(path);
+                m_includedFiles.emplace_back(absolutePath, Disk::fileStamp(absolutePath));
+            } catch (const FileSystemException&) {
+                // the file cannot exist, so it cannot change either
+            }
         }
     }
 }
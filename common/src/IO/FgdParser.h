@@ -73,15 +73,14 @@ namespace TrenchBroom {
 
             std::vector<Path> m_paths;
             std::shared_ptr<FileSystem> m_fs;
+            FileStamps m_includedFiles;
 
             FgdTokenizer m_tokenizer;
         public:
             FgdParser(std::string_view str, const Color& defaultEntityColor, const Path& path);
             FgdParser(std::string_view str, const Color& defaultEntityColor);
         private:
-            class PushIncludePath;
-            void pushIncludePath(const Path& path);
-            void popIncludePath();
+            FgdParser(std::string_view str, const Color& defaultEntityColor, std::shared_ptr<FileSystem> fs, std::vector<Path> paths);
 
             Path currentRoot() const;
             bool isRecursiveInclude(const Path& path) const;
@@ -89,8 +88,7 @@ namespace TrenchBroom {
             TokenNameMap tokenNames() const override;
 
             std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) override;
-
-            void parseClassInfoOrInclude(ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos);
+            FileStamps includedFiles() const override;
 
             std::optional<EntityDefinitionClassInfo> parseClassInfo(ParserStatus& status);
             EntityDefinitionClassInfo parseSolidClassInfo(ParserStatus& status);
@@ -126,8 +124,10 @@ namespace TrenchBroom {
             Color parseColor(ParserStatus& status);
             std::string parseString(ParserStatus& status);
 
-            std::vector<EntityDefinitionClassInfo> parseInclude(ParserStatus& status);
-            std::vector<EntityDefinitionClassInfo> handleInclude(ParserStatus& status, const Path& path);
+            struct IncludedFile;
+            std::unique_ptr<IncludedFile> parseInclude(ParserStatus& status);
+            std::unique_ptr<IncludedFile> openInclude(ParserStatus& status, const Path& path);
+            void addIncludedFile(const Path& path);
         };
     }
 }
@@ -60,22 +60,6 @@ namespace TrenchBroom {
             }
         }
 
-        static Color getAverageColor(const Assets::TextureBuffer& buffer, const GLenum format) {
-            ensure(format == GL_RGBA || format == GL_BGRA, "expected RGBA or BGRA");
-
-            const unsigned char* const data = buffer.data();
-            const std::size_t bufferSize = buffer.size();
-
-            Color average;
-            for (std::size_t i = 0; i < bufferSize; i += 4) {
-                average = average + Color(data[i], data[i+1], data[i+2], data[i+3]);
-            }
-            const std::size_t numPixels = bufferSize / 4;
-            average = average / static_cast<float>(numPixels);
-
-            return average;
-        }
-
         Assets::Texture FreeImageTextureReader::doReadTexture(std::shared_ptr<File> file) const {
             auto reader = file->reader().buffer();
 
@@ -137,7 +121,12 @@ namespace TrenchBroom {
             FreeImage_CloseMemory(imageMemory);
 
             const auto textureType = Assets::Texture::selectTextureType(masked);
-            const Color averageColor = getAverageColor(buffers.at(0), format);
+            const auto averageColor = Assets::averageColor(buffers.at(0), format);
+
+            // masked textures only use their first mip level, see Texture::uploadPixels
+            if (textureType != Assets::TextureType::Masked) {
+                Assets::generateMipBuffers(buffers, imageWidth, imageHeight, format);
+            }
 
             return Assets::Texture(textureName(path), imageWidth, imageHeight, averageColor, std::move(buffers), format, textureType);
         }
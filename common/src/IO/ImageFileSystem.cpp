@@ -23,17 +23,29 @@
 #include "IO/DiskFileSystem.h"
 #include "IO/File.h"
 
+#include <kdl/string_format.h>
+
 #include <cassert>
 #include <memory>
+#include <mutex>
+#include <string>
 
 namespace TrenchBroom {
     namespace IO {
         ImageFileSystemBase::FileEntry::~FileEntry() = default;
 
-       std::shared_ptr<File> ImageFileSystemBase::FileEntry::open() const {
+        std::shared_ptr<File> ImageFileSystemBase::FileEntry::open() const {
             return doOpen();
         }
 
+        bool ImageFileSystemBase::FileEntry::compressed() const {
+            return doIsCompressed();
+        }
+
+        bool ImageFileSystemBase::FileEntry::doIsCompressed() const {
+            return false;
+        }
+
         ImageFileSystemBase::SimpleFileEntry::SimpleFileEntry(std::shared_ptr<File> file) :
         m_file(std::move(file)) {}
 
@@ -50,157 +62,167 @@ namespace TrenchBroom {
             return std::make_shared<OwningBufferFile>(m_file->path(), std::move(data), m_uncompressedSize);
         }
 
-        ImageFileSystemBase::Directory::Directory(const Path& path) :
-        m_path(path) {}
-
-        void ImageFileSystemBase::Directory::addFile(const Path& path, std::shared_ptr<File> file) {
-            addFile(path, std::make_unique<SimpleFileEntry>(file));
+        bool ImageFileSystemBase::CompressedFileEntry::doIsCompressed() const {
+            return true;
         }
 
-        void ImageFileSystemBase::Directory::addFile(const Path& path, std::unique_ptr<FileEntry> file) {
-            ensure(file != nullptr, "file is null");
-            const auto filename = path.lastComponent();
-            if (path.length() == 1) {
-                // silently overwrite duplicates, the latest entries win
-                m_files[filename] = std::move(file);
-            } else {
-                auto& dir = findOrCreateDirectory(path.deleteLastComponent());
-                dir.addFile(filename, std::move(file));
-            }
+        static std::string indexKey(const Path& path) {
+            return kdl::str_to_lower(path.asString("/"));
         }
 
-        bool ImageFileSystemBase::Directory::directoryExists(const Path& path) const {
-            if (path.isEmpty()) {
-                return true;
-            }
+        static const size_t DefaultCacheCapacity = 64u * 1024u * 1024u;
 
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                return false;
-            } else {
-                return it->second->directoryExists(path.deleteFirstComponent());
-            }
-        }
+        ImageFileSystemBase::ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path) :
+        FileSystem(std::move(next)),
+        m_path(path),
+        m_cacheCapacity(DefaultCacheCapacity),
+        m_cacheSize(0) {}
 
-        bool ImageFileSystemBase::Directory::fileExists(const Path& path) const {
-            if (path.length() == 1) {
-                return m_files.count(path) > 0;
-            }
+        ImageFileSystemBase::~ImageFileSystemBase() = default;
 
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                return false;
-            } else {
-                return it->second->fileExists(path.deleteFirstComponent());
-            }
-        }
+        void ImageFileSystemBase::initialize() {
+            // the root directory always exists
+            m_directories[indexKey(Path())];
 
-        const ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findDirectory(const Path& path) const {
-            if (path.isEmpty()) {
-                return *this;
+            try {
+                doReadDirectory();
+            } catch (const std::exception& e) {
+                throw FileSystemException("Could not initialize image file system '" + m_path.asString() + "': " + e.what());
             }
+        }
 
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                throw FileSystemException("Path does not exist: '" + (m_path + path).asString() + "'");
-            } else {
-                return it->second->findDirectory(path.deleteFirstComponent());
-            }
+        void ImageFileSystemBase::addFile(const Path& path, std::shared_ptr<File> file) {
+            addFile(path, std::make_unique<SimpleFileEntry>(file));
         }
 
-        const ImageFileSystemBase::FileEntry& ImageFileSystemBase::Directory::findFile(const Path& path) const {
-            assert(!path.isEmpty());
+        void ImageFileSystemBase::addFile(const Path& path, std::unique_ptr<FileEntry> file) {
+            ensure(file != nullptr, "file is null");
+            ensure(!path.isEmpty() && !path.isAbsolute(), "path must be relative");
 
-            const auto name = path.firstComponent();
-            if (path.length() == 1) {
-                auto it = m_files.find(name);
-                if (it == std::end(m_files)) {
-                    throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
-                } else {
-                    return *it->second;
-                }
-            } else {
-                auto it = m_directories.find(name);
-                if (it == std::end(m_directories)) {
-                    throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
-                } else {
-                    return it->second->findFile(path.deleteFirstComponent());
+            // silently overwrite duplicates, the latest entries win
+            m_files[indexKey(path)] = std::move(file);
+
+            auto parentPath = path.deleteLastComponent();
+            m_directories[indexKey(parentPath)].files.insert(path.lastComponent());
+
+            // register the parent directories until we find one that is already registered
+            while (!parentPath.isEmpty()) {
+                const auto name = parentPath.lastComponent();
+                parentPath = parentPath.deleteLastComponent();
+                if (!m_directories[indexKey(parentPath)].directories.insert(name).second) {
+                    break;
                 }
             }
         }
 
-        std::vector<Path> ImageFileSystemBase::Directory::contents() const {
-            std::vector<Path> contents;
+        void ImageFileSystemBase::reload() {
+            m_files.clear();
+            m_directories.clear();
+            clearCache();
+            initialize();
+        }
 
-            for (const auto& [path, directory] : m_directories) {
-                contents.push_back(Path(path));
-            }
+        void ImageFileSystemBase::setCacheCapacity(const size_t cacheCapacity) {
+            std::lock_guard<std::mutex> lock{m_cacheMutex};
+            m_cacheCapacity = cacheCapacity;
+            evictCache();
+        }
 
-            for (const auto& [path, file] : m_files) {
-                contents.push_back(Path(path));
-            }
+        std::vector<Path> ImageFileSystemBase::filePaths() const {
+            auto result = std::vector<Path>{};
+            result.reserve(m_files.size());
+            collectFilePaths(Path(), result);
+            return result;
+        }
 
-            return contents;
+        bool ImageFileSystemBase::doDirectoryExists(const Path& path) const {
+            return m_directories.count(indexKey(path)) > 0u;
         }
 
-        ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findOrCreateDirectory(const Path& path) {
-            if (path.isEmpty()) {
-                return *this;
-            }
+        bool ImageFileSystemBase::doFileExists(const Path& path) const {
+            return m_files.count(indexKey(path)) > 0u;
+        }
 
-            const auto name = path.firstComponent();
-            auto it = m_directories.lower_bound(name);
-            if (it == std::end(m_directories) || name != it->first) {
-                it = m_directories.insert(it, std::make_pair(name, new Directory(m_path + Path(name))));
+        std::vector<Path> ImageFileSystemBase::doGetDirectoryContents(const Path& path) const {
+            const auto it = m_directories.find(indexKey(path));
+            if (it == std::end(m_directories)) {
+                throw FileSystemException("Path does not exist: '" + path.asString() + "'");
             }
-            return it->second->findOrCreateDirectory(path.deleteFirstComponent());
-        }
 
-        ImageFileSystemBase::ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path) :
-        FileSystem(std::move(next)),
-        m_path(path),
-        m_root(Path()) {}
+            const auto& directory = it->second;
+            auto contents = std::vector<Path>{};
+            contents.reserve(directory.directories.size() + directory.files.size());
+            contents.insert(std::end(contents), std::begin(directory.directories), std::end(directory.directories));
+            contents.insert(std::end(contents), std::begin(directory.files), std::end(directory.files));
+            return contents;
+        }
 
+        std::shared_ptr<File> ImageFileSystemBase::doOpenFile(const Path& path) const {
+            const auto key = indexKey(path);
+            const auto it = m_files.find(key);
+            if (it == std::end(m_files)) {
+                throw FileSystemException("File not found: '" + path.asString() + "'");
+            }
 
-        ImageFileSystemBase::~ImageFileSystemBase() = default;
+            const auto& entry = *it->second;
+            return entry.compressed() ? openCompressedFile(key, entry) : entry.open();
+        }
 
-        void ImageFileSystemBase::initialize() {
-            try {
-                doReadDirectory();
-            } catch (const std::exception& e) {
-                throw FileSystemException("Could not initialize image file system '" + m_path.asString() + "': " + e.what());
+        std::shared_ptr<File> ImageFileSystemBase::openCompressedFile(const std::string& key, const FileEntry& entry) const {
+            {
+                std::lock_guard<std::mutex> lock{m_cacheMutex};
+                const auto it = m_cacheMap.find(key);
+                if (it != std::end(m_cacheMap)) {
+                    m_cacheList.splice(std::begin(m_cacheList), m_cacheList, it->second);
+                    return it->second->second;
+                }
             }
-        }
 
-        void ImageFileSystemBase::reload() {
-            m_root = Directory(Path());
-            initialize();
-        }
+            // decompress without holding the lock so that several entries can be decompressed concurrently
+            auto file = entry.open();
 
-        bool ImageFileSystemBase::doDirectoryExists(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.directoryExists(searchPath);
+            std::lock_guard<std::mutex> lock{m_cacheMutex};
+            if (m_cacheMap.count(key) == 0u && file->size() <= m_cacheCapacity) {
+                m_cacheList.emplace_front(key, file);
+                m_cacheMap.emplace(key, std::begin(m_cacheList));
+                m_cacheSize += file->size();
+                evictCache();
+            }
+            return file;
         }
 
-        bool ImageFileSystemBase::doFileExists(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.fileExists(searchPath);
+        void ImageFileSystemBase::collectFilePaths(const Path& directoryPath, std::vector<Path>& result) const {
+            const auto it = m_directories.find(indexKey(directoryPath));
+            if (it != std::end(m_directories)) {
+                const auto& directory = it->second;
+                for (const auto& name : directory.files) {
+                    result.push_back(directoryPath + name);
+                }
+                for (const auto& name : directory.directories) {
+                    collectFilePaths(directoryPath + name, result);
+                }
+            }
         }
 
-        std::vector<Path> ImageFileSystemBase::doGetDirectoryContents(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            const auto& directory = m_root.findDirectory(path);
-            return directory.contents();
+        void ImageFileSystemBase::clearCache() {
+            std::lock_guard<std::mutex> lock{m_cacheMutex};
+            m_cacheList.clear();
+            m_cacheMap.clear();
+            m_cacheSize = 0;
         }
 
-        std::shared_ptr<File> ImageFileSystemBase::doOpenFile(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.findFile(path).open();
+        void ImageFileSystemBase::evictCache() const {
+            while (m_cacheSize > m_cacheCapacity) {
+                const auto& [key, file] = m_cacheList.back();
+                m_cacheSize -= file->size();
+                m_cacheMap.erase(key);
+                m_cacheList.pop_back();
+            }
         }
 
         ImageFileSystem::ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path) :
         ImageFileSystemBase(std::move(next), path),
-        m_file(std::make_shared<CFile>(path)) {
+        m_file(std::make_shared<MappedFile>(path)) {
             ensure(m_path.isAbsolute(), "path must be absolute");
         }
     }
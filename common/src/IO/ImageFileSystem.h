@@ -24,12 +24,16 @@
 
 #include <kdl/string_compare.h>
 
-#include <map>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 namespace TrenchBroom {
     namespace IO {
-        class CFile;
         class File;
 
         class ImageFileSystemBase : public FileSystem {
@@ -39,8 +43,15 @@ namespace TrenchBroom {
                 virtual ~FileEntry();
 
                 std::shared_ptr<File> open() const;
+
+                /**
+                 * Indicates whether opening this entry decompresses it. Decompressed entries are cached by the file
+                 * system.
+                 */
+                bool compressed() const;
             private:
                 virtual std::shared_ptr<File> doOpen() const = 0;
+                virtual bool doIsCompressed() const;
             };
 
             class SimpleFileEntry : public FileEntry {
@@ -61,62 +72,90 @@ namespace TrenchBroom {
                 ~CompressedFileEntry() override = default;
             private:
                 std::shared_ptr<File> doOpen() const override;
+                bool doIsCompressed() const override;
                 virtual std::unique_ptr<char[]> decompress(std::shared_ptr<File> file, size_t uncompressedSize) const = 0;
             };
+        private:
+            using NameSet = std::set<Path, Path::Less<kdl::ci::string_less>>;
 
-            class Directory {
-            private:
-                using DirMap  = std::map<Path, std::unique_ptr<Directory>, Path::Less<kdl::ci::string_less>>;
-                using FileMap = std::map<Path, std::unique_ptr<FileEntry>, Path::Less<kdl::ci::string_less>>;
-
-                Path m_path;
-                DirMap m_directories;
-                FileMap m_files;
-            public:
-                explicit Directory(const Path& path);
-
-                void addFile(const Path& path, std::shared_ptr<File> file);
-                void addFile(const Path& path, std::unique_ptr<FileEntry> file);
+            struct DirectoryEntry {
+                NameSet directories;
+                NameSet files;
+            };
 
-                bool directoryExists(const Path& path) const;
-                bool fileExists(const Path& path) const;
+            /**
+             * All files and directories are indexed by their lower case path, so that looking them up doesn't depend
+             * on the depth of the path or the number of entries.
+             */
+            using FileMap = std::unordered_map<std::string, std::unique_ptr<FileEntry>>;
+            using DirectoryMap = std::unordered_map<std::string, DirectoryEntry>;
 
-                const Directory& findDirectory(const Path& path) const;
-                const FileEntry& findFile(const Path& path) const;
-                std::vector<Path> contents() const;
-            private:
-                Directory& findOrCreateDirectory(const Path& path);
-            };
+            /**
+             * The most recently opened decompressed files, most recent first.
+             */
+            using CacheList = std::list<std::pair<std::string, std::shared_ptr<File>>>;
+            using CacheMap = std::unordered_map<std::string, CacheList::iterator>;
         protected:
             Path m_path;
-            Directory m_root;
+        private:
+            FileMap m_files;
+            DirectoryMap m_directories;
+
+            size_t m_cacheCapacity;
+            mutable std::mutex m_cacheMutex;
+            mutable CacheList m_cacheList;
+            mutable CacheMap m_cacheMap;
+            mutable size_t m_cacheSize;
         protected:
             ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path);
         public:
             ~ImageFileSystemBase() override;
         protected:
             void initialize();
+
+            /**
+             * Adds the given file at the given path, which must be relative. If a file with the same path (ignoring
+             * case) was already added, it is replaced.
+             */
+            void addFile(const Path& path, std::shared_ptr<File> file);
+            void addFile(const Path& path, std::unique_ptr<FileEntry> file);
         public:
             /**
              * Reload this file system.
              */
             void reload();
+
+            /**
+             * Sets the maximum number of bytes of decompressed files that this file system keeps in memory so that
+             * they don't need to be decompressed again when they are opened again.
+             */
+            void setCacheCapacity(size_t cacheCapacity);
+
+            /**
+             * Returns the paths of all files of this file system, not including the files of the next file system.
+             */
+            std::vector<Path> filePaths() const;
         private:
             bool doDirectoryExists(const Path& path) const override;
             bool doFileExists(const Path& path) const override;
 
             std::vector<Path> doGetDirectoryContents(const Path& path) const override;
             std::shared_ptr<File> doOpenFile(const Path& path) const override;
+        private:
+            std::shared_ptr<File> openCompressedFile(const std::string& key, const FileEntry& entry) const;
+            void collectFilePaths(const Path& directoryPath, std::vector<Path>& result) const;
+            void clearCache();
+            void evictCache() const;
         private:
             virtual void doReadDirectory() = 0;
         };
 
         class ImageFileSystem : public ImageFileSystemBase {
         protected:
-            std::shared_ptr<CFile> m_file;
+            // the image file is mapped into memory, so its entries can be read concurrently
+            std::shared_ptr<File> m_file;
         protected:
             ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path);
         };
     }
 }
-
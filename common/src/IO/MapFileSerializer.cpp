@@ -28,6 +28,7 @@
 #include "Model/EntityNode.h"
 #include "Model/EntityProperties.h"
 #include "Model/GroupNode.h"
+#include "Model/Layer.h"
 #include "Model/LayerNode.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
@@ -35,7 +36,7 @@
 #include <kdl/overload.h>
 #include <kdl/parallel.h>
 #include <kdl/string_format.h>
-#include <kdl/vector_utils.h>
+#include <kdl/thread_pool.h>
 
 #include <fmt/format.h>
 
@@ -50,8 +51,8 @@ namespace TrenchBroom {
     namespace IO {
         class QuakeFileSerializer : public MapFileSerializer {
         public:
-            explicit QuakeFileSerializer(std::ostream& stream) :
-            MapFileSerializer(stream) {}
+            QuakeFileSerializer(std::ostream& stream, const size_t memoryBudget) :
+            MapFileSerializer(stream, memoryBudget) {}
         private:
             void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
                 writeFacePoints(stream, face);
@@ -120,8 +121,8 @@ namespace TrenchBroom {
 
         class Quake2FileSerializer : public QuakeFileSerializer {
         public:
-            explicit Quake2FileSerializer(std::ostream& stream) :
-            QuakeFileSerializer(stream) {}
+            Quake2FileSerializer(std::ostream& stream, const size_t memoryBudget) :
+            QuakeFileSerializer(stream, memoryBudget) {}
         private:
             void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
                 writeFacePoints(stream, face);
@@ -144,8 +145,8 @@ namespace TrenchBroom {
 
         class Quake2ValveFileSerializer : public Quake2FileSerializer {
         public:
-            explicit Quake2ValveFileSerializer(std::ostream& stream) :
-            Quake2FileSerializer(stream) {}
+            Quake2ValveFileSerializer(std::ostream& stream, const size_t memoryBudget) :
+            Quake2FileSerializer(stream, memoryBudget) {}
         private:
             void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
                 writeFacePoints(stream, face);
@@ -160,8 +161,8 @@ namespace TrenchBroom {
         private:
             std::string SurfaceColorFormat;
         public:
-            explicit DaikatanaFileSerializer(std::ostream& stream) :
-            Quake2FileSerializer(stream),
+            DaikatanaFileSerializer(std::ostream& stream, const size_t memoryBudget) :
+            Quake2FileSerializer(stream, memoryBudget),
             SurfaceColorFormat(" %d %d %d") {}
         private:
             void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
@@ -188,8 +189,8 @@ namespace TrenchBroom {
 
         class Hexen2FileSerializer : public QuakeFileSerializer {
         public:
-            explicit Hexen2FileSerializer(std::ostream& stream):
-            QuakeFileSerializer(stream) {}
+            Hexen2FileSerializer(std::ostream& stream, const size_t memoryBudget) :
+            QuakeFileSerializer(stream, memoryBudget) {}
         private:
             void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
                 writeFacePoints(stream, face);
@@ -200,8 +201,8 @@ namespace TrenchBroom {
 
         class ValveFileSerializer : public QuakeFileSerializer {
         public:
-            explicit ValveFileSerializer(std::ostream& stream) :
-            QuakeFileSerializer(stream) {}
+            ValveFileSerializer(std::ostream& stream, const size_t memoryBudget) :
+            QuakeFileSerializer(stream, memoryBudget) {}
         private:
             void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
                 writeFacePoints(stream, face);
@@ -210,75 +211,129 @@ namespace TrenchBroom {
             }
         };
 
-        std::unique_ptr<NodeSerializer> MapFileSerializer::create(const Model::MapFormat format, std::ostream& stream) {
+        static std::unique_ptr<MapFileSerializer> createSerializer(const Model::MapFormat format, std::ostream& stream, const size_t memoryBudget) {
             switch (format) {
                 case Model::MapFormat::Standard:
-                    return std::make_unique<QuakeFileSerializer>(stream);
+                    return std::make_unique<QuakeFileSerializer>(stream, memoryBudget);
                 case Model::MapFormat::Quake2:
                     // TODO 2427: Implement Quake3 serializers and use them
                 case Model::MapFormat::Quake3:
                 case Model::MapFormat::Quake3_Legacy:
-                    return std::make_unique<Quake2FileSerializer>(stream);
+                    return std::make_unique<Quake2FileSerializer>(stream, memoryBudget);
                 case Model::MapFormat::Quake2_Valve:
                 case Model::MapFormat::Quake3_Valve:
-                    return std::make_unique<Quake2ValveFileSerializer>(stream);
+                    return std::make_unique<Quake2ValveFileSerializer>(stream, memoryBudget);
                 case Model::MapFormat::Daikatana:
-                    return std::make_unique<DaikatanaFileSerializer>(stream);
+                    return std::make_unique<DaikatanaFileSerializer>(stream, memoryBudget);
                 case Model::MapFormat::Valve:
-                    return std::make_unique<ValveFileSerializer>(stream);
+                    return std::make_unique<ValveFileSerializer>(stream, memoryBudget);
                 case Model::MapFormat::Hexen2:
-                    return std::make_unique<Hexen2FileSerializer>(stream);
+                    return std::make_unique<Hexen2FileSerializer>(stream, memoryBudget);
                 case Model::MapFormat::Unknown:
                     throw FileFormatException("Unknown map file format");
                 switchDefault()
             }
         }
 
-        MapFileSerializer::MapFileSerializer(std::ostream& stream) :
-        m_line(1),
-        m_stream(stream) {}
+        std::unique_ptr<NodeSerializer> MapFileSerializer::create(const Model::MapFormat format, std::ostream& stream, const size_t memoryBudget) {
+            auto serializer = createSerializer(format, stream, memoryBudget);
+            // the format identifies the serializations cached on the nodes
+            serializer->m_format = format;
+            return serializer;
+        }
 
-        void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootNodes) {
-            ensure(m_nodeToPrecomputedString.empty(), "MapFileSerializer may not be reused");
-
-            // collect nodes
-            std::vector<std::variant<const Model::BrushNode*, const Model::PatchNode*>> nodesToSerialize;
-            nodesToSerialize.reserve(rootNodes.size());
-
-            Model::Node::visitAll(rootNodes, kdl::overload(
-                [](auto&& thisLambda, const Model::WorldNode* world) { world->visitChildren(thisLambda); },
-                [](auto&& thisLambda, const Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
-                [](auto&& thisLambda, const Model::GroupNode* group) { group->visitChildren(thisLambda); },
-                [](auto&& thisLambda, const Model::EntityNode* entity) { entity->visitChildren(thisLambda); },
-                [&](const Model::BrushNode* brush) {
-                    nodesToSerialize.push_back(brush);
+        /**
+         * Returns a rough estimate of the number of bytes that the serialization of the given node takes up.
+         */
+        static size_t estimateSerializedSize(const std::variant<const Model::BrushNode*, const Model::PatchNode*>& node, const Model::MapFormat format) {
+            static const size_t bytesPerFace = 128u;
+            static const size_t bytesPerControlPoint = 48u;
+            static const size_t bytesPerPatch = 128u;
+
+            // cached serializations are kept alive by the window as long as the node is not written
+            if (const auto cachedSerialization = std::visit([&](const auto* n) { return n->cachedSerialization(format); }, node)) {
+                return cachedSerialization->text.size();
+            }
+
+            return std::visit(kdl::overload(
+                [](const Model::BrushNode* brushNode) {
+                    return brushNode->brush().faceCount() * bytesPerFace;
                 },
-                [&](const Model::PatchNode* patchNode) {
-                    nodesToSerialize.push_back(patchNode);
+                [](const Model::PatchNode* patchNode) {
+                    return patchNode->patch().controlPoints().size() * bytesPerControlPoint + bytesPerPatch;
                 }
-            ));
-
-            // serialize brushes to strings in parallel
-            using Entry = std::pair<const Model::Node*, PrecomputedString>;
-            std::vector<Entry> result = kdl::vec_parallel_transform(std::move(nodesToSerialize),
-                [&](const auto& node) {
-                    return std::visit(kdl::overload(
-                        [&](const Model::BrushNode* brushNode) {
-                            return Entry{brushNode, writeBrushFaces(brushNode->brush())};
-                        },
-                        [&](const Model::PatchNode* patchNode) {
-                            return Entry{patchNode, writePatch(patchNode->patch())};
-                        }
-                    ), node);
-                });
-            
-            // move strings into a map
-            for (auto& entry: result) {
-                m_nodeToPrecomputedString.insert(std::move(entry));
+            ), node);
+        }
+
+        MapFileSerializer::MapFileSerializer(std::ostream& stream, const size_t memoryBudget) :
+        m_line(1),
+        m_stream(stream),
+        m_memoryBudget(memoryBudget),
+        m_format(Model::MapFormat::Unknown),
+        m_nextWindowBegin(0u) {}
+
+        MapFileSerializer::~MapFileSerializer() {
+            // only relevant if endFile was not called, the background task refers to this serializer
+            m_nextWindowTask.reset();
+        }
+
+        void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootNodes) {
+            ensure(m_nodesToSerialize.empty(), "MapFileSerializer may not be reused");
+
+            const auto addNode = [&](const auto* node) {
+                m_nodeIndices.emplace(node, m_nodesToSerialize.size());
+                m_nodesToSerialize.emplace_back(node);
+            };
+
+            // layers that are omitted from the export are not written at all
+            const auto isOmitted = [&](const Model::LayerNode* layerNode) {
+                return exporting() && layerNode->layer().omitFromExport();
+            };
+
+            // collect nodes in the order in which NodeWriter usually writes them: the brushes and patches of a node
+            // are written before its groups and entities
+            const auto collectNodes = [&](const Model::Node* node, const auto& recurse) -> void {
+                node->visitChildren(kdl::overload(
+                    [] (const Model::WorldNode*)  {},
+                    [] (const Model::LayerNode*)  {},
+                    [] (const Model::GroupNode*)  {},
+                    [] (const Model::EntityNode*) {},
+                    [&](const Model::BrushNode* brushNode) { addNode(brushNode); },
+                    [&](const Model::PatchNode* patchNode) { addNode(patchNode); }
+                ));
+                node->visitChildren(kdl::overload(
+                    [&](const Model::WorldNode* worldNode)   { recurse(worldNode, recurse); },
+                    [&](const Model::LayerNode* layerNode)   { if (!isOmitted(layerNode)) { recurse(layerNode, recurse); } },
+                    [&](const Model::GroupNode* groupNode)   { recurse(groupNode, recurse); },
+                    [&](const Model::EntityNode* entityNode) { recurse(entityNode, recurse); },
+                    [] (const Model::BrushNode*) {},
+                    [] (const Model::PatchNode*) {}
+                ));
+            };
+
+            for (const auto* rootNode : rootNodes) {
+                rootNode->accept(kdl::overload(
+                    [&](const Model::WorldNode* worldNode)   { collectNodes(worldNode, collectNodes); },
+                    [&](const Model::LayerNode* layerNode)   { if (!isOmitted(layerNode)) { collectNodes(layerNode, collectNodes); } },
+                    [&](const Model::GroupNode* groupNode)   { collectNodes(groupNode, collectNodes); },
+                    [&](const Model::EntityNode* entityNode) { collectNodes(entityNode, collectNodes); },
+                    [&](const Model::BrushNode* brushNode)   { addNode(brushNode); },
+                    [&](const Model::PatchNode* patchNode)   { addNode(patchNode); }
+                ));
+            }
+
+            m_nodesInWindows.resize(m_nodesToSerialize.size(), false);
+            if (!m_nodesToSerialize.empty()) {
+                auto window = selectWindow(0u);
+                serializeWindow(window);
+                addWindow(window);
+                startSerializingNextWindow();
             }
         }
 
-        void MapFileSerializer::doEndFile() {}
+        void MapFileSerializer::doEndFile() {
+            waitForNextWindow();
+        }
 
         void MapFileSerializer::doBeginEntity(const Model::Node* /* node */) {
             fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// entity {}\n", entityNo());
@@ -309,11 +364,9 @@ namespace TrenchBroom {
             ++m_line;
 
             // write pre-serialized brush faces
-            auto it = m_nodeToPrecomputedString.find(brush);
-            ensure(it != std::end(m_nodeToPrecomputedString), "attempted to serialize a brush which was not passed to doBeginFile");
-            const PrecomputedString& precomputedString = it->second;
-            m_stream << precomputedString.string;
-            m_line += precomputedString.lineCount;
+            const auto precomputedString = this->precomputedString(brush);
+            m_stream << precomputedString->text;
+            m_line += precomputedString->lineCount;
 
             fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
             ++m_line;
@@ -333,11 +386,9 @@ namespace TrenchBroom {
             m_startLineStack.push_back(m_line);
 
             // write pre-serialized patch
-            auto it = m_nodeToPrecomputedString.find(patchNode);
-            ensure(it != std::end(m_nodeToPrecomputedString), "attempted to serialize a patch which was not passed to doBeginFile");
-            const PrecomputedString& precomputedString = it->second;
-            m_stream << precomputedString.string;
-            m_line += precomputedString.lineCount;
+            const auto precomputedString = this->precomputedString(patchNode);
+            m_stream << precomputedString->text;
+            m_line += precomputedString->lineCount;
 
             setFilePosition(patchNode);
         }
@@ -354,18 +405,150 @@ namespace TrenchBroom {
             return result;
         }
 
+        /**
+         * Returns the serialization of the given node and forgets about it. If the node was not serialized yet, a new
+         * window that starts with the given node is serialized. If every node is requested once, every node is
+         * serialized exactly once regardless of the order of the requests.
+         */
+        std::shared_ptr<const Model::CachedSerialization> MapFileSerializer::precomputedString(const Model::Node* node) {
+            const auto it = m_nodeIndices.find(node);
+            ensure(it != std::end(m_nodeIndices), "attempted to serialize a node which was not passed to doBeginFile");
+            const auto index = it->second;
+
+            const auto takeString = [&]() -> std::shared_ptr<const Model::CachedSerialization> {
+                if (auto stringIt = m_strings.find(node); stringIt != std::end(m_strings)) {
+                    auto result = std::move(stringIt->second);
+                    m_strings.erase(stringIt);
+                    return result;
+                }
+                return nullptr;
+            };
+
+            if (auto result = takeString()) {
+                return result;
+            }
+
+            waitForNextWindow();
+            if (!m_nodesInWindows[index]) {
+                auto window = selectWindow(index);
+                serializeWindow(window);
+                addWindow(window);
+            }
+            auto result = takeString();
+            startSerializingNextWindow();
+
+            // the node is written more than once
+            return result ? result : serializeNode(m_nodesToSerialize[index]);
+        }
+
+        /**
+         * Selects the nodes starting at the given index that are not part of another window until half of the memory
+         * budget is used up. At least one node is selected if the node at the given index is not part of another
+         * window.
+         */
+        MapFileSerializer::Window MapFileSerializer::selectWindow(const size_t begin) {
+            const auto windowBudget = m_memoryBudget / 2u;
+
+            auto window = Window{};
+            auto windowSize = size_t(0u);
+            auto end = begin;
+            while (end < m_nodesToSerialize.size()) {
+                if (!m_nodesInWindows[end]) {
+                    windowSize += estimateSerializedSize(m_nodesToSerialize[end], m_format);
+                    if (windowSize > windowBudget && !window.indices.empty()) {
+                        break;
+                    }
+                    window.indices.push_back(end);
+                    m_nodesInWindows[end] = true;
+                }
+                ++end;
+            }
+
+            // windows that start after the next window's position leave a gap that the next window must fill
+            if (begin <= m_nextWindowBegin && end > m_nextWindowBegin) {
+                m_nextWindowBegin = end;
+            }
+            return window;
+        }
+
+        void MapFileSerializer::addWindow(Window& window) {
+            for (size_t i = 0; i < window.indices.size(); ++i) {
+                const auto* node = std::visit([](const Model::Node* n) { return n; }, m_nodesToSerialize[window.indices[i]]);
+                m_strings.emplace(node, std::move(window.strings[i]));
+            }
+            window = Window{};
+        }
+
+        /**
+         * Serializes the nodes of the given window in parallel.
+         *
+         * Threadsafe
+         */
+        void MapFileSerializer::serializeWindow(Window& window) const {
+            window.strings.resize(window.indices.size());
+            kdl::parallel_for(window.indices.size(), [&](const size_t i) {
+                window.strings[i] = serializeNode(m_nodesToSerialize[window.indices[i]]);
+            });
+        }
+
+        /**
+         * Returns the serialization cached on the given node or serializes the node and caches the result.
+         *
+         * Threadsafe as long as no two threads serialize the same node.
+         */
+        std::shared_ptr<const Model::CachedSerialization> MapFileSerializer::serializeNode(const NodeToSerialize& node) const {
+            return std::visit(kdl::overload(
+                [&](const Model::BrushNode* brushNode) {
+                    auto result = brushNode->cachedSerialization(m_format);
+                    if (!result) {
+                        result = std::make_shared<const Model::CachedSerialization>(writeBrushFaces(brushNode->brush()));
+                        brushNode->setCachedSerialization(result);
+                    }
+                    return result;
+                },
+                [&](const Model::PatchNode* patchNode) {
+                    auto result = patchNode->cachedSerialization(m_format);
+                    if (!result) {
+                        result = std::make_shared<const Model::CachedSerialization>(writePatch(patchNode->patch()));
+                        patchNode->setCachedSerialization(result);
+                    }
+                    return result;
+                }
+            ), node);
+        }
+
+        void MapFileSerializer::startSerializingNextWindow() {
+            assert(!m_nextWindowTask);
+
+            m_nextWindow = selectWindow(m_nextWindowBegin);
+            if (!m_nextWindow.indices.empty()) {
+                m_nextWindowTask = std::make_unique<kdl::task_group>();
+                m_nextWindowTask->run([this]() {
+                    serializeWindow(m_nextWindow);
+                });
+            }
+        }
+
+        void MapFileSerializer::waitForNextWindow() {
+            if (m_nextWindowTask) {
+                m_nextWindowTask->wait();
+                m_nextWindowTask.reset();
+                addWindow(m_nextWindow);
+            }
+        }
+
         /**
          * Threadsafe
          */
-        MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(const Model::Brush& brush) const {
+        Model::CachedSerialization MapFileSerializer::writeBrushFaces(const Model::Brush& brush) const {
             std::stringstream stream;
             for (const Model::BrushFace& face : brush.faces()) {
                 doWriteBrushFace(stream, face);
             }
-            return PrecomputedString{stream.str(), brush.faces().size()};
+            return Model::CachedSerialization{m_format, stream.str(), brush.faces().size()};
         }
 
-        MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(const Model::BezierPatch& patch) const {
+        Model::CachedSerialization MapFileSerializer::writePatch(const Model::BezierPatch& patch) const {
             size_t lineCount = 0u;
             std::stringstream stream;
             
@@ -389,7 +572,7 @@ namespace TrenchBroom {
             fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n"); ++lineCount;
             fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n"); ++lineCount;
 
-            return PrecomputedString{stream.str(), lineCount};
+            return Model::CachedSerialization{m_format, stream.str(), lineCount};
         }
     }
 }
@@ -24,36 +24,85 @@
 
 #include <iosfwd>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <variant>
 #include <vector>
 
+namespace kdl {
+    class task_group;
+}
+
 namespace TrenchBroom {
     namespace Model {
         class BezierPatch;
         class Brush;
         class BrushNode;
         class BrushFace;
+        struct CachedSerialization;
         class EntityProperty;
         class Node;
         class PatchNode;
     }
 
     namespace IO {
+        /**
+         * Serializes nodes to the map file format.
+         *
+         * The brushes and patches are serialized to strings in parallel ahead of being written to the stream. To
+         * bound the memory used for these strings, they are serialized in windows of consecutive nodes whose total
+         * estimated size is at most half of the memory budget. While the strings of one window are written to the
+         * stream, the next window is serialized in the background. The strings are looked up by their nodes, so
+         * nodes that are written in a different order than they were collected in are only serialized once.
+         *
+         * The serialized brushes and patches are cached on their nodes until the nodes change. When a map is saved
+         * again, only the changed nodes must be serialized.
+         */
         class MapFileSerializer : public NodeSerializer {
+        public:
+            /**
+             * The default approximate number of bytes used for serialized brushes and patches that have not been
+             * written to the stream yet.
+             */
+            static constexpr size_t DefaultMemoryBudget = 64u * 1024u * 1024u;
         private:
             using LineStack = std::vector<size_t>;
             LineStack m_startLineStack;
             size_t m_line;
             std::ostream& m_stream;
+            size_t m_memoryBudget;
+            Model::MapFormat m_format;
 
-            struct PrecomputedString {
-                std::string string;
-                size_t lineCount;
+            using NodeToSerialize = std::variant<const Model::BrushNode*, const Model::PatchNode*>;
+            std::vector<NodeToSerialize> m_nodesToSerialize;
+            std::unordered_map<const Model::Node*, size_t> m_nodeIndices;
+            /**
+             * Whether the node at the corresponding index of m_nodesToSerialize was added to a window already.
+             */
+            std::vector<bool> m_nodesInWindows;
+            /**
+             * The index of m_nodesToSerialize at which to look for the nodes of the next window.
+             */
+            size_t m_nextWindowBegin;
+
+            /**
+             * The indices of some nodes of m_nodesToSerialize and their serialized strings.
+             */
+            struct Window {
+                std::vector<size_t> indices;
+                std::vector<std::shared_ptr<const Model::CachedSerialization>> strings;
             };
-            std::unordered_map<const Model::Node*, PrecomputedString> m_nodeToPrecomputedString;
+            /**
+             * The serialized strings of the nodes that have not been written yet.
+             */
+            std::unordered_map<const Model::Node*, std::shared_ptr<const Model::CachedSerialization>> m_strings;
+            Window m_nextWindow;
+            std::unique_ptr<kdl::task_group> m_nextWindowTask;
         public:
-            static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, std::ostream& stream);
+            static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, std::ostream& stream, size_t memoryBudget = DefaultMemoryBudget);
+            ~MapFileSerializer() override;
         protected:
-            explicit MapFileSerializer(std::ostream& stream);
+            MapFileSerializer(std::ostream& stream, size_t memoryBudget);
         private:
             void doBeginFile(const std::vector<const Model::Node*>& rootNodes) override;
             void doEndFile() override;
@@ -68,11 +117,18 @@ namespace TrenchBroom {
         private:
             void setFilePosition(const Model::Node* node);
             size_t startLine();
+
+            std::shared_ptr<const Model::CachedSerialization> precomputedString(const Model::Node* node);
+            Window selectWindow(size_t begin);
+            void addWindow(Window& window);
+            void serializeWindow(Window& window) const;
+            std::shared_ptr<const Model::CachedSerialization> serializeNode(const NodeToSerialize& node) const;
+            void startSerializingNextWindow();
+            void waitForNextWindow();
         private: // threadsafe
             virtual void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const = 0;
-            PrecomputedString writeBrushFaces(const Model::Brush& brush) const;
-            PrecomputedString writePatch(const Model::BezierPatch& patch) const;
+            Model::CachedSerialization writeBrushFaces(const Model::Brush& brush) const;
+            Model::CachedSerialization writePatch(const Model::BezierPatch& patch) const;
         };
     }
 }
-
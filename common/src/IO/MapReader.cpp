@@ -19,6 +19,8 @@
 
 #include "MapReader.h"
 
+#include "Exceptions.h"
+#include "IO/BufferedParserStatus.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
@@ -37,6 +39,7 @@
 #include <vecmath/mat.h>
 #include <vecmath/mat_io.h>
 
+#include <kdl/overload.h>
 #include <kdl/parallel.h>
 #include <kdl/result.h>
 #include <kdl/result_for_each.h>
@@ -44,9 +47,12 @@
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 
+#include <atomic>
 #include <cassert>
 #include <optional>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -54,11 +60,25 @@
 namespace TrenchBroom {
     namespace IO {
         MapReader::MapReader(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) :
-        StandardMapParser(std::move(str), sourceMapFormat, targetMapFormat) {}
+        StandardMapParser(str, sourceMapFormat, targetMapFormat),
+        m_str(str),
+        m_parallelChunkSize(DefaultParallelChunkSize) {}
+
+        MapReader::MapReader(const Chunk& chunk, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) :
+        StandardMapParser(chunk, sourceMapFormat, targetMapFormat),
+        m_str(chunk.str),
+        m_parallelChunkSize(0u) {}
+
+        void MapReader::setParallelChunkSize(const size_t parallelChunkSize) {
+            m_parallelChunkSize = parallelChunkSize;
+        }
 
         void MapReader::readEntities(const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseEntities(status);
+            if (!parseEntitiesInParallel(status)) {
+                parseEntities(status);
+            }
+            onObjectInfos(m_objectInfos, status);
             createNodes(status);
         }
 
@@ -73,6 +93,20 @@ namespace TrenchBroom {
             parseBrushFaces(status);
         }
 
+        void MapReader::readObjectInfos(std::vector<ObjectInfo> objectInfos, const vm::bbox3& worldBounds, ParserStatus& status) {
+            m_worldBounds = worldBounds;
+            m_objectInfos = std::move(objectInfos);
+            createNodes(status);
+        }
+
+        void MapReader::createBrushes(std::vector<ObjectInfo>& objectInfos) const {
+            kdl::parallel_for(objectInfos.size(), [&](const size_t i) {
+                if (auto* brushInfo = std::get_if<BrushInfo>(&objectInfos[i]); brushInfo && !brushInfo->brush) {
+                    brushInfo->brush = Model::Brush::create(m_worldBounds, std::move(brushInfo->faces));
+                }
+            });
+        }
+
         // implement MapParser interface
 
         void MapReader::onBeginEntity(const size_t /* line */, std::vector<Model::EntityProperty> properties, ParserStatus& /* status */) {
@@ -92,7 +126,7 @@ namespace TrenchBroom {
         }
 
         void MapReader::onBeginBrush(const size_t /* line */, ParserStatus& /* status */) {
-            m_objectInfos.push_back(BrushInfo{{}, 0, 0, m_currentEntityInfo});
+            m_objectInfos.push_back(BrushInfo{{}, 0, 0, m_currentEntityInfo, std::nullopt});
         }
 
         void MapReader::onEndBrush(const size_t startLine, const size_t lineCount, ParserStatus& /* status */) {
@@ -128,7 +162,202 @@ namespace TrenchBroom {
         }
 
         // helper methods
-        
+
+        namespace {
+            /**
+             * The result of parsing a single chunk.
+             */
+            struct ChunkResult {
+                /**
+                 * A property of the entity continued from the previous chunk, which is a duplicate if its key was
+                 * already used in a previous chunk. The warning for a duplicate must be logged before the message with
+                 * the given index.
+                 */
+                struct ContinuedEntityProperty {
+                    std::string key;
+                    size_t line;
+                    size_t column;
+                    size_t messageIndex;
+                };
+
+                std::vector<MapReader::ObjectInfo> objectInfos;
+                /** The index of the entity that is still open at the end of the chunk, if any. */
+                std::optional<size_t> openEntityInfo;
+                std::vector<std::string> openEntityPropertyKeys;
+                std::vector<ContinuedEntityProperty> continuedEntityProperties;
+                BufferedParserStatus::Messages messages;
+                bool success = false;
+            };
+        }
+
+        /**
+         * Parses a chunk of the input and records the object infos.
+         *
+         * If the chunk begins in the body of an entity, the object infos begin with a placeholder entity info that
+         * represents that entity. It receives the entity's start line and line count if the entity ends in this chunk.
+         */
+        class MapReader::ChunkReader : public MapReader {
+        private:
+            BufferedParserStatus m_status;
+            std::vector<ChunkResult::ContinuedEntityProperty> m_continuedEntityProperties;
+        public:
+            ChunkReader(const Chunk& chunk, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) :
+            MapReader(chunk, sourceMapFormat, targetMapFormat) {}
+
+            ChunkResult read(const std::optional<size_t> entityLine) {
+                auto result = ChunkResult{};
+
+                if (entityLine) {
+                    m_objectInfos.push_back(EntityInfo{{}, 0, 0});
+                    m_currentEntityInfo = 0u;
+                }
+
+                try {
+                    parseEntityChunk(entityLine, m_status);
+                    result.objectInfos = std::move(m_objectInfos);
+                    result.openEntityInfo = m_currentEntityInfo;
+                    if (m_currentEntityInfo) {
+                        result.openEntityPropertyKeys = openEntityPropertyKeys();
+                    }
+                    result.continuedEntityProperties = std::move(m_continuedEntityProperties);
+                    result.messages = m_status.takeMessages();
+                    result.success = true;
+                } catch (const ParserException&) {
+                    // the input will be parsed again sequentially to report the error
+                }
+
+                return result;
+            }
+        private:
+            void onContinuedEntityProperty(const std::string& key, const size_t line, const size_t column, ParserStatus&) override {
+                m_continuedEntityProperties.push_back({key, line, column, m_status.messages().size()});
+            }
+
+            Model::Node* onWorldNode(std::unique_ptr<Model::WorldNode>, ParserStatus&) override {
+                return nullptr;
+            }
+
+            void onLayerNode(std::unique_ptr<Model::Node>, ParserStatus&) override {}
+            void onNode(Model::Node*, std::unique_ptr<Model::Node>, ParserStatus&) override {}
+        };
+
+        /**
+         * Splits the input into chunks and parses them in parallel. The object infos of the chunks are then appended
+         * to m_objectInfos in the order of the chunks, and their parent indices are adjusted accordingly.
+         *
+         * Returns false if the input was not split or if any chunk could not be parsed. In that case, m_objectInfos
+         * is not modified and the caller must parse the input sequentially.
+         */
+        bool MapReader::parseEntitiesInParallel(ParserStatus& status) {
+            if (m_parallelChunkSize == 0u) {
+                return false;
+            }
+
+            const auto chunks = splitIntoChunks(m_str, m_parallelChunkSize);
+            if (chunks.size() < 2u) {
+                return false;
+            }
+
+            const auto callingThread = std::this_thread::get_id();
+            auto parsedBytes = std::atomic<size_t>{0u};
+
+            auto chunkResults = std::vector<ChunkResult>(chunks.size());
+            kdl::parallel_for(chunks.size(), [&](const size_t i) {
+                auto reader = ChunkReader{chunks[i], m_sourceMapFormat, m_targetMapFormat};
+                chunkResults[i] = reader.read(chunks[i].entityLine);
+
+                const auto chunkSize = chunks[i].str.size();
+                const auto totalParsedBytes = parsedBytes.fetch_add(chunkSize) + chunkSize;
+                // the parser status may only be used by the calling thread
+                if (std::this_thread::get_id() == callingThread) {
+                    status.progress(static_cast<double>(totalParsedBytes) / static_cast<double>(m_str.size()));
+                }
+            }, 1u);
+
+            // check that all chunks were parsed and that they fit together
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                const auto& chunkResult = chunkResults[i];
+                if (!chunkResult.success) {
+                    return false;
+                }
+
+                const auto previousEntityIsOpen = i > 0u && chunkResults[i-1u].openEntityInfo.has_value();
+                if (previousEntityIsOpen != chunks[i].entityLine.has_value()) {
+                    return false;
+                }
+            }
+
+            auto objectInfos = std::vector<ObjectInfo>{};
+            auto openEntityInfo = std::optional<size_t>{};
+            auto openEntityPropertyKeys = std::unordered_set<std::string>{};
+
+            for (auto& chunkResult : chunkResults) {
+                const auto firstIndex = objectInfos.size();
+                const auto continuesEntity = openEntityInfo.has_value();
+                const auto toGlobalIndex = [&](const size_t localIndex) {
+                    if (continuesEntity) {
+                        return localIndex == 0u ? *openEntityInfo : firstIndex + localIndex - 1u;
+                    }
+                    return firstIndex + localIndex;
+                };
+
+                for (size_t i = 0; i < chunkResult.objectInfos.size(); ++i) {
+                    auto& objectInfo = chunkResult.objectInfos[i];
+                    if (continuesEntity && i == 0u) {
+                        // placeholder for the open entity, transfer its position if the entity ended in this chunk
+                        if (!chunkResult.openEntityInfo || *chunkResult.openEntityInfo != 0u) {
+                            const auto& placeholder = std::get<EntityInfo>(objectInfo);
+                            auto& entityInfo = std::get<EntityInfo>(objectInfos[*openEntityInfo]);
+                            entityInfo.startLine = placeholder.startLine;
+                            entityInfo.lineCount = placeholder.lineCount;
+                        }
+                        continue;
+                    }
+
+                    std::visit(kdl::overload(
+                        [](EntityInfo&) {},
+                        [&](BrushInfo& brushInfo) {
+                            if (brushInfo.parentIndex) {
+                                brushInfo.parentIndex = toGlobalIndex(*brushInfo.parentIndex);
+                            }
+                        },
+                        [&](PatchInfo& patchInfo) {
+                            if (patchInfo.parentIndex) {
+                                patchInfo.parentIndex = toGlobalIndex(*patchInfo.parentIndex);
+                            }
+                        }
+                    ), objectInfo);
+                    objectInfos.push_back(std::move(objectInfo));
+                }
+
+                // log the messages, and check the properties of the continued entity against its keys from the
+                // previous chunks in the same order as the sequential parser would
+                auto continuedEntityProperty = std::begin(chunkResult.continuedEntityProperties);
+                for (size_t i = 0; i <= chunkResult.messages.size(); ++i) {
+                    for (; continuedEntityProperty != std::end(chunkResult.continuedEntityProperties) && continuedEntityProperty->messageIndex == i; ++continuedEntityProperty) {
+                        if (!openEntityPropertyKeys.insert(continuedEntityProperty->key).second) {
+                            status.warn(continuedEntityProperty->line, continuedEntityProperty->column, "Ignoring duplicate entity property '" + continuedEntityProperty->key + "'");
+                        }
+                    }
+                    if (i < chunkResult.messages.size()) {
+                        const auto& [level, message] = chunkResult.messages[i];
+                        status.logFormatted(level, message);
+                    }
+                }
+
+                if (!chunkResult.openEntityInfo) {
+                    openEntityPropertyKeys.clear();
+                } else if (!continuesEntity || *chunkResult.openEntityInfo != 0u) {
+                    openEntityPropertyKeys = std::unordered_set<std::string>(std::begin(chunkResult.openEntityPropertyKeys), std::end(chunkResult.openEntityPropertyKeys));
+                }
+                openEntityInfo = chunkResult.openEntityInfo ? std::optional<size_t>{toGlobalIndex(*chunkResult.openEntityInfo)} : std::nullopt;
+            }
+
+            m_objectInfos = std::move(objectInfos);
+            m_currentEntityInfo = openEntityInfo;
+            return true;
+        }
+
         namespace {
             /** The type of a node's container. */
             enum class ContainerType {
@@ -413,7 +642,8 @@ namespace TrenchBroom {
          * Creates a brush node from the given brush info. Returns an error if the brush could not be created.
          */
         static CreateNodeResult createBrushNode(MapReader::BrushInfo brushInfo, const vm::bbox3& worldBounds) {
-            return Model::Brush::create(worldBounds, std::move(brushInfo.faces))
+            auto brush = brushInfo.brush ? std::move(*brushInfo.brush) : Model::Brush::create(worldBounds, std::move(brushInfo.faces));
+            return std::move(brush)
                 .and_then([&](Model::Brush&& brush) {
                     auto brushNode = std::make_unique<Model::BrushNode>(std::move(brush));
                     brushNode->setFilePosition(brushInfo.startLine, brushInfo.lineCount);
@@ -683,6 +913,8 @@ namespace TrenchBroom {
             }
         }
 
+        void MapReader::onObjectInfos(std::vector<ObjectInfo>& /* objectInfos */, ParserStatus& /* status */) {}
+
         /**
          * Default implementation adds it to the current BrushInfo
          * Overridden in BrushFaceReader (which doesn't use m_brushInfos) to collect the faces directly
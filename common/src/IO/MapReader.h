@@ -81,6 +81,12 @@ namespace TrenchBroom {
                 size_t startLine;
                 size_t lineCount;
                 std::optional<size_t> parentIndex;
+                /**
+                 * The brush created from the faces, or the error that prevented its creation. If set, the faces have
+                 * been consumed. Set by createBrushes or when the brush was restored from a snapshot, otherwise the
+                 * brush is created together with its node.
+                 */
+                std::optional<kdl::result<Model::Brush, Model::BrushError>> brush;
             };
 
             struct PatchInfo {
@@ -94,7 +100,17 @@ namespace TrenchBroom {
             };
 
             using ObjectInfo = std::variant<EntityInfo, BrushInfo, PatchInfo>;
+
+            /**
+             * The default approximate size in bytes of the chunks that the input is split into when parsing entities
+             * in parallel.
+             */
+            static constexpr size_t DefaultParallelChunkSize = 512u * 1024u;
         private:
+            class ChunkReader;
+
+            std::string_view m_str;
+            size_t m_parallelChunkSize;
             vm::bbox3 m_worldBounds;
         private: // data populated in response to MapParser callbacks
             std::vector<ObjectInfo> m_objectInfos;
@@ -110,9 +126,24 @@ namespace TrenchBroom {
              */
             MapReader(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat);
 
+            /**
+             * Creates a new reader for the given chunk of the input.
+             */
+            MapReader(const Chunk& chunk, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat);
+        public:
+            /**
+             * Sets the approximate size in bytes of the chunks that the input is split into by readEntities. The
+             * chunks are tokenized and parsed in parallel. Pass 0 to parse the input sequentially.
+             */
+            void setParallelChunkSize(size_t parallelChunkSize);
+        protected:
             /**
              * Attempts to parse as one or more entities.
              *
+             * If the input is larger than the parallel chunk size, it is split into chunks which are parsed in
+             * parallel. Should that fail, the entire input is parsed again sequentially so that errors are reported
+             * in the same way.
+             *
              * @throws ParserException if parsing fails
              */
             void readEntities(const vm::bbox3& worldBounds, ParserStatus& status);
@@ -128,6 +159,15 @@ namespace TrenchBroom {
              * @throws ParserException if parsing fails
              */
             void readBrushFaces(const vm::bbox3& worldBounds, ParserStatus& status);
+            /**
+             * Creates nodes from the given objects instead of parsing the input, e.g. when the objects were restored
+             * from a snapshot that was recorded in onObjectInfos.
+             */
+            void readObjectInfos(std::vector<ObjectInfo> objectInfos, const vm::bbox3& worldBounds, ParserStatus& status);
+            /**
+             * Creates the brushes of the given brush infos in parallel, see BrushInfo::brush.
+             */
+            void createBrushes(std::vector<ObjectInfo>& objectInfos) const;
         protected: // implement MapParser interface
             void onBeginEntity(size_t line, std::vector<Model::EntityProperty> properties, ParserStatus& status) override;
             void onEndEntity(size_t startLine, size_t lineCount, ParserStatus& status) override;
@@ -137,8 +177,16 @@ namespace TrenchBroom {
             void onValveBrushFace(size_t line, Model::MapFormat targetMapFormat, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, ParserStatus& status) override;
             void onPatch(size_t startLine, size_t lineCount, Model::MapFormat targetMapFormat, size_t rowCount, size_t columnCount, std::vector<vm::vec<FloatType, 5>> controlPoints, std::string textureName, ParserStatus& status) override;
         private: // helper methods
+            bool parseEntitiesInParallel(ParserStatus& status);
             void createNodes(ParserStatus& status);
         private: // subclassing interface - these will be called in the order that nodes should be inserted
+            /**
+             * Called by readEntities with the raw data of all parsed objects before any nodes are created from it.
+             * Implementations may create the brushes in advance using createBrushes. The default implementation does
+             * nothing.
+             */
+            virtual void onObjectInfos(std::vector<ObjectInfo>& objectInfos, ParserStatus& status);
+
             /**
              * Called for the first worldspawn entity. Subclasses cannot capture the given world node but must
              * create their own instead.
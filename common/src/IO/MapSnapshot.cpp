@@ -0,0 +1,518 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapSnapshot.h"
+
+#include "Color.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "Model/Brush.h"
+#include "Model/BrushError.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/EntityProperties.h"
+#include "Model/MapFormat.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
+
+#include <kdl/hash_utils.h>
+#include <kdl/overload.h>
+#include <kdl/parallel.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const char SnapshotMagic[] = { 'T', 'B', 'M', 'S' };
+        // increment whenever the layout of the snapshot or of the parsed objects changes
+        static const uint32_t SnapshotVersion = 2u;
+
+        static const uint8_t EntityTag = 0u;
+        static const uint8_t BrushTag = 1u;
+        static const uint8_t PatchTag = 2u;
+
+        static const uint8_t BrushFacesTag = 0u;
+        static const uint8_t BrushGeometryTag = 1u;
+        static const uint8_t BrushErrorTag = 2u;
+
+        static const uint8_t ParaxialTexCoordSystemTag = 0u;
+        static const uint8_t ParallelTexCoordSystemTag = 1u;
+
+        uint64_t computeMapSnapshotKey(const std::string_view str, const std::string_view gameConfig, const std::vector<Model::MapFormat>& formats, const vm::bbox3& worldBounds) {
+            // the block size must not depend on the number of threads so that the key is stable
+            static const size_t blockSize = 1024u * 1024u;
+
+            const auto blockCount = (str.size() + blockSize - 1u) / blockSize;
+            auto blockHashes = std::vector<uint64_t>(blockCount);
+            kdl::parallel_for(blockCount, [&](const size_t i) {
+                const auto* begin = str.data() + i * blockSize;
+                const auto* end = str.data() + std::min((i + 1u) * blockSize, str.size());
+                blockHashes[i] = kdl::hash_bytes(kdl::hash_offset_basis, begin, end);
+            }, 1u);
+
+            auto key = kdl::hash_value(kdl::hash_offset_basis, SnapshotVersion);
+            key = kdl::hash_value(key, static_cast<uint64_t>(str.size()));
+            for (const auto blockHash : blockHashes) {
+                key = kdl::hash_value(key, blockHash);
+            }
+            key = kdl::hash_string(key, gameConfig);
+            key = kdl::hash_value(key, static_cast<uint64_t>(formats.size()));
+            for (const auto format : formats) {
+                key = kdl::hash_value(key, static_cast<int>(format));
+            }
+            // the brush geometry depends on the world bounds
+            key = kdl::hash_value(key, worldBounds);
+            return key;
+        }
+
+        Path mapSnapshotPath(const Path& mapPath) {
+            return mapPath.addExtension("tbcache");
+        }
+
+        // writing
+
+        template <typename T>
+        static void writeValue(std::string& out, const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static void writeSize(std::string& out, const size_t value) {
+            writeValue(out, static_cast<uint64_t>(value));
+        }
+
+        static void writeString(std::string& out, const std::string& str) {
+            writeSize(out, str.size());
+            out.append(str);
+        }
+
+        static void writeOptionalSize(std::string& out, const std::optional<size_t>& value) {
+            writeValue(out, static_cast<uint8_t>(value ? 1u : 0u));
+            writeSize(out, value.value_or(0u));
+        }
+
+        template <typename T, size_t S>
+        static void writeVec(std::string& out, const vm::vec<T, S>& vec) {
+            for (size_t i = 0; i < S; ++i) {
+                writeValue(out, vec[i]);
+            }
+        }
+
+        static void writeAttributes(std::string& out, const Model::BrushFaceAttributes& attributes) {
+            writeString(out, attributes.textureName());
+            writeVec(out, attributes.offset());
+            writeVec(out, attributes.scale());
+            writeValue(out, attributes.rotation());
+            writeValue(out, static_cast<int32_t>(attributes.surfaceContents()));
+            writeValue(out, static_cast<int32_t>(attributes.surfaceFlags()));
+            writeValue(out, attributes.surfaceValue());
+            writeVec(out, static_cast<const vm::vec<float, 4>&>(attributes.color()));
+        }
+
+        static void writeFace(std::string& out, const Model::BrushFace& face) {
+            for (const auto& point : face.points()) {
+                writeVec(out, point);
+            }
+            writeVec(out, face.boundary().normal);
+            writeValue(out, face.boundary().distance);
+            writeAttributes(out, face.attributes());
+
+            const auto& texCoordSystem = face.texCoordSystem();
+            if (dynamic_cast<const Model::ParallelTexCoordSystem*>(&texCoordSystem)) {
+                writeValue(out, ParallelTexCoordSystemTag);
+                writeVec(out, texCoordSystem.xAxis());
+                writeVec(out, texCoordSystem.yAxis());
+            } else {
+                // paraxial texture coordinate systems are fully determined by the face points and attributes
+                writeValue(out, ParaxialTexCoordSystemTag);
+            }
+            writeSize(out, face.lineNumber());
+        }
+
+        static void writeFaces(std::string& out, const std::vector<Model::BrushFace>& faces) {
+            writeSize(out, faces.size());
+            for (const auto& face : faces) {
+                writeFace(out, face);
+            }
+        }
+
+        /**
+         * Writes the faces of the given brush followed by its geometry. The geometry is recorded as its vertex
+         * positions and the vertex indices of the boundary of every face, in the order of the brush faces. The face
+         * planes are the boundaries of the brush faces.
+         */
+        static void writeBrush(std::string& out, const Model::Brush& brush) {
+            writeFaces(out, brush.faces());
+
+            auto vertexIndices = std::unordered_map<const Model::BrushVertex*, size_t>{};
+            vertexIndices.reserve(brush.vertexCount());
+            writeSize(out, brush.vertexCount());
+            for (const auto* vertex : brush.vertices()) {
+                vertexIndices.emplace(vertex, vertexIndices.size());
+                writeVec(out, vertex->position());
+            }
+
+            for (const auto& face : brush.faces()) {
+                const auto& boundary = face.geometry()->boundary();
+                writeSize(out, boundary.size());
+                for (const auto* halfEdge : boundary) {
+                    writeSize(out, vertexIndices.at(halfEdge->origin()));
+                }
+            }
+        }
+
+        std::string writeMapSnapshot(const uint64_t key, const Model::MapFormat format, const std::vector<MapReader::ObjectInfo>& objectInfos) {
+            auto out = std::string{};
+            out.append(SnapshotMagic, sizeof(SnapshotMagic));
+            writeValue(out, SnapshotVersion);
+            writeValue(out, key);
+            writeValue(out, static_cast<int32_t>(format));
+            writeSize(out, objectInfos.size());
+
+            for (const auto& objectInfo : objectInfos) {
+                std::visit(kdl::overload(
+                    [&](const MapReader::EntityInfo& entityInfo) {
+                        writeValue(out, EntityTag);
+                        writeSize(out, entityInfo.startLine);
+                        writeSize(out, entityInfo.lineCount);
+                        writeSize(out, entityInfo.properties.size());
+                        for (const auto& property : entityInfo.properties) {
+                            writeString(out, property.key());
+                            writeString(out, property.value());
+                        }
+                    },
+                    [&](const MapReader::BrushInfo& brushInfo) {
+                        writeValue(out, BrushTag);
+                        writeSize(out, brushInfo.startLine);
+                        writeSize(out, brushInfo.lineCount);
+                        writeOptionalSize(out, brushInfo.parentIndex);
+                        if (!brushInfo.brush) {
+                            writeValue(out, BrushFacesTag);
+                            writeFaces(out, brushInfo.faces);
+                        } else {
+                            brushInfo.brush->visit(kdl::overload(
+                                [&](const Model::Brush& brush) {
+                                    writeValue(out, BrushGeometryTag);
+                                    writeBrush(out, brush);
+                                },
+                                [&](const Model::BrushError error) {
+                                    writeValue(out, BrushErrorTag);
+                                    writeValue(out, static_cast<int32_t>(error));
+                                }
+                            ));
+                        }
+                    },
+                    [&](const MapReader::PatchInfo& patchInfo) {
+                        writeValue(out, PatchTag);
+                        writeSize(out, patchInfo.startLine);
+                        writeSize(out, patchInfo.lineCount);
+                        writeOptionalSize(out, patchInfo.parentIndex);
+                        writeSize(out, patchInfo.rowCount);
+                        writeSize(out, patchInfo.columnCount);
+                        writeSize(out, patchInfo.controlPoints.size());
+                        for (const auto& controlPoint : patchInfo.controlPoints) {
+                            writeVec(out, controlPoint);
+                        }
+                        writeString(out, patchInfo.textureName);
+                    }
+                ), objectInfo);
+            }
+
+            return out;
+        }
+
+        // reading
+
+        template <typename T>
+        static T readValue(Reader& reader) {
+            return reader.read<T, T>();
+        }
+
+        static size_t readSize(Reader& reader) {
+            const auto value = readValue<uint64_t>(reader);
+            // a count can never exceed the remaining data, this also protects us from huge allocations
+            if (value > reader.size()) {
+                throw ReaderException("Invalid size in map snapshot");
+            }
+            return static_cast<size_t>(value);
+        }
+
+        static size_t readLine(Reader& reader) {
+            return static_cast<size_t>(readValue<uint64_t>(reader));
+        }
+
+        static std::string readString(Reader& reader) {
+            auto result = std::string(readSize(reader), '\0');
+            reader.read(result.data(), result.size());
+            return result;
+        }
+
+        static std::optional<size_t> readOptionalSize(Reader& reader) {
+            const auto hasValue = readValue<uint8_t>(reader) != 0u;
+            const auto value = readLine(reader);
+            return hasValue ? std::optional<size_t>{value} : std::nullopt;
+        }
+
+        template <typename T, size_t S>
+        static vm::vec<T, S> readVec(Reader& reader) {
+            return reader.readVec<T, S>();
+        }
+
+        static Model::BrushFaceAttributes readAttributes(Reader& reader) {
+            auto attributes = Model::BrushFaceAttributes{readString(reader)};
+            attributes.setOffset(readVec<float, 2>(reader));
+            attributes.setScale(readVec<float, 2>(reader));
+            attributes.setRotation(readValue<float>(reader));
+            attributes.setSurfaceContents(static_cast<int>(readValue<int32_t>(reader)));
+            attributes.setSurfaceFlags(static_cast<int>(readValue<int32_t>(reader)));
+            attributes.setSurfaceValue(readValue<float>(reader));
+            attributes.setColor(Color{readVec<float, 4>(reader)});
+            return attributes;
+        }
+
+        static Model::BrushFace readFace(Reader& reader) {
+            auto points = Model::BrushFace::Points{};
+            for (auto& point : points) {
+                point = readVec<FloatType, 3>(reader);
+            }
+            const auto normal = readVec<FloatType, 3>(reader);
+            const auto distance = readValue<FloatType>(reader);
+            const auto attributes = readAttributes(reader);
+
+            auto texCoordSystem = std::unique_ptr<Model::TexCoordSystem>{};
+            switch (readValue<uint8_t>(reader)) {
+                case ParaxialTexCoordSystemTag:
+                    texCoordSystem = std::make_unique<Model::ParaxialTexCoordSystem>(points[0], points[1], points[2], attributes);
+                    break;
+                case ParallelTexCoordSystemTag: {
+                    const auto xAxis = readVec<FloatType, 3>(reader);
+                    const auto yAxis = readVec<FloatType, 3>(reader);
+                    texCoordSystem = std::make_unique<Model::ParallelTexCoordSystem>(xAxis, yAxis);
+                    break;
+                }
+                default:
+                    throw ReaderException("Invalid texture coordinate system in map snapshot");
+            }
+
+            auto face = Model::BrushFace{points, vm::plane3{distance, normal}, attributes, std::move(texCoordSystem)};
+            face.setFilePosition(readLine(reader), 1u);
+            return face;
+        }
+
+        static std::vector<Model::BrushFace> readFaces(Reader& reader) {
+            const auto faceCount = readSize(reader);
+            auto faces = std::vector<Model::BrushFace>{};
+            faces.reserve(faceCount);
+            for (size_t i = 0; i < faceCount; ++i) {
+                faces.push_back(readFace(reader));
+            }
+            return faces;
+        }
+
+        /**
+         * Reads a brush written by writeBrush. Since the polyhedron is restored without any checks, its topology is
+         * validated here so that a corrupt snapshot cannot produce a broken polyhedron.
+         */
+        static Model::Brush readBrush(Reader& reader) {
+            auto faces = readFaces(reader);
+
+            const auto vertexCount = readSize(reader);
+            auto positions = std::vector<vm::vec3>{};
+            positions.reserve(vertexCount);
+            for (size_t i = 0; i < vertexCount; ++i) {
+                positions.push_back(readVec<FloatType, 3>(reader));
+            }
+
+            auto faceVertices = std::vector<std::vector<size_t>>{};
+            faceVertices.reserve(faces.size());
+            auto halfEdges = std::unordered_set<uint64_t>{};
+            for (size_t i = 0; i < faces.size(); ++i) {
+                const auto boundarySize = readSize(reader);
+                if (boundarySize < 3u) {
+                    throw ReaderException("Invalid brush face in map snapshot");
+                }
+
+                auto& vertexIndices = faceVertices.emplace_back();
+                vertexIndices.reserve(boundarySize);
+                for (size_t j = 0; j < boundarySize; ++j) {
+                    const auto vertexIndex = readSize(reader);
+                    if (vertexIndex >= vertexCount) {
+                        throw ReaderException("Invalid brush vertex index in map snapshot");
+                    }
+                    vertexIndices.push_back(vertexIndex);
+                }
+
+                for (size_t j = 0; j < boundarySize; ++j) {
+                    const auto origin = static_cast<uint64_t>(vertexIndices[j]);
+                    const auto destination = static_cast<uint64_t>(vertexIndices[(j + 1u) % boundarySize]);
+                    if (origin == destination || !halfEdges.insert(origin * vertexCount + destination).second) {
+                        throw ReaderException("Invalid brush geometry in map snapshot");
+                    }
+                }
+            }
+
+            // every half edge must have a twin
+            for (const auto halfEdge : halfEdges) {
+                const auto origin = halfEdge / vertexCount;
+                const auto destination = halfEdge % vertexCount;
+                if (halfEdges.count(destination * vertexCount + origin) == 0u) {
+                    throw ReaderException("Invalid brush geometry in map snapshot");
+                }
+            }
+
+            const auto facePlanes = kdl::vec_transform(faces, [](const auto& face) { return face.boundary(); });
+            auto geometry = Model::BrushGeometry{positions, faceVertices, facePlanes};
+            auto brush = Model::Brush::createWithGeometry(std::move(faces), std::move(geometry));
+            if (brush.is_error()) {
+                throw ReaderException("Invalid brush geometry in map snapshot");
+            }
+            return std::move(brush).value();
+        }
+
+        static MapReader::ObjectInfo readObjectInfo(Reader& reader) {
+            switch (readValue<uint8_t>(reader)) {
+                case EntityTag: {
+                    auto entityInfo = MapReader::EntityInfo{};
+                    entityInfo.startLine = readLine(reader);
+                    entityInfo.lineCount = readLine(reader);
+
+                    const auto propertyCount = readSize(reader);
+                    entityInfo.properties.reserve(propertyCount);
+                    for (size_t i = 0; i < propertyCount; ++i) {
+                        auto key = readString(reader);
+                        auto value = readString(reader);
+                        entityInfo.properties.emplace_back(key, value);
+                    }
+                    return entityInfo;
+                }
+                case BrushTag: {
+                    auto brushInfo = MapReader::BrushInfo{};
+                    brushInfo.startLine = readLine(reader);
+                    brushInfo.lineCount = readLine(reader);
+                    brushInfo.parentIndex = readOptionalSize(reader);
+
+                    switch (readValue<uint8_t>(reader)) {
+                        case BrushFacesTag:
+                            brushInfo.faces = readFaces(reader);
+                            break;
+                        case BrushGeometryTag:
+                            brushInfo.brush = readBrush(reader);
+                            break;
+                        case BrushErrorTag: {
+                            const auto error = readValue<int32_t>(reader);
+                            if (error < 0 || error > static_cast<int32_t>(Model::BrushError::InvalidFace)) {
+                                throw ReaderException("Invalid brush error in map snapshot");
+                            }
+                            brushInfo.brush = static_cast<Model::BrushError>(error);
+                            break;
+                        }
+                        default:
+                            throw ReaderException("Invalid brush in map snapshot");
+                    }
+                    return brushInfo;
+                }
+                case PatchTag: {
+                    auto patchInfo = MapReader::PatchInfo{};
+                    patchInfo.startLine = readLine(reader);
+                    patchInfo.lineCount = readLine(reader);
+                    patchInfo.parentIndex = readOptionalSize(reader);
+                    patchInfo.rowCount = readSize(reader);
+                    patchInfo.columnCount = readSize(reader);
+
+                    const auto controlPointCount = readSize(reader);
+                    patchInfo.controlPoints.reserve(controlPointCount);
+                    for (size_t i = 0; i < controlPointCount; ++i) {
+                        patchInfo.controlPoints.push_back(readVec<FloatType, 5>(reader));
+                    }
+                    patchInfo.textureName = readString(reader);
+                    return patchInfo;
+                }
+                default:
+                    throw ReaderException("Invalid object type in map snapshot");
+            }
+        }
+
+        static Model::MapFormat readMapFormat(Reader& reader) {
+            const auto format = readValue<int32_t>(reader);
+            if (format <= static_cast<int32_t>(Model::MapFormat::Unknown) || format > static_cast<int32_t>(Model::MapFormat::Quake3)) {
+                throw ReaderException("Invalid map format in map snapshot");
+            }
+            return static_cast<Model::MapFormat>(format);
+        }
+
+        static const std::optional<size_t>& parentIndex(const MapReader::ObjectInfo& objectInfo) {
+            static const auto noParent = std::optional<size_t>{};
+            return std::visit(kdl::overload(
+                [](const MapReader::EntityInfo&) -> const std::optional<size_t>& { return noParent; },
+                [](const MapReader::BrushInfo& brushInfo) -> const std::optional<size_t>& { return brushInfo.parentIndex; },
+                [](const MapReader::PatchInfo& patchInfo) -> const std::optional<size_t>& { return patchInfo.parentIndex; }
+            ), objectInfo);
+        }
+
+        std::optional<MapSnapshot> readMapSnapshot(const std::string_view data, const uint64_t key) {
+            try {
+                auto reader = Reader::from(data.data(), data.data() + data.size());
+
+                char magic[sizeof(SnapshotMagic)];
+                reader.read(magic, sizeof(magic));
+                if (std::memcmp(magic, SnapshotMagic, sizeof(magic)) != 0
+                    || readValue<uint32_t>(reader) != SnapshotVersion
+                    || readValue<uint64_t>(reader) != key) {
+                    return std::nullopt;
+                }
+
+                auto snapshot = MapSnapshot{};
+                snapshot.format = readMapFormat(reader);
+
+                const auto objectCount = readSize(reader);
+                snapshot.objectInfos.reserve(objectCount);
+                for (size_t i = 0; i < objectCount; ++i) {
+                    auto objectInfo = readObjectInfo(reader);
+
+                    // the nodes are created by indexing the object infos with the parent index
+                    if (const auto& index = parentIndex(objectInfo);
+                        index && (*index >= i || !std::holds_alternative<MapReader::EntityInfo>(snapshot.objectInfos[*index]))) {
+                        throw ReaderException("Invalid parent index in map snapshot");
+                    }
+                    snapshot.objectInfos.push_back(std::move(objectInfo));
+                }
+
+                if (!reader.eof()) {
+                    return std::nullopt;
+                }
+                return snapshot;
+            } catch (const ReaderException&) {
+                return std::nullopt;
+            }
+        }
+    }
+}
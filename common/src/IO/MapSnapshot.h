@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+#include "IO/MapReader.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        enum class MapFormat;
+    }
+
+    namespace IO {
+        class Path;
+
+        /**
+         * The objects that a MapReader parsed from a map file, restored from a binary snapshot.
+         *
+         * Restoring the objects from a snapshot is much faster than parsing the map file again. If the brushes were
+         * created before the snapshot was recorded, their geometry is restored, too, and only the nodes must still be
+         * created from the objects.
+         */
+        struct MapSnapshot {
+            Model::MapFormat format;
+            std::vector<MapReader::ObjectInfo> objectInfos;
+        };
+
+        /**
+         * Computes a key that identifies the given map file contents when they are parsed using the given game
+         * configuration, map formats and world bounds. The game configuration is given by the contents of its file so
+         * that changing it invalidates the snapshot. A snapshot is only restored if it was recorded with the same key.
+         *
+         * The contents are hashed in parallel.
+         */
+        uint64_t computeMapSnapshotKey(std::string_view str, std::string_view gameConfig, const std::vector<Model::MapFormat>& formats, const vm::bbox3& worldBounds);
+
+        /**
+         * Returns the path of the snapshot file that accompanies the map file at the given path.
+         */
+        Path mapSnapshotPath(const Path& mapPath);
+
+        /**
+         * Records a binary snapshot of the given objects. The snapshot is meant to be cached locally and uses the
+         * native byte order.
+         */
+        std::string writeMapSnapshot(uint64_t key, Model::MapFormat format, const std::vector<MapReader::ObjectInfo>& objectInfos);
+
+        /**
+         * Restores the objects from the given snapshot data.
+         *
+         * @return the restored objects or an empty optional if the given data is not a valid snapshot or if it was
+         * recorded with a different key
+         */
+        std::optional<MapSnapshot> readMapSnapshot(std::string_view data, uint64_t key);
+    }
+}
@@ -54,6 +54,12 @@ namespace TrenchBroom {
             void warn(const std::string& str);
             void error(const std::string& str);
             [[noreturn]] void errorAndThrow(const std::string& str);
+
+            /**
+             * Logs a message that already contains its position information, e.g. because it was recorded by another
+             * parser status. The prefix of this parser status is prepended to the message.
+             */
+            void logFormatted(LogLevel level, const std::string& str);
         private:
             void log(LogLevel level, size_t line, size_t column, const std::string& str);
             std::string buildMessage(size_t line, size_t column, const std::string& str) const;
@@ -0,0 +1,209 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Quake3ShaderCache.h"
+
+#include "Assets/Quake3Shader.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+
+#include <kdl/hash_utils.h>
+#include <kdl/parallel.h>
+
+#include <cstring>
+#include <type_traits>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const char CacheMagic[] = { 'T', 'B', 'S', 'C' };
+        // increment whenever the layout of the cache or of the shaders changes
+        static const uint32_t CacheVersion = 1u;
+
+        static uint64_t hashPath(const uint64_t hash, const Path& path) {
+            return kdl::hash_string(hash, path.asString("/"));
+        }
+
+        uint64_t computeQuake3ShaderCacheKey(const Path& shaderSearchPath, const std::vector<Path>& textureSearchPaths, const std::vector<std::tuple<Path, std::string_view>>& shaderFiles, const std::vector<Path>& textureImages) {
+            auto fileHashes = std::vector<uint64_t>(shaderFiles.size());
+            kdl::parallel_for(shaderFiles.size(), [&](const size_t i) {
+                const auto& [path, contents] = shaderFiles[i];
+                fileHashes[i] = kdl::hash_string(hashPath(kdl::hash_offset_basis, path), contents);
+            }, 1u);
+
+            auto key = kdl::hash_value(kdl::hash_offset_basis, CacheVersion);
+            key = hashPath(key, shaderSearchPath);
+            key = kdl::hash_value(key, static_cast<uint64_t>(textureSearchPaths.size()));
+            for (const auto& path : textureSearchPaths) {
+                key = hashPath(key, path);
+            }
+            key = kdl::hash_value(key, static_cast<uint64_t>(fileHashes.size()));
+            for (const auto fileHash : fileHashes) {
+                key = kdl::hash_value(key, fileHash);
+            }
+            key = kdl::hash_value(key, static_cast<uint64_t>(textureImages.size()));
+            for (const auto& path : textureImages) {
+                key = hashPath(key, path);
+            }
+            return key;
+        }
+
+        // writing
+
+        template <typename T>
+        static void writeValue(std::string& out, const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static void writeSize(std::string& out, const size_t value) {
+            writeValue(out, static_cast<uint64_t>(value));
+        }
+
+        static void writeString(std::string& out, const std::string& str) {
+            writeSize(out, str.size());
+            out.append(str);
+        }
+
+        static void writePath(std::string& out, const Path& path) {
+            writeString(out, path.asString("/"));
+        }
+
+        static void writeShader(std::string& out, const Assets::Quake3Shader& shader) {
+            writePath(out, shader.shaderPath);
+            writePath(out, shader.editorImage);
+            writePath(out, shader.lightImage);
+            writeValue(out, static_cast<int32_t>(shader.culling));
+
+            writeSize(out, shader.surfaceParms.size());
+            for (const auto& surfaceParm : shader.surfaceParms) {
+                writeString(out, surfaceParm);
+            }
+
+            writeSize(out, shader.stages.size());
+            for (const auto& stage : shader.stages) {
+                writePath(out, stage.map);
+                writeString(out, stage.blendFunc.srcFactor);
+                writeString(out, stage.blendFunc.destFactor);
+            }
+        }
+
+        std::string writeQuake3ShaderCache(const uint64_t key, const std::vector<Assets::Quake3Shader>& shaders) {
+            auto out = std::string{};
+            out.append(CacheMagic, sizeof(CacheMagic));
+            writeValue(out, CacheVersion);
+            writeValue(out, key);
+
+            writeSize(out, shaders.size());
+            for (const auto& shader : shaders) {
+                writeShader(out, shader);
+            }
+
+            return out;
+        }
+
+        // reading
+
+        template <typename T>
+        static T readValue(Reader& reader) {
+            return reader.read<T, T>();
+        }
+
+        static size_t readSize(Reader& reader) {
+            const auto value = readValue<uint64_t>(reader);
+            // a count can never exceed the remaining data, this also protects us from huge allocations
+            if (value > reader.size()) {
+                throw ReaderException("Invalid size in shader cache");
+            }
+            return static_cast<size_t>(value);
+        }
+
+        static std::string readString(Reader& reader) {
+            auto result = std::string(readSize(reader), '\0');
+            reader.read(result.data(), result.size());
+            return result;
+        }
+
+        static Path readPath(Reader& reader) {
+            return Path{readString(reader)};
+        }
+
+        static Assets::Quake3Shader::Culling readCulling(Reader& reader) {
+            const auto culling = static_cast<Assets::Quake3Shader::Culling>(readValue<int32_t>(reader));
+            if (culling != Assets::Quake3Shader::Culling::Front
+                && culling != Assets::Quake3Shader::Culling::Back
+                && culling != Assets::Quake3Shader::Culling::None) {
+                throw ReaderException("Invalid culling in shader cache");
+            }
+            return culling;
+        }
+
+        static Assets::Quake3Shader readShader(Reader& reader) {
+            auto shader = Assets::Quake3Shader{};
+            shader.shaderPath = readPath(reader);
+            shader.editorImage = readPath(reader);
+            shader.lightImage = readPath(reader);
+            shader.culling = readCulling(reader);
+
+            const auto surfaceParmCount = readSize(reader);
+            for (size_t i = 0; i < surfaceParmCount; ++i) {
+                shader.surfaceParms.insert(readString(reader));
+            }
+
+            const auto stageCount = readSize(reader);
+            shader.stages.reserve(stageCount);
+            for (size_t i = 0; i < stageCount; ++i) {
+                auto& stage = shader.addStage();
+                stage.map = readPath(reader);
+                stage.blendFunc.srcFactor = readString(reader);
+                stage.blendFunc.destFactor = readString(reader);
+            }
+
+            return shader;
+        }
+
+        std::optional<std::vector<Assets::Quake3Shader>> readQuake3ShaderCache(const std::string_view data, const uint64_t key) {
+            try {
+                auto reader = Reader::from(data.data(), data.data() + data.size());
+
+                char magic[sizeof(CacheMagic)];
+                reader.read(magic, sizeof(magic));
+                if (std::memcmp(magic, CacheMagic, sizeof(magic)) != 0
+                    || readValue<uint32_t>(reader) != CacheVersion
+                    || readValue<uint64_t>(reader) != key) {
+                    return std::nullopt;
+                }
+
+                const auto shaderCount = readSize(reader);
+                auto shaders = std::vector<Assets::Quake3Shader>{};
+                shaders.reserve(shaderCount);
+                for (size_t i = 0; i < shaderCount; ++i) {
+                    shaders.push_back(readShader(reader));
+                }
+
+                if (!reader.eof()) {
+                    return std::nullopt;
+                }
+                return shaders;
+            } catch (const ReaderException&) {
+                return std::nullopt;
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Quake3Shader;
+    }
+
+    namespace IO {
+        class Path;
+
+        /**
+         * Computes a key that identifies the result of linking the given shader scripts with the given texture
+         * images. A cached shader table is only restored if it was recorded with the same key.
+         *
+         * @param shaderSearchPath the path at which the shader scripts were found
+         * @param textureSearchPaths the paths at which the texture images were found
+         * @param shaderFiles the paths and the contents of the shader scripts
+         * @param textureImages the paths of the texture images
+         */
+        uint64_t computeQuake3ShaderCacheKey(const Path& shaderSearchPath, const std::vector<Path>& textureSearchPaths, const std::vector<std::tuple<Path, std::string_view>>& shaderFiles, const std::vector<Path>& textureImages);
+
+        /**
+         * Records the given linked shaders. The data is meant to be cached locally and uses the native byte order.
+         */
+        std::string writeQuake3ShaderCache(uint64_t key, const std::vector<Assets::Quake3Shader>& shaders);
+
+        /**
+         * Restores the linked shaders from the given data.
+         *
+         * @return the shaders or an empty optional if the given data is not a valid shader cache or if it was recorded
+         * with a different key
+         */
+        std::optional<std::vector<Assets::Quake3Shader>> readQuake3ShaderCache(std::string_view data, uint64_t key);
+    }
+}
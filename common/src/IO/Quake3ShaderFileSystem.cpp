@@ -19,60 +19,162 @@
 
 #include "Quake3ShaderFileSystem.h"
 
+#include "Exceptions.h"
 #include "Logger.h"
 #include "Assets/Quake3Shader.h"
+#include "IO/BufferedParserStatus.h"
+#include "IO/DiskIO.h"
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
+#include "IO/IOUtils.h"
+#include "IO/Quake3ShaderCache.h"
 #include "IO/Quake3ShaderParser.h"
+#include "IO/Reader.h"
 #include "IO/SimpleParserStatus.h"
 
+#include <kdl/parallel.h>
+#include <kdl/string_compare.h>
 #include <kdl/vector_utils.h>
 
+#include <fstream>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        Quake3ShaderFileSystem::Quake3ShaderFileSystem(std::shared_ptr<FileSystem> fs, Path shaderSearchPath, std::vector<Path> textureSearchPaths, Logger& logger) :
+        Quake3ShaderFileSystem::Quake3ShaderFileSystem(std::shared_ptr<FileSystem> fs, Path shaderSearchPath, std::vector<Path> textureSearchPaths, Logger& logger, Path cachePath) :
         ImageFileSystemBase(std::move(fs), Path()),
         m_shaderSearchPath(std::move(shaderSearchPath)),
         m_textureSearchPaths(std::move(textureSearchPaths)),
+        m_cachePath(std::move(cachePath)),
         m_logger(logger) {
             initialize();
         }
 
         void Quake3ShaderFileSystem::doReadDirectory() {
-            if (hasNext()) {
-                auto shaders = loadShaders();
-                linkShaders(shaders);
+            if (!hasNext()) {
+                return;
+            }
+
+            auto files = std::vector<std::shared_ptr<File>>{};
+            if (next().directoryExists(m_shaderSearchPath)) {
+                for (const auto& path : next().findItems(m_shaderSearchPath, FileExtensionMatcher("shader"))) {
+                    files.push_back(next().openFile(path));
+                }
+            }
+            const auto textures = findTextures();
+
+            auto cacheKey = std::optional<uint64_t>{};
+            if (!m_cachePath.isEmpty()) {
+                auto readers = std::vector<BufferedReader>{};
+                auto shaderFiles = std::vector<std::tuple<Path, std::string_view>>{};
+                readers.reserve(files.size());
+                for (const auto& file : files) {
+                    readers.push_back(file->reader().buffer());
+                    shaderFiles.emplace_back(file->path(), readers.back().stringView());
+                }
+                cacheKey = computeQuake3ShaderCacheKey(m_shaderSearchPath, m_textureSearchPaths, shaderFiles, textures);
+
+                if (auto shaders = readCachedShaders(*cacheKey)) {
+                    m_logger.info() << "Restored " << shaders->size() << " linked shaders from cache";
+                    for (auto& shader : *shaders) {
+                        auto shaderPath = shader.shaderPath;
+                        addFile(shaderPath, std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, std::move(shader)));
+                    }
+                    return;
+                }
+            }
+
+            auto shaders = linkShaders(textures, loadShaders(files));
+            if (cacheKey) {
+                writeCachedShaders(*cacheKey, shaders);
+            }
+
+            for (auto& shader : shaders) {
+                auto shaderPath = shader.shaderPath;
+                addFile(shaderPath, std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, std::move(shader)));
             }
         }
 
-        std::vector<Assets::Quake3Shader> Quake3ShaderFileSystem::loadShaders() const {
-            auto result = std::vector<Assets::Quake3Shader>();
+        std::optional<std::vector<Assets::Quake3Shader>> Quake3ShaderFileSystem::readCachedShaders(const uint64_t key) const {
+            // problems with the cache are never fatal since the shaders can always be parsed instead
+            try {
+                if (Disk::fileExists(m_cachePath)) {
+                    const auto file = Disk::openFile(m_cachePath);
+                    const auto reader = file->reader().buffer();
+                    return readQuake3ShaderCache(reader.stringView(), key);
+                }
+            } catch (const Exception& e) {
+                m_logger.warn() << "Could not read shader cache " << m_cachePath << ": " << e.what();
+            }
+            return std::nullopt;
+        }
 
-            if (next().directoryExists(m_shaderSearchPath)) {
-                const auto paths = next().findItems(m_shaderSearchPath, FileExtensionMatcher("shader"));
-                for (const auto& path : paths) {
-                    const auto file = next().openFile(path);
-                    auto bufferedReader = file->reader().buffer();
-
-                    try {
-                        Quake3ShaderParser parser(bufferedReader.stringView());
-                        SimpleParserStatus status(m_logger, file->path().asString());
-                        result = kdl::vec_concat(std::move(result), parser.parse(status));
-                    } catch (const ParserException& e) {
-                        m_logger.warn() << "Skipping malformed shader file " << path << ": " << e.what();
+        void Quake3ShaderFileSystem::writeCachedShaders(const uint64_t key, const std::vector<Assets::Quake3Shader>& shaders) const {
+            try {
+                Disk::ensureDirectoryExists(m_cachePath.deleteLastComponent());
+
+                // write to a temporary file first so that a partially written cache is never read
+                const auto tempPath = m_cachePath.addExtension("tmp");
+                const auto data = writeQuake3ShaderCache(key, shaders);
+                {
+                    auto stream = openPathAsOutputStream(tempPath, std::ios::out | std::ios::binary);
+                    if (!stream || !stream.write(data.data(), static_cast<std::streamsize>(data.size())) || !stream.flush()) {
+                        m_logger.warn() << "Could not write shader cache " << m_cachePath;
+                        return;
                     }
                 }
+                Disk::moveFile(tempPath, m_cachePath, true);
+            } catch (const Exception& e) {
+                m_logger.warn() << "Could not write shader cache " << m_cachePath << ": " << e.what();
+            }
+        }
+
+        std::vector<Assets::Quake3Shader> Quake3ShaderFileSystem::loadShaders(const std::vector<std::shared_ptr<File>>& files) const {
+            struct ParseResult {
+                std::vector<Assets::Quake3Shader> shaders;
+                BufferedParserStatus::Messages messages;
+                std::optional<std::string> error;
+            };
+
+            // the shader scripts are independent of each other, so they can be parsed concurrently
+            auto results = std::vector<ParseResult>(files.size());
+            kdl::parallel_for(files.size(), [&](const size_t i) {
+                auto& result = results[i];
+                auto bufferedStatus = BufferedParserStatus{};
+                try {
+                    auto bufferedReader = files[i]->reader().buffer();
+                    Quake3ShaderParser parser(bufferedReader.stringView());
+                    result.shaders = parser.parse(bufferedStatus);
+                } catch (const ParserException& e) {
+                    result.error = e.what();
+                }
+                result.messages = bufferedStatus.takeMessages();
+            }, 1u);
+
+            // log the messages in the order of the files
+            auto shaders = std::vector<Assets::Quake3Shader>{};
+            for (size_t i = 0; i < files.size(); ++i) {
+                auto& result = results[i];
+                SimpleParserStatus status(m_logger, files[i]->path().asString());
+                logMessages(status, result.messages);
+
+                if (result.error) {
+                    m_logger.warn() << "Skipping malformed shader file " << files[i]->path() << ": " << *result.error;
+                } else {
+                    shaders = kdl::vec_concat(std::move(shaders), std::move(result.shaders));
+                }
             }
 
-            m_logger.info() << "Loaded " << result.size() << " shaders";
-            return result;
+            m_logger.info() << "Loaded " << shaders.size() << " shaders";
+            return shaders;
         }
 
-        void Quake3ShaderFileSystem::linkShaders(std::vector<Assets::Quake3Shader>& shaders) {
+        std::vector<Path> Quake3ShaderFileSystem::findTextures() const {
             const auto extensions = std::vector<std::string> { "tga", "png", "jpg", "jpeg" };
 
             auto allImages = std::vector<Path>();
@@ -81,52 +183,55 @@ namespace TrenchBroom {
                     allImages = kdl::vec_concat(std::move(allImages), next().findItemsRecursively(path, FileExtensionMatcher(extensions)));
                 }
             }
+            return allImages;
+        }
 
+        std::vector<Assets::Quake3Shader> Quake3ShaderFileSystem::linkShaders(const std::vector<Path>& textures, std::vector<Assets::Quake3Shader> shaders) const {
             m_logger.info() << "Linking shaders...";
-            linkTextures(allImages, shaders);
-            linkStandaloneShaders(shaders);
-        }
 
-        void Quake3ShaderFileSystem::linkTextures(const std::vector<Path>& textures, std::vector<Assets::Quake3Shader>& shaders) {
+            auto result = std::vector<Assets::Quake3Shader>{};
+            auto linkedPaths = std::set<Path, Path::Less<kdl::ci::string_less>>{};
+
+            // index the shaders by their paths, the first shader with a given path wins
+            auto shadersByPath = std::map<Path, size_t>{};
+            for (size_t i = 0; i < shaders.size(); ++i) {
+                shadersByPath.emplace(shaders[i].shaderPath, i);
+            }
+            auto linkedShaders = std::vector<bool>(shaders.size(), false);
+
             m_logger.debug() << "Linking textures...";
             for (const auto& texture : textures) {
                 const auto shaderPath = texture.deleteExtension();
 
                 // Only link a shader if it has not been linked yet.
-                if (!fileExists(shaderPath)) {
-                    const auto shaderIt = std::find_if(std::begin(shaders), std::end(shaders), [&shaderPath](const auto& shader){
-                        return shaderPath == shader.shaderPath;
-                    });
-
-                    if (shaderIt != std::end(shaders)) {
-                        // Found a matching shader.
-                        auto& shader = *shaderIt;
-
-                        auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, shader);
-                        m_root.addFile(shaderPath, shaderFile);
-
-                        // Remove the shader so that we don't revisit it when linking standalone shaders.
-                        shaders.erase(shaderIt);
+                if (linkedPaths.count(shaderPath) == 0u && !next().fileExists(shaderPath)) {
+                    linkedPaths.insert(shaderPath);
+
+                    const auto shaderIt = shadersByPath.find(shaderPath);
+                    if (shaderIt != std::end(shadersByPath)) {
+                        // Found a matching shader. Mark it so that we don't revisit it when linking standalone shaders.
+                        const auto shaderIndex = shaderIt->second;
+                        result.push_back(shaders[shaderIndex]);
+                        linkedShaders[shaderIndex] = true;
+                        shadersByPath.erase(shaderIt);
                     } else {
                         // No matching shader found, generate one.
                         auto shader = Assets::Quake3Shader();
                         shader.shaderPath = shaderPath;
                         shader.editorImage = texture;
-
-                        auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, std::move(shader));
-                        m_root.addFile(shaderPath, std::move(shaderFile));
+                        result.push_back(std::move(shader));
                     }
                 }
             }
-        }
 
-        void Quake3ShaderFileSystem::linkStandaloneShaders(std::vector<Assets::Quake3Shader>& shaders) {
             m_logger.debug() << "Linking standalone shaders...";
-            for (auto& shader : shaders) {
-                const auto& shaderPath = shader.shaderPath;
-                auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, shader);
-                m_root.addFile(shaderPath, std::move(shaderFile));
+            for (size_t i = 0; i < shaders.size(); ++i) {
+                if (!linkedShaders[i]) {
+                    result.push_back(std::move(shaders[i]));
+                }
             }
+
+            return result;
         }
     }
 }
@@ -21,6 +21,9 @@
 
 #include "IO/ImageFileSystem.h"
 
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom {
@@ -42,6 +45,7 @@ namespace TrenchBroom {
         private:
             Path m_shaderSearchPath;
             std::vector<Path> m_textureSearchPaths;
+            Path m_cachePath;
             Logger& m_logger;
         public:
             /**
@@ -50,19 +54,26 @@ namespace TrenchBroom {
              * paths are recursively searched for textures, and any texture found that does not have a corresponding
              * shader will have a shader generated for it.
              *
+             * If a cache path is given, the linked shaders are stored in a file at that path, and they are restored
+             * from that file instead of parsing and linking them again if neither the shader scripts nor the texture
+             * images have changed.
+             *
              * @param fs the filesystem to use when searching for shaders and linking image resources
              * @param shaderSearchPath the path at which to search for shader scripts
              * @param textureSearchPaths the paths at which to search for texture images
              * @param logger the logger to use
+             * @param cachePath the absolute path of the cache file, or an empty path to disable the cache
              */
-            Quake3ShaderFileSystem(std::shared_ptr<FileSystem> fs, Path shaderSearchPath, std::vector<Path> textureSearchPaths, Logger& logger);
+            Quake3ShaderFileSystem(std::shared_ptr<FileSystem> fs, Path shaderSearchPath, std::vector<Path> textureSearchPaths, Logger& logger, Path cachePath = Path());
         private:
             void doReadDirectory() override;
 
-            std::vector<Assets::Quake3Shader> loadShaders() const;
-            void linkShaders(std::vector<Assets::Quake3Shader>& shaders);
-            void linkTextures(const std::vector<Path>& textures, std::vector<Assets::Quake3Shader>& shaders);
-            void linkStandaloneShaders(std::vector<Assets::Quake3Shader>& shaders);
+            std::optional<std::vector<Assets::Quake3Shader>> readCachedShaders(uint64_t key) const;
+            void writeCachedShaders(uint64_t key, const std::vector<Assets::Quake3Shader>& shaders) const;
+
+            std::vector<Assets::Quake3Shader> loadShaders(const std::vector<std::shared_ptr<File>>& files) const;
+            std::vector<Path> findTextures() const;
+            std::vector<Assets::Quake3Shader> linkShaders(const std::vector<Path>& textures, std::vector<Assets::Quake3Shader> shaders) const;
         };
     }
 }
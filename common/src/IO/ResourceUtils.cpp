@@ -47,8 +47,8 @@
 namespace TrenchBroom {
     namespace IO {
         Assets::Texture loadDefaultTexture(const FileSystem& fs, Logger& logger, const std::string& name) {
-            // recursion guard
-            static bool executing = false;
+            // recursion guard, textures may be loaded on several threads at once
+            thread_local bool executing = false;
             if (!executing) {
                 const kdl::set_temp set_executing(executing);
                 
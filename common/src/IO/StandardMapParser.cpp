@@ -39,8 +39,8 @@ namespace TrenchBroom {
             return numberDelim;
         }
 
-        QuakeMapTokenizer::QuakeMapTokenizer(std::string_view str) :
-        Tokenizer(std::move(str), "\"", '\\'),
+        QuakeMapTokenizer::QuakeMapTokenizer(std::string_view str, const size_t line, const size_t column) :
+        Tokenizer(std::move(str), "\"", '\\', line, column),
         m_skipEol(true) {}
 
         void QuakeMapTokenizer::setSkipEol(bool skipEol) {
@@ -145,14 +145,156 @@ namespace TrenchBroom {
             assert(targetMapFormat != Model::MapFormat::Unknown);
         }
 
+        StandardMapParser::StandardMapParser(const Chunk& chunk, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) :
+        m_tokenizer(QuakeMapTokenizer(chunk.str, chunk.line, chunk.column)),
+        m_sourceMapFormat(sourceMapFormat),
+        m_targetMapFormat(targetMapFormat) {
+            assert(m_sourceMapFormat != Model::MapFormat::Unknown);
+            assert(targetMapFormat != Model::MapFormat::Unknown);
+        }
 
         StandardMapParser::~StandardMapParser() = default;
 
+        static bool isChunkWhitespace(const char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        std::vector<StandardMapParser::Chunk> StandardMapParser::splitIntoChunks(const std::string_view str, const size_t chunkSize) {
+            const auto wholeString = std::vector<Chunk>{{str, 1u, 1u, std::nullopt}};
+            if (str.size() <= chunkSize) {
+                return wholeString;
+            }
+
+            const auto* cur = str.data();
+            const auto* end = str.data() + str.size();
+
+            auto result = std::vector<Chunk>{};
+            const auto* chunkBegin = cur;
+            auto chunkLine = size_t(1);
+            auto chunkColumn = size_t(1);
+            auto chunkEntityLine = std::optional<size_t>{};
+
+            const auto* lineBegin = cur;
+            auto line = size_t(1);
+            auto depth = size_t(0);
+            auto entityLine = size_t(0);
+
+            const auto isSingleCharToken = [&]() {
+                return cur + 1 == end || isChunkWhitespace(*(cur + 1));
+            };
+
+            const auto skipUntilEol = [&]() {
+                while (cur < end && *cur != '\n' && *cur != '\r') {
+                    ++cur;
+                }
+            };
+
+            const auto skipUntilWhitespace = [&]() {
+                while (cur < end && !isChunkWhitespace(*cur)) {
+                    ++cur;
+                }
+            };
+
+            while (cur < end) {
+                switch (*cur) {
+                    case '\r':
+                        if (cur + 1 < end && *(cur + 1) == '\n') {
+                            // the line break is counted at the line feed
+                            ++cur;
+                            break;
+                        }
+                        switchFallthrough();
+                    case '\n':
+                        ++cur;
+                        ++line;
+                        lineBegin = cur;
+                        break;
+                    case ' ':
+                    case '\t':
+                        ++cur;
+                        break;
+                    case '"': {
+                        // skip a quoted string in the same way as QuakeMapTokenizer
+                        ++cur;
+                        auto escaped = false;
+                        while (cur < end) {
+                            const auto c = *cur;
+                            if (c == '"' && (!escaped || (cur + 1 < end && (*(cur + 1) == '\n' || *(cur + 1) == '}')))) {
+                                break;
+                            }
+                            if (c == '\n' || (c == '\r' && (cur + 1 == end || *(cur + 1) != '\n'))) {
+                                ++line;
+                                lineBegin = cur + 1;
+                            }
+                            escaped = c == '\\' && !escaped;
+                            ++cur;
+                        }
+                        if (cur == end) {
+                            // unterminated string
+                            return wholeString;
+                        }
+                        ++cur;
+                        break;
+                    }
+                    case '/':
+                        if (cur + 1 < end && *(cur + 1) == '/') {
+                            skipUntilEol();
+                        } else {
+                            ++cur;
+                        }
+                        break;
+                    case ';':
+                        skipUntilEol();
+                        break;
+                    case '{':
+                        if (!isSingleCharToken()) {
+                            // e.g. a texture name
+                            skipUntilWhitespace();
+                            break;
+                        }
+                        if (depth == 0u) {
+                            entityLine = line;
+                        }
+                        ++depth;
+                        ++cur;
+                        break;
+                    case '}':
+                        if (!isSingleCharToken()) {
+                            skipUntilWhitespace();
+                            break;
+                        }
+                        if (depth == 0u) {
+                            // unbalanced braces
+                            return wholeString;
+                        }
+                        --depth;
+                        ++cur;
+
+                        // we can split after an entity or after a brush or patch inside of an entity
+                        if (depth <= 1u && static_cast<size_t>(cur - chunkBegin) >= chunkSize && cur < end) {
+                            result.push_back(Chunk{std::string_view(chunkBegin, static_cast<size_t>(cur - chunkBegin)), chunkLine, chunkColumn, chunkEntityLine});
+                            chunkBegin = cur;
+                            chunkLine = line;
+                            chunkColumn = static_cast<size_t>(cur - lineBegin) + 1u;
+                            chunkEntityLine = depth == 1u ? std::optional<size_t>(entityLine) : std::nullopt;
+                        }
+                        break;
+                    default:
+                        skipUntilWhitespace();
+                        break;
+                }
+            }
+
+            result.push_back(Chunk{std::string_view(chunkBegin, static_cast<size_t>(end - chunkBegin)), chunkLine, chunkColumn, chunkEntityLine});
+            return result;
+        }
+
         void StandardMapParser::parseEntities(ParserStatus& status) {
             auto token = m_tokenizer.peekToken();
             while (token.type() != QuakeMapToken::Eof) {
                 expect(QuakeMapToken::OBrace, token);
                 parseEntity(status);
+                status.progress(m_tokenizer.progress());
                 token = m_tokenizer.peekToken();
             }
         }
@@ -180,6 +322,19 @@ namespace TrenchBroom {
             m_tokenizer.reset();
         }
 
+        void StandardMapParser::parseEntityChunk(const std::optional<size_t> entityLine, ParserStatus& status) {
+            if (entityLine) {
+                parseEntityBody(*entityLine, true, status);
+            }
+            parseEntities(status);
+        }
+
+        const std::vector<std::string>& StandardMapParser::openEntityPropertyKeys() const {
+            return m_openEntityPropertyKeys;
+        }
+
+        void StandardMapParser::onContinuedEntityProperty(const std::string& /* key */, const size_t /* line */, const size_t /* column */, ParserStatus& /* status */) {}
+
         void StandardMapParser::parseEntity(ParserStatus& status) {
             Token token = m_tokenizer.nextToken();
             if (token.type() == QuakeMapToken::Eof) {
@@ -187,22 +342,22 @@ namespace TrenchBroom {
             }
 
             expect(QuakeMapToken::OBrace, token);
+            parseEntityBody(token.line(), false, status);
+        }
 
-            auto beginEntityCalled = false;
-
+        void StandardMapParser::parseEntityBody(const size_t startLine, const bool continuesEntity, ParserStatus& status) {
+            auto beginEntityCalled = continuesEntity;
             auto properties = std::vector<Model::EntityProperty>();
             auto propertyKeys = PropertyKeys();
 
-            const auto startLine = token.line();
-
-            token = m_tokenizer.peekToken();
+            auto token = m_tokenizer.peekToken();
             while (token.type() != QuakeMapToken::Eof) {
                 switch (token.type()) {
                     case QuakeMapToken::Comment:
                         m_tokenizer.nextToken();
                         break;
                     case QuakeMapToken::String:
-                        parseEntityProperty(properties, propertyKeys, status);
+                        parseEntityProperty(properties, propertyKeys, continuesEntity, status);
                         break;
                     case QuakeMapToken::OBrace:
                         if (!beginEntityCalled) {
@@ -224,9 +379,12 @@ namespace TrenchBroom {
 
                 token = m_tokenizer.peekToken();
             }
+
+            // the entity continues in the next chunk
+            m_openEntityPropertyKeys = propertyKeys.release_data();
         }
 
-        void StandardMapParser::parseEntityProperty(std::vector<Model::EntityProperty>& properties, PropertyKeys& keys, ParserStatus& status) {
+        void StandardMapParser::parseEntityProperty(std::vector<Model::EntityProperty>& properties, PropertyKeys& keys, const bool continuesEntity, ParserStatus& status) {
             auto token = m_tokenizer.nextToken();
             assert(token.type() == QuakeMapToken::String);
             const auto name = token.data();
@@ -240,6 +398,9 @@ namespace TrenchBroom {
             if (keys.count(name) == 0) {
                 properties.push_back(Model::EntityProperty(name, value));
                 keys.insert(name);
+                if (continuesEntity) {
+                    onContinuedEntityProperty(name, line, column, status);
+                }
             } else {
                 status.warn(line, column, "Ignoring duplicate entity property '" + name + "'");
             }
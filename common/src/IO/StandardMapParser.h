@@ -29,6 +29,8 @@
 
 #include <vecmath/forward.h>
 
+#include <optional>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <vector>
@@ -59,7 +61,7 @@ namespace TrenchBroom {
             static const std::string& NumberDelim();
             bool m_skipEol;
         public:
-            explicit QuakeMapTokenizer(std::string_view str);
+            explicit QuakeMapTokenizer(std::string_view str, size_t line = 1, size_t column = 1);
 
             void setSkipEol(bool skipEol);
         private:
@@ -67,6 +69,20 @@ namespace TrenchBroom {
         };
 
         class StandardMapParser : public MapParser, public Parser<QuakeMapToken::Type> {
+        public:
+            /**
+             * A portion of a map file that can be parsed independently of the other portions.
+             */
+            struct Chunk {
+                std::string_view str;
+                size_t line;
+                size_t column;
+                /**
+                 * If set, the chunk begins in the body of an entity that starts at the given line in a previous chunk.
+                 * In this case, the chunk starts after a brush or patch of that entity.
+                 */
+                std::optional<size_t> entityLine;
+            };
         private:
             using Token = QuakeMapTokenizer::Token;
             using PropertyKeys = kdl::vector_set<std::string>;
@@ -75,6 +91,7 @@ namespace TrenchBroom {
             static const std::string PatchId;
 
             QuakeMapTokenizer m_tokenizer;
+            std::vector<std::string> m_openEntityPropertyKeys;
         protected:
             Model::MapFormat m_sourceMapFormat;
             Model::MapFormat m_targetMapFormat;
@@ -89,16 +106,60 @@ namespace TrenchBroom {
              */
             StandardMapParser(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat);
 
+            /**
+             * Creates a new parser for the given chunk of a map file, see splitIntoChunks.
+             *
+             * @param chunk the chunk to parse
+             * @param sourceMapFormat the expected format of the given chunk
+             * @param targetMapFormat the format to convert the created objects to
+             */
+            StandardMapParser(const Chunk& chunk, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat);
+
             ~StandardMapParser() override;
+
+            /**
+             * Splits the given string into chunks of approximately the given size so that the chunks can be parsed
+             * independently using parseEntityChunk.
+             *
+             * The chunks are split at top level entity boundaries or, within entities, after a brush or a patch. The
+             * split points are found by a quick scan that only tracks braces, quoted strings and comments, so the
+             * chunks are not guaranteed to be valid if the string is malformed. In that case, parsing at least one of
+             * the chunks will fail or the chunks will not fit together.
+             *
+             * If the string is not larger than the given chunk size, or if the scan finds an unmatched closing brace or
+             * an unterminated string, a single chunk containing the entire string is returned.
+             *
+             * @param str the string to split
+             * @param chunkSize the minimum size of a chunk in bytes, the last chunk may be smaller
+             * @return the chunks in the order in which they appear in the given string
+             */
+            static std::vector<Chunk> splitIntoChunks(std::string_view str, size_t chunkSize);
         protected:
             void parseEntities(ParserStatus& status);
+            /**
+             * Parses a chunk returned by splitIntoChunks. If the chunk begins in the body of an entity, the remainder
+             * of that entity's body is parsed first, and its end is reported using the given entity start line.
+             */
+            void parseEntityChunk(std::optional<size_t> entityLine, ParserStatus& status);
+            /**
+             * Returns the property keys of the entity that was still open when the end of the input was reached.
+             */
+            const std::vector<std::string>& openEntityPropertyKeys() const;
             void parseBrushesOrPatches(ParserStatus& status);
             void parseBrushFaces(ParserStatus& status);
 
             void reset();
         private:
+            /**
+             * Called for every property of an entity continued from a previous chunk (see parseEntityChunk) unless
+             * the property's key occurs earlier in this chunk. Whether such a property is a duplicate can only be
+             * decided once the property keys of the previous chunks are known.
+             */
+            virtual void onContinuedEntityProperty(const std::string& key, size_t line, size_t column, ParserStatus& status);
+
             void parseEntity(ParserStatus& status);
-            void parseEntityProperty(std::vector<Model::EntityProperty>& properties, PropertyKeys& keys, ParserStatus& status);
+            void parseEntityBody(size_t startLine, bool continuesEntity, ParserStatus& status);
+            void parseEntityProperty(std::vector<Model::EntityProperty>& properties, PropertyKeys& keys, bool continuesEntity, ParserStatus& status);
 
             void parseBrushOrBrushPrimitiveOrPatch(ParserStatus& status);
             void parseBrushPrimitive(ParserStatus& status, size_t startLine);
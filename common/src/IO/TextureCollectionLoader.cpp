@@ -19,7 +19,9 @@
 
 #include "TextureCollectionLoader.h"
 
+#include "Exceptions.h"
 #include "Logger.h"
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
@@ -28,7 +30,11 @@
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
+#include <kdl/parallel.h>
+
+#include <functional>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom {
@@ -39,7 +45,49 @@ namespace TrenchBroom {
 
         TextureCollectionLoader::~TextureCollectionLoader() = default;
 
-        bool TextureCollectionLoader::shouldExclude(const std::string& textureName) {
+        std::vector<Assets::Texture> TextureCollectionLoader::readTextures(const std::vector<Path>& texturePaths, const std::function<std::optional<Assets::Texture>(const Path&)>& readTexture) {
+            auto textures = std::vector<std::optional<Assets::Texture>>(texturePaths.size());
+            kdl::parallel_for(texturePaths.size(), [&](const size_t i) {
+                try {
+                    textures[i] = readTexture(texturePaths[i]);
+                } catch (const std::exception& e) {
+                    m_logger.warn() << e.what();
+                }
+            });
+
+            auto result = std::vector<Assets::Texture>{};
+            result.reserve(textures.size());
+            for (auto& texture : textures) {
+                if (texture) {
+                    result.push_back(std::move(*texture));
+                }
+            }
+            return result;
+        }
+
+        Assets::Texture TextureCollectionLoader::readTexture(const TextureReader& textureReader, std::shared_ptr<const TextureReader> pixelReader, std::shared_ptr<File> file, std::function<std::shared_ptr<File>()> openFile) const {
+            if (pixelReader == nullptr) {
+                return textureReader.readTexture(std::move(file));
+            }
+
+            try {
+                auto texture = textureReader.readTextureHeader(file);
+                texture.deferPixels([pixelReader = std::move(pixelReader), openFile = std::move(openFile)]() {
+                    try {
+                        return pixelReader->readTexturePixels(openFile());
+                    } catch (const Exception&) {
+                        return Assets::TexturePixels{};
+                    }
+                });
+                return texture;
+            } catch (const AssetException&) {
+                // logs the error and returns the default texture, which keeps its pixel data because it cannot be
+                // decoded from the file again
+                return textureReader.readTexture(std::move(file));
+            }
+        }
+
+        bool TextureCollectionLoader::shouldExclude(const std::string& textureName) const {
             for (const auto& pattern : m_textureExclusions) {
                 if (kdl::ci::str_matches_glob(textureName, pattern)) {
                     return true;
@@ -52,26 +100,20 @@ namespace TrenchBroom {
         TextureCollectionLoader(logger, exclusions),
         m_searchPaths(searchPaths) {}
 
-        Assets::TextureCollection FileTextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) {
+        Assets::TextureCollection FileTextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader, std::shared_ptr<const TextureReader> pixelReader) {
             const auto wadPath = Disk::resolvePath(m_searchPaths, path);
             WadFileSystem wadFS(wadPath, m_logger);
 
             const auto texturePaths = wadFS.findItems(Path(""), FileExtensionMatcher(textureExtensions));
-            auto textures = std::vector<Assets::Texture>();
-            textures.reserve(texturePaths.size());
-            
-            for (const auto& texturePath : texturePaths)  {
-                try {
-                    auto file = wadFS.openFile(texturePath);
-                    const auto name = file->path().lastComponent().deleteExtension().asString();
-                    if (shouldExclude(name)) {
-                        continue;
-                    }
-                    textures.push_back(textureReader.readTexture(file));
-                } catch (const std::exception& e) {
-                    m_logger.warn() << e.what();
+            auto textures = readTextures(texturePaths, [&](const Path& texturePath) -> std::optional<Assets::Texture> {
+                auto file = wadFS.openFile(texturePath);
+                const auto name = file->path().lastComponent().deleteExtension().asString();
+                if (shouldExclude(name)) {
+                    return std::nullopt;
                 }
-            }
+                // the WAD file stays open as long as the texture needs it
+                return readTexture(textureReader, pixelReader, file, [file]() { return file; });
+            });
 
             return Assets::TextureCollection(path, std::move(textures));
         }
@@ -80,36 +122,29 @@ namespace TrenchBroom {
         TextureCollectionLoader(logger, exclusions),
         m_gameFS(gameFS) {}
 
-        Assets::TextureCollection DirectoryTextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) {
+        Assets::TextureCollection DirectoryTextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader, std::shared_ptr<const TextureReader> pixelReader) {
             const auto texturePaths = m_gameFS.findItems(path, FileExtensionMatcher(textureExtensions));
-            auto textures = std::vector<Assets::Texture>();
-            textures.reserve(texturePaths.size());
+            auto textures = readTextures(texturePaths, [&](const Path& texturePath) -> std::optional<Assets::Texture> {
+                auto file = m_gameFS.openFile(texturePath);
 
-            for (const auto& texturePath : texturePaths) {
+                // Store the absolute path to the original file (may be used by .obj export)
+                IO::Path absolutePath;
                 try {
-                    auto file = m_gameFS.openFile(texturePath);
-
-                    // Store the absolute path to the original file (may be used by .obj export)
-                    IO::Path absolutePath;
-                    try {
-                        absolutePath = m_gameFS.makeAbsolute(texturePath);
-                    } catch (const FileSystemException& e) {
-                        m_logger.debug() << e.what();
-                    }
+                    absolutePath = m_gameFS.makeAbsolute(texturePath);
+                } catch (const FileSystemException& e) {
+                    m_logger.debug() << e.what();
+                }
 
-                    const auto name = file->path().lastComponent().deleteExtension().asString();
-                    if (shouldExclude(name)) {
-                        continue;
-                    }
-                    auto texture = textureReader.readTexture(file);
-                    texture.setAbsolutePath(absolutePath);
-                    texture.setRelativePath(texturePath);
-                    textures.push_back(std::move(texture));
-                } catch (const std::exception& e) {
-                    m_logger.warn() << e.what();
+                const auto name = file->path().lastComponent().deleteExtension().asString();
+                if (shouldExclude(name)) {
+                    return std::nullopt;
                 }
-            }
-            
+                auto texture = readTexture(textureReader, pixelReader, file, [&gameFS = m_gameFS, texturePath]() { return gameFS.openFile(texturePath); });
+                texture.setAbsolutePath(absolutePath);
+                texture.setRelativePath(texturePath);
+                return texture;
+            });
+
             return Assets::TextureCollection(path, std::move(textures));
         }
     }
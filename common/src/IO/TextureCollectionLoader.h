@@ -19,15 +19,17 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
-#include <string>
 
 namespace TrenchBroom {
     class Logger;
 
     namespace Assets {
+        class Texture;
         class TextureCollection;
     }
 
@@ -48,9 +50,22 @@ namespace TrenchBroom {
         public:
             virtual ~TextureCollectionLoader();
         public:
-            virtual Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) = 0;
+            /**
+             * Loads the texture collection with the given path. If a pixel reader is given, only the headers of the
+             * textures are read, and the pixel reader decodes the pixel data of a texture when it is needed.
+             */
+            virtual Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader, std::shared_ptr<const TextureReader> pixelReader) = 0;
         protected:
-            bool shouldExclude(const std::string& textureName);
+            /**
+             * Reads the textures with the given paths concurrently using the given function, which may return an
+             * empty optional to skip a texture. Exceptions thrown by the function are logged as warnings and the
+             * corresponding textures are skipped.
+             *
+             * The textures are returned in the order of the given paths.
+             */
+            std::vector<Assets::Texture> readTextures(const std::vector<Path>& texturePaths, const std::function<std::optional<Assets::Texture>(const Path&)>& readTexture);
+            Assets::Texture readTexture(const TextureReader& textureReader, std::shared_ptr<const TextureReader> pixelReader, std::shared_ptr<File> file, std::function<std::shared_ptr<File>()> openFile) const;
+            bool shouldExclude(const std::string& textureName) const;
         };
 
         class FileTextureCollectionLoader : public TextureCollectionLoader {
@@ -59,7 +74,7 @@ namespace TrenchBroom {
         public:
             FileTextureCollectionLoader(Logger& logger, const std::vector<Path>& searchPaths, const std::vector<std::string>& exclusions);
         private:
-            Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader);
+            Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader, std::shared_ptr<const TextureReader> pixelReader) override;
         };
 
         class DirectoryTextureCollectionLoader : public TextureCollectionLoader {
@@ -68,7 +83,7 @@ namespace TrenchBroom {
         public:
             DirectoryTextureCollectionLoader(Logger& logger, const FileSystem& gameFS, const std::vector<std::string>& exclusions);
         private:
-            Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader);
+            Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader, std::shared_ptr<const TextureReader> pixelReader) override;
         };
     }
 }
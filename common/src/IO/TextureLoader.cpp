@@ -19,7 +19,9 @@
 
 #include "TextureLoader.h"
 
+#include "BufferedLogger.h"
 #include "Ensure.h"
+#include "Exceptions.h"
 #include "Logger.h"
 #include "Assets/Palette.h"
 #include "Assets/TextureCollection.h"
@@ -35,17 +37,27 @@
 #include "IO/Path.h"
 #include "Model/GameConfig.h"
 
+#include <kdl/parallel.h>
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <chrono>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger) :
+        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger, const bool loadPixelsOnDemand) :
+        m_logger(logger),
+        m_bufferedLogger(std::make_unique<BufferedLogger>()),
         m_textureExtensions(getTextureExtensions(textureConfig)),
-        m_textureReader(createTextureReader(gameFS, textureConfig, logger)),
-        m_textureCollectionLoader(createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, logger)) {
+        m_textureReader(createTextureReader(gameFS, textureConfig, *m_bufferedLogger)),
+        m_pixelReader(createPixelReader(gameFS, textureConfig, loadPixelsOnDemand)),
+        m_textureCollectionLoader(createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, *m_bufferedLogger)) {
             ensure(m_textureReader != nullptr, "textureReader is null");
             ensure(m_textureCollectionLoader != nullptr, "textureCollectionLoader is null");
+            m_bufferedLogger->flush(m_logger);
         }
 
         TextureLoader::~TextureLoader() = default;
@@ -75,6 +87,16 @@ namespace TrenchBroom {
             }
         }
 
+        std::shared_ptr<const TextureReader> TextureLoader::createPixelReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, const bool loadPixelsOnDemand) {
+            if (!loadPixelsOnDemand || textureConfig.format.format == "q3shader") {
+                return nullptr;
+            }
+
+            // the pixel reader outlives this loader, and errors are handled by the textures that use it
+            static auto logger = NullLogger();
+            return createTextureReader(gameFS, textureConfig, logger);
+        }
+
         Assets::Palette TextureLoader::loadPalette(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger) {
             if (textureConfig.palette.isEmpty()) {
                 return Assets::Palette();
@@ -104,7 +126,42 @@ namespace TrenchBroom {
         }
 
         Assets::TextureCollection TextureLoader::loadTextureCollection(const Path& path) {
-            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader);
+            try {
+                auto collection = m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader, m_pixelReader);
+                m_bufferedLogger->flush(m_logger);
+                return collection;
+            } catch (...) {
+                m_bufferedLogger->flush(m_logger);
+                throw;
+            }
+        }
+
+        std::vector<TextureLoader::LoadTextureCollectionResult> TextureLoader::loadTextureCollections(const std::vector<Path>& paths) {
+            auto results = std::vector<std::optional<LoadTextureCollectionResult>>(paths.size());
+            auto loadTimes = std::vector<std::chrono::milliseconds>(paths.size());
+
+            // the textures of each collection are read concurrently, too
+            kdl::parallel_for(paths.size(), [&](const size_t i) {
+                try {
+                    const auto startTime = std::chrono::high_resolution_clock::now();
+                    results[i] = m_textureCollectionLoader->loadTextureCollection(paths[i], m_textureExtensions, *m_textureReader, m_pixelReader);
+                    const auto endTime = std::chrono::high_resolution_clock::now();
+                    loadTimes[i] = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+                } catch (const Exception& e) {
+                    results[i] = TextureCollectionLoadError{e.what()};
+                }
+            }, 1);
+
+            m_bufferedLogger->flush(m_logger);
+            for (size_t i = 0; i < paths.size(); ++i) {
+                if (results[i]->is_success()) {
+                    m_logger.info() << "Loaded texture collection '" << paths[i] << "' in " << loadTimes[i].count() << "ms";
+                }
+            }
+
+            return kdl::vec_transform(std::move(results), [](std::optional<LoadTextureCollectionResult>&& result) {
+                return std::move(*result);
+            });
         }
 
         void TextureLoader::loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager) {
@@ -21,11 +21,14 @@
 
 #include "Macros.h"
 
+#include <kdl/result_forward.h>
+
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
+    class BufferedLogger;
     class Logger;
 
     namespace Assets {
@@ -44,21 +47,48 @@ namespace TrenchBroom {
         class TextureCollectionLoader;
         class TextureReader;
 
+        struct TextureCollectionLoadError {
+            std::string msg;
+        };
+
         class TextureLoader {
+        public:
+            using LoadTextureCollectionResult = kdl::result<Assets::TextureCollection, TextureCollectionLoadError>;
         private:
+            Logger& m_logger;
+            std::unique_ptr<BufferedLogger> m_bufferedLogger;
             std::vector<std::string> m_textureExtensions;
             std::unique_ptr<TextureReader> m_textureReader;
+            std::shared_ptr<const TextureReader> m_pixelReader;
             std::unique_ptr<TextureCollectionLoader> m_textureCollectionLoader;
         public:
-            TextureLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
+            /**
+             * Creates a texture loader for the given configuration.
+             *
+             * If loadPixelsOnDemand is true, the loaded textures only contain their names, dimensions and metadata,
+             * and their pixel data is decoded when they are used for rendering. This is not supported for Quake 3
+             * shaders.
+             */
+            TextureLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger, bool loadPixelsOnDemand = false);
             ~TextureLoader();
         private:
             static std::vector<std::string> getTextureExtensions(const Model::TextureConfig& textureConfig);
             static std::unique_ptr<TextureReader> createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
+            static std::shared_ptr<const TextureReader> createPixelReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, bool loadPixelsOnDemand);
             static Assets::Palette loadPalette(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
             static std::unique_ptr<TextureCollectionLoader> createTextureCollectionLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
         public:
+            /**
+             * Loads the texture collection with the given path. The textures of the collection are read concurrently.
+             */
             Assets::TextureCollection loadTextureCollection(const Path& path);
+
+            /**
+             * Loads the texture collections with the given paths concurrently. The results are returned in the order
+             * of the given paths, and the messages logged while loading are passed on after all collections have been
+             * loaded.
+             */
+            std::vector<LoadTextureCollectionResult> loadTextureCollections(const std::vector<Path>& paths);
             void loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager);
 
             deleteCopyAndMove(TextureLoader)
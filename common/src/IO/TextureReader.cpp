@@ -19,6 +19,7 @@
 
 #include "TextureReader.h"
 
+#include "Exceptions.h"
 #include "Logger.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureBuffer.h"
@@ -27,6 +28,7 @@
 #include "IO/ResourceUtils.h"
 
 #include <algorithm>
+#include <optional>
 
 namespace TrenchBroom {
     namespace IO {
@@ -96,6 +98,22 @@ namespace TrenchBroom {
             }
         }
 
+        Assets::Texture TextureReader::readTextureHeader(std::shared_ptr<File> file) const {
+            if (auto texture = doReadTextureHeader(file)) {
+                return std::move(*texture);
+            }
+            return doReadTexture(std::move(file));
+        }
+
+        Assets::TexturePixels TextureReader::readTexturePixels(std::shared_ptr<File> file) const {
+            auto texture = doReadTexture(std::move(file));
+            return texture.takePixels();
+        }
+
+        std::optional<Assets::Texture> TextureReader::doReadTextureHeader(std::shared_ptr<File> /* file */) const {
+            return std::nullopt;
+        }
+
         std::string TextureReader::textureName(const std::string& textureName, const Path& path) const {
             return m_nameStrategy->textureName(textureName, path);
         }
@@ -22,6 +22,7 @@
 #include "Macros.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace TrenchBroom {
@@ -29,6 +30,7 @@ namespace TrenchBroom {
     
     namespace Assets {
         class Texture;
+        struct TexturePixels;
     }
 
     namespace IO {
@@ -118,6 +120,27 @@ namespace TrenchBroom {
              * @return an Assets::Texture object
              */
             Assets::Texture readTexture(std::shared_ptr<File> file) const;
+
+            /**
+             * Reads the name, the dimensions and the metadata of the texture in the given file without decoding its
+             * pixel data, if the texture format permits this. Otherwise, the entire texture is read. Unlike
+             * readTexture, this does not log errors and does not fall back to the default texture.
+             *
+             * @param file the file containing the texture
+             * @return an Assets::Texture object that may not have any pixel data
+             * @throws AssetException if the texture cannot be read
+             */
+            Assets::Texture readTextureHeader(std::shared_ptr<File> file) const;
+
+            /**
+             * Decodes the pixel data of the texture in the given file. Unlike readTexture, this does not log errors
+             * and does not fall back to the default texture.
+             *
+             * @param file the file containing the texture
+             * @return the pixel data
+             * @throws AssetException if the texture cannot be read
+             */
+            Assets::TexturePixels readTexturePixels(std::shared_ptr<File> file) const;
         protected:
             std::string textureName(const std::string& textureName, const Path& path) const;
             std::string textureName(const Path& path) const;
@@ -130,6 +153,15 @@ namespace TrenchBroom {
              * @return an Assets::Texture object
              */
             virtual Assets::Texture doReadTexture(std::shared_ptr<File> file) const = 0;
+
+            /**
+             * Reads a texture without its pixel data. Returns an empty optional if the texture format does not permit
+             * this. Errors are reported like in doReadTexture.
+             *
+             * @param file the file containing the texture
+             * @return an Assets::Texture object without pixel data or an empty optional
+             */
+            virtual std::optional<Assets::Texture> doReadTextureHeader(std::shared_ptr<File> file) const;
         protected:
             static bool checkTextureDimensions(size_t width, size_t height);
         public:
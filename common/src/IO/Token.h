@@ -21,6 +21,7 @@
 
 #include <cassert>
 #include <string>
+#include <string_view>
 
 #include <kdl/string_utils.h>
 
@@ -92,12 +93,12 @@ namespace TrenchBroom {
 
             template <typename T>
             T toFloat() const {
-                return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+                return static_cast<T>(kdl::str_parse_double(std::string_view(m_begin, length())).value_or(0.0));
             }
 
             template <typename T>
             T toInteger() const {
-                return static_cast<T>(kdl::str_to_long(std::string(m_begin, m_end)).value_or(0l));
+                return static_cast<T>(kdl::str_parse_long(std::string_view(m_begin, length())).value_or(0l));
             }
         };
     }
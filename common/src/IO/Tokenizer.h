@@ -26,6 +26,7 @@
 
 #include <kdl/string_format.h>
 
+#include <algorithm>
 #include <cassert>
 #include <tuple>
 #include <string>
@@ -52,18 +53,28 @@ namespace TrenchBroom {
             const char* m_end;
             std::string m_escapableChars;
             char m_escapeChar;
+            size_t m_startLine;
+            size_t m_startColumn;
             TokenizerState m_state;
         public:
-            TokenizerBase(const char* begin, const char* end, std::string_view escapableChars, const char escapeChar) :
+            /**
+             * Creates a new tokenizer for the given range of characters. The line and column numbers refer to the
+             * position of the first character, they must be given if the range is part of a larger text.
+             */
+            TokenizerBase(const char* begin, const char* end, std::string_view escapableChars, const char escapeChar, const size_t line = 1, const size_t column = 1) :
             m_begin(begin),
             m_end(end),
             m_escapableChars(escapableChars),
             m_escapeChar(escapeChar),
-            m_state{begin, 1, 1, false} {}
+            m_startLine(line),
+            m_startColumn(column),
+            m_state{begin, line, column, false} {}
 
             void replaceState(std::string_view str) {
                 m_begin = str.data();
                 m_end = str.data() + str.length();
+                m_startLine = 1;
+                m_startColumn = 1;
                 // preserve m_escapableChars and m_escapeChar
                 reset();
             }
@@ -114,11 +125,75 @@ namespace TrenchBroom {
             }
 
             void advance(size_t offset)  {
-                for (size_t i = 0; i < offset; ++i) {
-                    advance();
+                const auto remaining = static_cast<size_t>(m_end - m_state.cur);
+                advanceTo(m_state.cur + std::min(offset, remaining));
+                if (offset > remaining) {
+                    throw ParserException("Unexpected end of file");
+                }
+            }
+
+            /**
+             * Advances to the given position, which must not be before the current position or after the end of the
+             * input. The resulting state is the same as if advance() had been called for every character in between.
+             */
+            void advanceTo(const char* ptr) {
+                assert(ptr >= m_state.cur && ptr <= m_end);
+
+                const auto* cur = m_state.cur;
+                const auto* end = m_end;
+                auto line = m_state.line;
+                const char* lineBegin = nullptr;
+                for (const auto* c = cur; c < ptr; ++c) {
+                    if (*c == '\n' || (*c == '\r' && (c + 1 == end || *(c + 1) != '\n'))) {
+                        ++line;
+                        lineBegin = c + 1;
+                    }
+                }
+
+                if (lineBegin != nullptr) {
+                    m_state.line = line;
+                    m_state.column = 1 + static_cast<size_t>(ptr - lineBegin);
+                    m_state.escaped = false;
+                    updateEscaped(lineBegin, ptr);
+                    m_state.cur = ptr;
+                } else {
+                    advanceWithinLine(ptr);
                 }
             }
 
+            /**
+             * Like advanceTo, but the caller guarantees that there is no line break between the current position and
+             * the given position, which saves a pass over the skipped characters.
+             */
+            void advanceWithinLine(const char* ptr) {
+                assert(ptr >= m_state.cur && ptr <= m_end);
+
+                m_state.column += static_cast<size_t>(ptr - m_state.cur);
+                updateEscaped(m_state.cur, ptr);
+                m_state.cur = ptr;
+            }
+        private:
+            /**
+             * Updates the escape state after the characters in the given range have been skipped. Every escape
+             * character toggles the escape state and every other character except for a carriage return preceding a
+             * line feed resets it, so only the last characters of the range must be considered.
+             */
+            void updateEscaped(const char* begin, const char* ptr) {
+                auto escapeChars = size_t(0);
+                for (const auto* c = ptr; c > begin; --c) {
+                    const auto ch = *(c - 1);
+                    if (ch == m_escapeChar) {
+                        ++escapeChars;
+                    } else if (ch != '\r' || c == m_end || *c != '\n') {
+                        m_state.escaped = false;
+                        break;
+                    }
+                }
+                if (escapeChars % 2u == 1u) {
+                    m_state.escaped = !m_state.escaped;
+                }
+            }
+        protected:
             void advance() {
                 errorIfEof();
 
@@ -177,8 +252,8 @@ namespace TrenchBroom {
         public:
             void reset() {
                 m_state.cur = m_begin;
-                m_state.line = 1;
-                m_state.column = 1;
+                m_state.line = m_startLine;
+                m_state.column = m_startColumn;
                 m_state.escaped = false;
             }
 
@@ -218,8 +293,8 @@ namespace TrenchBroom {
                 return whitespace;
             }
         public:
-            Tokenizer(std::string_view str, std::string_view escapableChars, const char escapeChar) :
-            TokenizerBase(str.data(), str.data() + str.size(), escapableChars, escapeChar) {}
+            Tokenizer(std::string_view str, std::string_view escapableChars, const char escapeChar, const size_t line = 1, const size_t column = 1) :
+            TokenizerBase(str.data(), str.data() + str.size(), escapableChars, escapeChar, line, column) {}
 
             virtual ~Tokenizer() = default;
 
@@ -343,18 +418,16 @@ namespace TrenchBroom {
                     return nullptr;
                 }
 
-                const TokenizerState previousState = m_state;
-                if (curChar() == '+' || curChar() == '-') {
-                    advance();
-                }
-                while (!eof() && isDigit(curChar())) {
-                    advance();
-                }
-                if (eof() || isAnyOf(curChar(), delims)) {
-                    return curPos();
+                const auto* e = curPos();
+                if (*e == '+' || *e == '-') {
+                    ++e;
                 }
+                e = skipDigits(e);
 
-                m_state = previousState;
+                if (e == m_end || isAnyOf(*e, delims)) {
+                    advanceWithinLine(e);
+                    return e;
+                }
                 return nullptr;
             }
 
@@ -363,45 +436,57 @@ namespace TrenchBroom {
                     return nullptr;
                 }
 
-                const TokenizerState previousState = m_state;
-                if (curChar() != '.') {
-                    advance();
-                    readDigits();
+                const auto* e = curPos();
+                if (*e != '.') {
+                    e = skipDigits(e + 1);
                 }
 
-                if (curChar() == '.') {
-                    advance();
-                    readDigits();
+                if (e < m_end && *e == '.') {
+                    e = skipDigits(e + 1);
                 }
 
-                if (curChar() == 'e') {
-                    advance();
-                    if (curChar() == '+' || curChar() == '-' || isDigit(curChar())) {
-                        advance();
-                        readDigits();
+                if (e < m_end && *e == 'e') {
+                    ++e;
+                    if (e < m_end && (*e == '+' || *e == '-' || isDigit(*e))) {
+                        e = skipDigits(e + 1);
                     }
                 }
 
-                if (eof() || isAnyOf(curChar(), delims)) {
-                    return curPos();
+                if (e == m_end || isAnyOf(*e, delims)) {
+                    advanceWithinLine(e);
+                    return e;
                 }
-
-                m_state = previousState;
                 return nullptr;
             }
 
         private:
-            void readDigits() {
-                while (!eof() && isDigit(curChar())) {
-                    advance();
+            const char* skipDigits(const char* ptr) const {
+                while (ptr < m_end && isDigit(*ptr)) {
+                    ++ptr;
+                }
+                return ptr;
+            }
+
+            const char* skipUntil(const char* ptr, std::string_view delims) const {
+                while (ptr < m_end && !isAnyOf(*ptr, delims)) {
+                    ++ptr;
+                }
+                return ptr;
+            }
+
+            void advanceUntil(std::string_view delims) {
+                const auto* e = skipUntil(curPos(), delims);
+                if (isAnyOf('\n', delims) && isAnyOf('\r', delims)) {
+                    advanceWithinLine(e);
+                } else {
+                    advanceTo(e);
                 }
             }
         protected:
             const char* readUntil(std::string_view delims) {
                 if (!eof()) {
-                    do {
-                        advance();
-                    } while (!eof() && !isAnyOf(curChar(), delims));
+                    advance();
+                    advanceUntil(delims);
                 }
                 return curPos();
             }
@@ -429,6 +514,7 @@ namespace TrenchBroom {
             }
 
             const char* discardWhile(std::string_view allow) {
+                // runs of whitespace are usually too short to benefit from skipping them in bulk
                 while (!eof() && isAnyOf(curChar(), allow)) {
                     advance();
                 }
@@ -436,9 +522,7 @@ namespace TrenchBroom {
             }
 
             const char* discardUntil(std::string_view delims) {
-                while (!eof() && !isAnyOf(curChar(), delims)) {
-                    advance();
-                }
+                advanceUntil(delims);
                 return curPos();
             }
 
@@ -19,6 +19,7 @@
 
 #include "WorldReader.h"
 
+#include "IO/MapSnapshot.h"
 #include "IO/ParserStatus.h"
 #include "Color.h"
 #include "Model/BrushNode.h"
@@ -85,8 +86,48 @@ namespace TrenchBroom {
             }
         }
 
+        std::tuple<std::unique_ptr<Model::WorldNode>, std::string> WorldReader::tryReadAndRecordSnapshot(std::string_view str, const std::vector<Model::MapFormat>& mapFormatsToTry, const uint64_t snapshotKey, const vm::bbox3& worldBounds, ParserStatus& status) {
+            std::vector<std::tuple<Model::MapFormat, std::string>> parserExceptions;
+
+            for (const auto mapFormat : mapFormatsToTry) {
+                if (mapFormat == Model::MapFormat::Unknown) {
+                    continue;
+                }
+
+                try {
+                    WorldReader reader{str, mapFormat};
+                    reader.m_snapshotKey = snapshotKey;
+                    auto world = reader.read(worldBounds, status);
+                    return {std::move(world), std::move(reader.m_snapshot)};
+                } catch (const ParserException& e) {
+                    parserExceptions.emplace_back(mapFormat, std::string{e.what()});
+                }
+            }
+
+            if (!parserExceptions.empty()) {
+                throw WorldReaderException(parserExceptions);
+            } else {
+                throw WorldReaderException({{Model::MapFormat::Unknown, "No valid formats to parse as"}});
+            }
+        }
+
+        std::unique_ptr<Model::WorldNode> WorldReader::readSnapshot(std::string_view snapshotData, const uint64_t snapshotKey, const vm::bbox3& worldBounds, ParserStatus& status) {
+            auto snapshot = readMapSnapshot(snapshotData, snapshotKey);
+            if (!snapshot) {
+                return nullptr;
+            }
+
+            WorldReader reader{std::string_view{}, snapshot->format};
+            reader.readObjectInfos(std::move(snapshot->objectInfos), worldBounds, status);
+            return reader.finishWorld(status);
+        }
+
         std::unique_ptr<Model::WorldNode> WorldReader::read(const vm::bbox3& worldBounds, ParserStatus& status) {
             readEntities(worldBounds, status);
+            return finishWorld(status);
+        }
+
+        std::unique_ptr<Model::WorldNode> WorldReader::finishWorld(ParserStatus& status) {
             sanitizeLayerSortIndicies(status);
             m_world->rebuildNodeTree();
             m_world->enableNodeTreeUpdates();
@@ -137,6 +178,14 @@ namespace TrenchBroom {
             }
         }
 
+        void WorldReader::onObjectInfos(std::vector<ObjectInfo>& objectInfos, ParserStatus& /* status */) {
+            if (m_snapshotKey) {
+                // the snapshot records the brush geometry so that it need not be computed when restoring the snapshot
+                createBrushes(objectInfos);
+                m_snapshot = writeMapSnapshot(*m_snapshotKey, m_world->mapFormat(), objectInfos);
+            }
+        }
+
         Model::Node* WorldReader::onWorldNode(std::unique_ptr<Model::WorldNode> worldNode, ParserStatus&) {
             // we transfer the properties and the configuration of the default layer, but don't use the given node
             m_world->setEntity(worldNode->entity());
@@ -22,8 +22,11 @@
 #include "Exceptions.h"
 #include "IO/MapReader.h"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -46,6 +49,8 @@ namespace TrenchBroom {
          */
         class WorldReader : public MapReader {
             std::unique_ptr<Model::WorldNode> m_world;
+            std::optional<uint64_t> m_snapshotKey;
+            std::string m_snapshot;
         public:
             explicit WorldReader(std::string_view str, Model::MapFormat sourceAndTargetMapFormat);
 
@@ -55,6 +60,8 @@ namespace TrenchBroom {
              * Try to parse the given string as the given map formats, in order.
              * Returns the world if parsing is successful, otherwise throws an exception.
              *
+             * The given string is not copied, every attempted format tokenizes it in place.
+             *
              * @param str the string to parse
              * @param mapFormatsToTry formats to try, in order
              * @param worldBounds world bounds
@@ -63,9 +70,26 @@ namespace TrenchBroom {
              * @throws WorldReaderException if `str` can't be parsed by any of the given formats
              */
             static std::unique_ptr<Model::WorldNode> tryRead(std::string_view str, const std::vector<Model::MapFormat>& mapFormatsToTry, const vm::bbox3& worldBounds, ParserStatus& status);
-        private:            
+
+            /**
+             * Like tryRead, but additionally records a snapshot of the parsed objects with the given key.
+             *
+             * @return the world node and the snapshot data, see writeMapSnapshot
+             * @throws WorldReaderException if `str` can't be parsed by any of the given formats
+             */
+            static std::tuple<std::unique_ptr<Model::WorldNode>, std::string> tryReadAndRecordSnapshot(std::string_view str, const std::vector<Model::MapFormat>& mapFormatsToTry, uint64_t snapshotKey, const vm::bbox3& worldBounds, ParserStatus& status);
+
+            /**
+             * Creates a world from the given snapshot data without parsing the map file.
+             *
+             * @return the world node or null if the data is not a valid snapshot recorded with the given key
+             */
+            static std::unique_ptr<Model::WorldNode> readSnapshot(std::string_view snapshotData, uint64_t snapshotKey, const vm::bbox3& worldBounds, ParserStatus& status);
+        private:
+            std::unique_ptr<Model::WorldNode> finishWorld(ParserStatus& status);
             void sanitizeLayerSortIndicies(ParserStatus& status);            
         private: // implement MapReader interface
+            void onObjectInfos(std::vector<ObjectInfo>& objectInfos, ParserStatus& status) override;
             Model::Node* onWorldNode(std::unique_ptr<Model::WorldNode> worldNode, ParserStatus& status) override;
             void onLayerNode(std::unique_ptr<Model::Node> layerNode, ParserStatus& status) override;
             void onNode(Model::Node* parentNode, std::unique_ptr<Model::Node> node, ParserStatus& status) override;
@@ -21,9 +21,12 @@
 
 #include "IO/File.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/Reader.h"
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 namespace TrenchBroom {
     namespace IO {
@@ -34,10 +37,11 @@ namespace TrenchBroom {
         m_fileIndex(fileIndex) {}
 
         std::shared_ptr<File> ZipFileSystem::ZipCompressedFile::doOpen() const {
-            const auto path = Path(m_owner->filename(m_fileIndex));
+            auto& archive = m_owner->threadArchive();
+            const auto path = Path(filename(archive, m_fileIndex));
 
             mz_zip_archive_file_stat stat;
-            if (!mz_zip_reader_file_stat(&m_owner->m_archive, m_fileIndex, &stat)) {
+            if (!mz_zip_reader_file_stat(&archive, m_fileIndex, &stat)) {
                 throw FileSystemException("mz_zip_reader_file_stat failed for " + path.asString());
             }
 
@@ -45,13 +49,17 @@ namespace TrenchBroom {
             auto data = std::make_unique<char[]>(uncompressedSize);
             auto* begin = data.get();
 
-            if (!mz_zip_reader_extract_to_mem(&m_owner->m_archive, m_fileIndex, begin, uncompressedSize, 0)) {
+            if (!mz_zip_reader_extract_to_mem(&archive, m_fileIndex, begin, uncompressedSize, 0)) {
                 throw FileSystemException("mz_zip_reader_extract_to_mem failed for " + path.asString());
             }
 
             return std::make_shared<OwningBufferFile>(path, std::move(data), uncompressedSize);
         }
 
+        bool ZipFileSystem::ZipCompressedFile::doIsCompressed() const {
+            return true;
+        }
+
         // ZipFileSystem
 
         ZipFileSystem::ZipFileSystem(const Path& path) :
@@ -63,21 +71,25 @@ namespace TrenchBroom {
         }
 
         ZipFileSystem::~ZipFileSystem() {
+            for (auto& [threadId, archive] : m_threadArchives) {
+                mz_zip_reader_end(archive.get());
+            }
             mz_zip_reader_end(&m_archive);
         }
 
         void ZipFileSystem::doReadDirectory() {
             mz_zip_zero_struct(&m_archive);
 
-            if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE) {
-                throw FileSystemException("Error calling mz_zip_reader_init_cfile");
+            const auto reader = m_file->reader().buffer();
+            if (mz_zip_reader_init_mem(&m_archive, reader.begin(), m_file->size(), 0) != MZ_TRUE) {
+                throw FileSystemException("Error calling mz_zip_reader_init_mem");
             }
 
             const mz_uint numFiles = mz_zip_reader_get_num_files(&m_archive);
             for (mz_uint i = 0; i < numFiles; ++i) {
                 if (!mz_zip_reader_is_file_a_directory(&m_archive, i)) {
-                    const auto path = Path(filename(i));
-                    m_root.addFile(path, std::make_unique<ZipCompressedFile>(this, i));
+                    const auto path = Path(filename(m_archive, i));
+                    addFile(path, std::make_unique<ZipCompressedFile>(this, i));
                 }
             }
 
@@ -87,12 +99,34 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Returns the archive that the calling thread uses to extract files. The archives of all threads read the
+         * same mapped memory, so only their bookkeeping is duplicated.
+         */
+        mz_zip_archive& ZipFileSystem::threadArchive() {
+            const auto lock = std::lock_guard<std::mutex>{m_threadArchivesMutex};
+
+            auto& archive = m_threadArchives[std::this_thread::get_id()];
+            if (!archive) {
+                auto newArchive = std::make_unique<mz_zip_archive>();
+                mz_zip_zero_struct(newArchive.get());
+
+                const auto reader = m_file->reader().buffer();
+                if (mz_zip_reader_init_mem(newArchive.get(), reader.begin(), m_file->size(), 0) != MZ_TRUE) {
+                    m_threadArchives.erase(std::this_thread::get_id());
+                    throw FileSystemException("Error calling mz_zip_reader_init_mem");
+                }
+                archive = std::move(newArchive);
+            }
+            return *archive;
+        }
+
         /**
          * Helper to get the filename of a file in the zip archive
          */
-        std::string ZipFileSystem::filename(const mz_uint fileIndex) {
+        std::string ZipFileSystem::filename(mz_zip_archive& archive, const mz_uint fileIndex) {
             // nameLen includes space for the null-terminator byte
-            const mz_uint nameLen = mz_zip_reader_get_filename(&m_archive, fileIndex, nullptr, 0);
+            const mz_uint nameLen = mz_zip_reader_get_filename(&archive, fileIndex, nullptr, 0);
             if (nameLen == 0) {
                 return "";
             }
@@ -101,7 +135,7 @@ namespace TrenchBroom {
             result.resize(static_cast<size_t>(nameLen - 1));
 
             // NOTE: this will overwrite the std::string's null terminator, which is permitted in C++17 and later
-            mz_zip_reader_get_filename(&m_archive, fileIndex, result.data(), nameLen);
+            mz_zip_reader_get_filename(&archive, fileIndex, result.data(), nameLen);
 
             return result;
         }
@@ -22,6 +22,9 @@
 #include "IO/ImageFileSystem.h"
 
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include <miniz/miniz.h>
 
@@ -32,6 +35,13 @@ namespace TrenchBroom {
         class ZipFileSystem : public ImageFileSystem {
         private:
             mz_zip_archive m_archive;
+
+            /**
+             * miniz records the last error in the archive, so concurrent extractions using the same archive would
+             * race. Therefore, every thread that extracts files uses its own archive.
+             */
+            std::mutex m_threadArchivesMutex;
+            std::unordered_map<std::thread::id, std::unique_ptr<mz_zip_archive>> m_threadArchives;
         private:
             class ZipCompressedFile : public FileEntry {
             private:
@@ -41,6 +51,7 @@ namespace TrenchBroom {
                 ZipCompressedFile(ZipFileSystem* owner, mz_uint fileIndex);
             private:
                 std::shared_ptr<File> doOpen() const override;
+                bool doIsCompressed() const override;
             };
             friend class ZipCompressedFile;
         public:
@@ -50,7 +61,8 @@ namespace TrenchBroom {
         private:
             void doReadDirectory() override;
         private:
-            std::string filename(mz_uint fileIndex);
+            mz_zip_archive& threadArchive();
+            static std::string filename(mz_zip_archive& archive, mz_uint fileIndex);
         };
     }
 }
@@ -51,18 +51,11 @@
 
 namespace TrenchBroom {
     namespace Model {
-        class Brush::CopyCallback : public BrushGeometry::CopyCallback {
-        public:
-            void faceWasCopied(const BrushFaceGeometry* original, BrushFaceGeometry* copy) const override {
-                copy->setPayload(original->payload());
-            }
-        };
-
         Brush::Brush() {}
 
         Brush::Brush(const Brush& other) :
         m_faces(other.m_faces),
-        m_geometry(other.m_geometry ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback()) : nullptr) {
+        m_geometry(other.m_geometry) {
             if (m_geometry) {
                 for (BrushFaceGeometry* faceGeometry : m_geometry->faces()) {
                     if (const auto faceIndex = faceGeometry->payload()) {
@@ -100,11 +93,30 @@ namespace TrenchBroom {
                 .and_then([&]() { return std::move(brush); });
         }
 
+        kdl::result<Brush, BrushError> Brush::createWithGeometry(std::vector<BrushFace> faces, BrushGeometry geometry) {
+            if (faces.size() != geometry.faceCount()) {
+                return BrushError::IncompleteBrush;
+            }
+
+            Brush brush(std::move(faces));
+            brush.m_geometry = std::make_shared<BrushGeometry>(std::move(geometry));
+
+            size_t faceIndex = 0u;
+            for (BrushFaceGeometry* faceGeometry : brush.m_geometry->faces()) {
+                brush.m_faces[faceIndex].setGeometry(faceGeometry);
+                faceGeometry->setPayload(faceIndex);
+                ++faceIndex;
+            }
+
+            assert(brush.checkFaceLinks());
+            return std::move(brush);
+        }
+
         kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds) {
             // First, add all faces to the brush geometry
             BrushFace::sortFaces(m_faces);
             
-            auto geometry = std::make_unique<BrushGeometry>(worldBounds);
+            auto geometry = std::make_shared<BrushGeometry>(worldBounds);
             
             for (size_t i = 0u; i < m_faces.size(); ++i) {
                 BrushFace& face = m_faces[i];
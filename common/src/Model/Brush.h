@@ -41,8 +41,6 @@ namespace TrenchBroom {
 
         class Brush {
         private:
-            class CopyCallback;
-            
             /**
              * Epsilon value to use when finding a vertex after applying a vertex operation
              */
@@ -52,7 +50,16 @@ namespace TrenchBroom {
             using EdgeList = BrushEdgeList;
         private:
             std::vector<BrushFace> m_faces;
-            std::unique_ptr<BrushGeometry> m_geometry;
+
+            /**
+             * The geometry is shared between copies of this brush, and the faces of a copy are linked to the shared
+             * geometry. This makes copying a brush cheap, e.g. when taking snapshots for undo.
+             *
+             * A geometry, including the payloads of its faces and vertices, must not be modified once it has been
+             * assigned to a brush. Every operation that changes the shape of a brush creates a new geometry instead, so
+             * sharing it is safe.
+             */
+            std::shared_ptr<BrushGeometry> m_geometry;
         public:
             Brush();
 
@@ -65,6 +72,15 @@ namespace TrenchBroom {
             ~Brush();
             
             static kdl::result<Brush, BrushError> create(const vm::bbox3& worldBounds, std::vector<BrushFace> faces);
+
+            /**
+             * Creates a brush from the given faces and the given geometry that was computed from them earlier, e.g. a
+             * geometry restored from a snapshot. This skips clipping the geometry by the face boundaries.
+             *
+             * The faces must be in the order of the faces of the given geometry, which is the order of the faces of a
+             * brush created by create(). Returns an error if the number of faces does not match.
+             */
+            static kdl::result<Brush, BrushError> createWithGeometry(std::vector<BrushFace> faces, BrushGeometry geometry);
         private:
             Brush(std::vector<BrushFace> faces);
 
@@ -24,6 +24,8 @@
 #include "Assets/AssetReference.h"
 #include "Model/BrushFaceAttributes.h"
 #include "Model/BrushGeometry.h"
+#include "Model/ParallelTexCoordSystem.h" // stored by value in BrushFace::TexCoordSystemVariant
+#include "Model/ParaxialTexCoordSystem.h" // stored by value in BrushFace::TexCoordSystemVariant
 #include "Model/Tag.h" // BrushFace inherits from Taggable
 
 #include <kdl/result_forward.h>
@@ -34,9 +36,11 @@
 #include <vecmath/util.h>
 
 #include <array>
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace TrenchBroom {
@@ -81,17 +85,23 @@ namespace TrenchBroom {
         public:
             using VertexList = kdl::transform_adapter<BrushHalfEdgeList, TransformHalfEdgeToVertex>;
             using EdgeList = kdl::transform_adapter<BrushHalfEdgeList, TransformHalfEdgeToEdge>;
+
+            /**
+             * The texture coordinate system is stored inline to save an allocation and a pointer per face.
+             */
+            using TexCoordSystemVariant = std::variant<ParaxialTexCoordSystem, ParallelTexCoordSystem>;
         private:
             BrushFace::Points m_points;
             vm::plane3 m_boundary;
             BrushFaceAttributes m_attributes;
 
             Assets::AssetReference<Assets::Texture> m_textureReference;
-            std::unique_ptr<TexCoordSystem> m_texCoordSystem;
+            TexCoordSystemVariant m_texCoordSystem;
             BrushFaceGeometry* m_geometry;
 
-            mutable size_t m_lineNumber;
-            mutable size_t m_lineCount;
+            // 32 bits are plenty for line numbers and keep the face small
+            mutable uint32_t m_lineNumber;
+            mutable uint32_t m_lineCount;
             bool m_selected;
             
             // brush renderer
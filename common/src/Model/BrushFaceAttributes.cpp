@@ -87,6 +87,10 @@ namespace TrenchBroom {
         }
 
         const std::string& BrushFaceAttributes::textureName() const {
+            return m_textureName.str();
+        }
+
+        const kdl::interned_string& BrushFaceAttributes::internedTextureName() const {
             return m_textureName;
         }
 
@@ -151,10 +155,11 @@ namespace TrenchBroom {
         }
         
         bool BrushFaceAttributes::setTextureName(const std::string& textureName) {
-            if (textureName == m_textureName) {
+            const auto internedTextureName = kdl::interned_string{textureName};
+            if (internedTextureName == m_textureName) {
                 return false;
             } else {
-                m_textureName = textureName;
+                m_textureName = internedTextureName;
                 return true;
             }
         }
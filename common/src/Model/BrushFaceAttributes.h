@@ -21,6 +21,8 @@
 
 #include "Color.h"
 
+#include <kdl/interned_string.h>
+
 #include <vecmath/forward.h>
 
 #include <string>
@@ -36,7 +38,7 @@ namespace TrenchBroom {
         public:
             static const std::string NoTextureName;
         private:
-            std::string m_textureName;
+            kdl::interned_string m_textureName;
 
             vm::vec2f m_offset;
             vm::vec2f m_scale;
@@ -58,6 +60,7 @@ namespace TrenchBroom {
             friend void swap(BrushFaceAttributes& lhs, BrushFaceAttributes& rhs);
 
             const std::string& textureName() const;
+            const kdl::interned_string& internedTextureName() const;
 
             const vm::vec2f& offset() const;
             float xOffset() const;
@@ -58,6 +58,7 @@
 
 #include <algorithm> // for std::remove
 #include <iterator>
+#include <limits>
 #include <set>
 #include <string>
 #include <vector>
@@ -103,6 +104,7 @@ namespace TrenchBroom {
 
             using std::swap;
             swap(m_brush, brush);
+            m_facePlanes.clear();
             
             updateSelectedFaceCount();
             invalidateIssues();
@@ -321,7 +323,14 @@ namespace TrenchBroom {
         }
 
         std::optional<std::tuple<FloatType, size_t>> BrushNode::findFaceHit(const vm::ray3& ray) const {
-            if (!vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds()))) {
+            auto candidateFaceIndex = size_t(0);
+            if (!vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds())) && mayHitFaces(ray, candidateFaceIndex)) {
+                // the ray enters the brush through the candidate face unless it passes close to one of its edges
+                const auto candidateDistance = m_brush.face(candidateFaceIndex).intersectWithRay(ray);
+                if (!vm::is_nan(candidateDistance)) {
+                    return std::make_tuple(candidateDistance, candidateFaceIndex);
+                }
+
                 for (size_t i = 0u; i < m_brush.faceCount(); ++i) {
                     const auto& face = m_brush.face(i);
                     const auto distance = face.intersectWithRay(ray);
@@ -333,6 +342,69 @@ namespace TrenchBroom {
             return std::nullopt;
         }
 
+        bool BrushNode::mayHitFaces(const vm::ray3& ray, size_t& candidateFaceIndex) const {
+            validateFacePlanes();
+
+            const auto faceCount = m_brush.faceCount();
+            const auto* normalX = m_facePlanes.data();
+            const auto* normalY = normalX + faceCount;
+            const auto* normalZ = normalY + faceCount;
+            const auto* distance = normalZ + faceCount;
+
+            const auto epsilon = vm::constants<FloatType>::point_status_epsilon();
+            const auto& origin = ray.origin;
+            const auto& direction = ray.direction;
+
+            // This loop has no branches and no dependencies between iterations so that it can be vectorized.
+            auto enterDistance = -std::numeric_limits<FloatType>::infinity();
+            auto exitDistance = std::numeric_limits<FloatType>::infinity();
+            auto outside = false;
+            for (size_t i = 0u; i < faceCount; ++i) {
+                const auto cos = normalX[i] * direction.x() + normalY[i] * direction.y() + normalZ[i] * direction.z();
+                const auto dist = normalX[i] * origin.x() + normalY[i] * origin.y() + normalZ[i] * origin.z() - distance[i] - epsilon;
+                const auto t = -dist / cos;
+
+                enterDistance = cos < FloatType(0) ? std::max(enterDistance, t) : enterDistance;
+                exitDistance = cos > FloatType(0) ? std::min(exitDistance, t) : exitDistance;
+                outside = outside || (cos == FloatType(0) && dist > FloatType(0));
+            }
+
+            if (outside || exitDistance < FloatType(0) || enterDistance > exitDistance) {
+                return false;
+            }
+
+            auto maxEnter = -std::numeric_limits<FloatType>::infinity();
+            for (size_t i = 0u; i < faceCount; ++i) {
+                const auto cos = normalX[i] * direction.x() + normalY[i] * direction.y() + normalZ[i] * direction.z();
+                if (cos < FloatType(0)) {
+                    const auto dist = normalX[i] * origin.x() + normalY[i] * origin.y() + normalZ[i] * origin.z() - distance[i] - epsilon;
+                    const auto t = -dist / cos;
+                    if (t > maxEnter) {
+                        maxEnter = t;
+                        candidateFaceIndex = i;
+                    }
+                }
+            }
+
+            return maxEnter > -std::numeric_limits<FloatType>::infinity();
+        }
+
+        void BrushNode::validateFacePlanes() const {
+            const auto faceCount = m_brush.faceCount();
+            if (m_facePlanes.size() == 4u * faceCount) {
+                return;
+            }
+
+            m_facePlanes.resize(4u * faceCount);
+            for (size_t i = 0u; i < faceCount; ++i) {
+                const auto& boundary = m_brush.face(i).boundary();
+                m_facePlanes[i] = boundary.normal.x();
+                m_facePlanes[faceCount + i] = boundary.normal.y();
+                m_facePlanes[2u * faceCount + i] = boundary.normal.z();
+                m_facePlanes[3u * faceCount + i] = boundary.distance;
+            }
+        }
+
         Node* BrushNode::doGetContainer() {
             return parent();
         }
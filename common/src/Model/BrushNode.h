@@ -63,6 +63,12 @@ namespace TrenchBroom {
             mutable std::unique_ptr<Renderer::BrushRendererBrushCache> m_brushRendererBrushCache; // unique_ptr for breaking header dependencies
             Brush m_brush; // must be destroyed before the brush renderer cache
             size_t m_selectedFaceCount = 0u;
+
+            /**
+             * The face boundary planes in structure of arrays layout: the x, y and z components of all normals
+             * followed by all distances. Built on demand for picking and cleared when the brush is replaced.
+             */
+            mutable std::vector<FloatType> m_facePlanes;
         public:
             explicit BrushNode(Brush brush);
             ~BrushNode() override;
@@ -114,6 +120,16 @@ namespace TrenchBroom {
 
             std::optional<std::tuple<FloatType, size_t>> findFaceHit(const vm::ray3& ray) const;
 
+            /**
+             * Clips the given ray against all face planes at once. Returns false if the ray misses this brush.
+             * Otherwise, the index of the face through which the ray enters this brush is stored in the given index.
+             *
+             * The planes are moved outwards by an epsilon to account for the rounding of the brush vertices, so the
+             * ray may still miss the face polygons if this returns true.
+             */
+            bool mayHitFaces(const vm::ray3& ray, size_t& candidateFaceIndex) const;
+            void validateFacePlanes() const;
+
             Node* doGetContainer() override;
             LayerNode* doGetContainingLayer() override;
             GroupNode* doGetContainingGroup() override;
@@ -52,11 +52,12 @@ namespace TrenchBroom {
         }
 
         int CompareHitsByType::doCompare(const Hit& lhs, const Hit& rhs) const {
-            if (lhs.type() == BrushNode::BrushHitType)
-                return -1;
-            if (rhs.type() == BrushNode::BrushHitType)
-                return 1;
-            return 0;
+            // brush hits come first, but must be equal to each other for this to be a strict weak ordering
+            const bool lhsIsBrushHit = lhs.type() == BrushNode::BrushHitType;
+            const bool rhsIsBrushHit = rhs.type() == BrushNode::BrushHitType;
+            if (lhsIsBrushHit == rhsIsBrushHit)
+                return 0;
+            return lhsIsBrushHit ? -1 : 1;
         }
 
         int CompareHitsByDistance::doCompare(const Hit& lhs, const Hit& rhs) const {
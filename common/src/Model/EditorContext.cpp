@@ -36,7 +36,8 @@
 
 namespace TrenchBroom {
     namespace Model {
-        EditorContext::EditorContext() {
+        EditorContext::EditorContext() :
+        m_revision(0u) {
             reset();
         }
 
@@ -45,6 +46,11 @@ namespace TrenchBroom {
             m_hiddenEntityDefinitions.reset();
             m_blockSelection = false;
             m_currentGroup = nullptr;
+            ++m_revision;
+        }
+
+        size_t EditorContext::revision() const {
+            return m_revision;
         }
 
         TagType::Type EditorContext::hiddenTags() const {
@@ -54,6 +60,7 @@ namespace TrenchBroom {
         void EditorContext::setHiddenTags(const TagType::Type hiddenTags) {
             if (hiddenTags != m_hiddenTags) {
                 m_hiddenTags = hiddenTags;
+                ++m_revision;
                 editorContextDidChangeNotifier();
             }
         }
@@ -69,6 +76,7 @@ namespace TrenchBroom {
         void EditorContext::setEntityDefinitionHidden(const Assets::EntityDefinition* definition, const bool hidden) {
             if (definition != nullptr && entityDefinitionHidden(definition) != hidden) {
                 m_hiddenEntityDefinitions[definition->index()] = hidden;
+                ++m_revision;
                 editorContextDidChangeNotifier();
             }
         }
@@ -80,6 +88,7 @@ namespace TrenchBroom {
         void EditorContext::setBlockSelection(const bool blockSelection) {
             if (m_blockSelection != blockSelection) {
                 m_blockSelection = blockSelection;
+                ++m_revision;
                 editorContextDidChangeNotifier();
             }
         }
@@ -97,6 +106,7 @@ namespace TrenchBroom {
             }
             m_currentGroup = groupNode;
             m_currentGroup->open();
+            ++m_revision;
         }
 
         void EditorContext::popGroup() {
@@ -106,6 +116,7 @@ namespace TrenchBroom {
             if (m_currentGroup != nullptr) {
                 m_currentGroup->open();
             }
+            ++m_revision;
         }
 
         bool EditorContext::visible(const Model::Node* node) const {
@@ -49,6 +49,8 @@ namespace TrenchBroom {
             bool m_blockSelection;
 
             Model::GroupNode* m_currentGroup;
+
+            size_t m_revision;
         public:
             Notifier<> editorContextDidChangeNotifier;
         public:
@@ -56,6 +58,16 @@ namespace TrenchBroom {
 
             void reset();
 
+            /**
+             * Returns a number that changes whenever the state of this context changes, i.e. its hidden tags, hidden
+             * entity definitions, selection blocking or current group.
+             *
+             * Note that visible() also depends on preferences such as Preferences::ShowBrushes and
+             * Preferences::ShowPointEntities, which do not change the revision. Callers that cache results depending
+             * on visibility must also observe preference changes.
+             */
+            size_t revision() const;
+
             TagType::Type hiddenTags() const;
             void setHiddenTags(TagType::Type hiddenTags);
 
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <kdl/interned_string.h>
+
 #include <iosfwd>
 #include <string>
 #include <vector>
@@ -77,7 +79,7 @@ namespace TrenchBroom {
 
         class EntityProperty {
         private:
-            std::string m_key;
+            kdl::interned_string m_key;
             std::string m_value;
         public:
             EntityProperty();
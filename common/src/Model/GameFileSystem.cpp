@@ -26,42 +26,65 @@
 #include "IO/DkPakFileSystem.h"
 #include "IO/IdPakFileSystem.h"
 #include "IO/FileMatcher.h"
+#include "IO/ImageFileSystem.h"
 #include "IO/Quake3ShaderFileSystem.h"
 #include "IO/SystemPaths.h"
 #include "IO/ZipFileSystem.h"
 #include "Model/GameConfig.h"
 
 #include <kdl/string_compare.h>
+#include <kdl/string_format.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
 #include <memory>
 
 namespace TrenchBroom {
     namespace Model {
+        static std::string indexKey(const IO::Path& path) {
+            return kdl::str_to_lower(path.asString("/"));
+        }
+
         GameFileSystem::GameFileSystem() :
         FileSystem(),
         m_shaderFS(nullptr) {}
 
+        GameFileSystem::~GameFileSystem() = default;
+
         void GameFileSystem::initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger) {
-            // delete the existing file system
-            releaseNext();
+            // keep the existing file systems around so that they can be reused
+            auto previousMounts = std::move(m_mounts);
+            m_mounts.clear();
             m_shaderFS = nullptr;
 
-            addDefaultAssetPaths(config, logger);
+            addDefaultAssetPaths(config, previousMounts, logger);
+
+            if (!gamePath.isEmpty() && IO::Disk::directoryExists(gamePath)) {
+                addGameFileSystems(config, gamePath, additionalSearchPaths, previousMounts, logger);
+            }
+
+            rebuildIndex();
 
             if (!gamePath.isEmpty() && IO::Disk::directoryExists(gamePath)) {
-                addGameFileSystems(config, gamePath, additionalSearchPaths, logger);
                 addShaderFileSystem(config, logger);
             }
         }
 
         void GameFileSystem::reloadShaders() {
             if (m_shaderFS != nullptr) {
+                // the shader file system reads the shaders from the other mounts, so we must hide it while reloading
+                auto shaderMount = std::move(m_mounts.back());
+                m_mounts.pop_back();
+                rebuildIndex();
+
                 m_shaderFS->reload();
+
+                m_mounts.push_back(std::move(shaderMount));
+                addToIndex(m_mounts.size() - 1u);
             }
         }
 
-        void GameFileSystem::addDefaultAssetPaths(const GameConfig& config, Logger& logger) {
+        void GameFileSystem::addDefaultAssetPaths(const GameConfig& config, std::vector<Mount>& previousMounts, Logger& logger) {
             // There are two ways of providing default assets: The 'defaults/assets' folder in TrenchBroom's resources folder, and the
             // 'assets' folder in the game configuration folders. We add filesystems for both types here.
             
@@ -81,32 +104,32 @@ namespace TrenchBroom {
                     }    
                 };
                 if (exists(defaultAssetsPath)) {
-                    addFileSystemPath(defaultAssetsPath, logger);
+                    addFileSystemPath(defaultAssetsPath, previousMounts, logger);
                 }
             }
         }
 
-        void GameFileSystem::addGameFileSystems(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger) {
+        void GameFileSystem::addGameFileSystems(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, std::vector<Mount>& previousMounts, Logger& logger) {
             const auto& fileSystemConfig = config.fileSystemConfig();
-            addFileSystemPath(gamePath + fileSystemConfig.searchPath, logger);
-            addFileSystemPackages(config, gamePath + fileSystemConfig.searchPath, logger);
+            addFileSystemPath(gamePath + fileSystemConfig.searchPath, previousMounts, logger);
+            addFileSystemPackages(config, gamePath + fileSystemConfig.searchPath, previousMounts, logger);
 
             for (const auto& searchPath : additionalSearchPaths) {
-                addFileSystemPath(gamePath + searchPath, logger);
-                addFileSystemPackages(config, gamePath + searchPath, logger);
+                addFileSystemPath(gamePath + searchPath, previousMounts, logger);
+                addFileSystemPackages(config, gamePath + searchPath, previousMounts, logger);
             }
         }
 
-        void GameFileSystem::addFileSystemPath(const IO::Path& path, Logger& logger) {
+        void GameFileSystem::addFileSystemPath(const IO::Path& path, std::vector<Mount>& previousMounts, Logger& logger) {
             try {
                 logger.info() << "Adding file system path " << path;
-                m_next = std::make_shared<IO::DiskFileSystem>(m_next, path);
+                addMount(path, false, previousMounts, [&]() { return std::make_shared<IO::DiskFileSystem>(path); });
             } catch (const FileSystemException& e) {
                 logger.error() << "Could not add file system search path '" << path << "': " << e.what();
             }
         }
 
-        void GameFileSystem::addFileSystemPackages(const GameConfig& config, const IO::Path& searchPath, Logger& logger) {
+        void GameFileSystem::addFileSystemPackages(const GameConfig& config, const IO::Path& searchPath, std::vector<Mount>& previousMounts, Logger& logger) {
             const auto& fileSystemConfig = config.fileSystemConfig();
             const auto& packageFormatConfig = fileSystemConfig.packageFormat;
 
@@ -120,15 +143,16 @@ namespace TrenchBroom {
 
                 for (const auto& packagePath : packages) {
                     try {
+                        const auto absolutePackagePath = diskFS.makeAbsolute(packagePath);
                         if (kdl::ci::str_is_equal(packageFormat, "idpak")) {
                             logger.info() << "Adding file system package " << packagePath;
-                            m_next = std::make_shared<IO::IdPakFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
+                            addMount(absolutePackagePath, true, previousMounts, [&]() { return std::make_shared<IO::IdPakFileSystem>(absolutePackagePath); });
                         } else if (kdl::ci::str_is_equal(packageFormat, "dkpak")) {
                             logger.info() << "Adding file system package " << packagePath;
-                            m_next = std::make_shared<IO::DkPakFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
+                            addMount(absolutePackagePath, true, previousMounts, [&]() { return std::make_shared<IO::DkPakFileSystem>(absolutePackagePath); });
                         } else if (kdl::ci::str_is_equal(packageFormat, "zip")) {
                             logger.info() << "Adding file system package " << packagePath;
-                            m_next = std::make_shared<IO::ZipFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
+                            addMount(absolutePackagePath, true, previousMounts, [&]() { return std::make_shared<IO::ZipFileSystem>(absolutePackagePath); });
                         }
                     } catch (const std::exception& e) {
                         logger.error() << e.what();
@@ -149,25 +173,136 @@ namespace TrenchBroom {
                     textureConfig.package.rootDirectory,
                     IO::Path("models")
                 };
-                auto shaderFS = std::make_shared<IO::Quake3ShaderFileSystem>(m_next, std::move(shaderSearchPath), std::move(textureSearchPaths), logger);
+
+                // the linked shaders are cached per game
+                auto cachePath = IO::SystemPaths::userDataDirectory() + IO::Path("cache") + IO::Path(config.name() + ".shaders");
+
+                // the shader file system reads the shaders and textures through this file system, which it doesn't own
+                auto mountedFS = std::shared_ptr<IO::FileSystem>{std::shared_ptr<IO::FileSystem>{}, this};
+                auto shaderFS = std::make_shared<IO::Quake3ShaderFileSystem>(std::move(mountedFS), std::move(shaderSearchPath), std::move(textureSearchPaths), logger, std::move(cachePath));
                 m_shaderFS = shaderFS.get();
-                m_next = std::move(shaderFS);
+                m_mounts.push_back(Mount{IO::Path(), std::move(shaderFS), true, std::nullopt});
+                addToIndex(m_mounts.size() - 1u);
             }
         }
 
-        bool GameFileSystem::doDirectoryExists(const IO::Path& /* path */) const {
-            return false;
+        template <typename CreateFileSystem>
+        void GameFileSystem::addMount(const IO::Path& path, const bool indexed, std::vector<Mount>& previousMounts, const CreateFileSystem& createFileSystem) {
+            // a package may have been replaced by a different version since it was mounted
+            const auto stamp = indexed ? IO::Disk::fileStamp(path) : std::nullopt;
+            const auto it = std::find_if(std::begin(previousMounts), std::end(previousMounts), [&](const auto& mount) {
+                return mount.path == path && mount.indexed == indexed && mount.stamp == stamp;
+            });
+            if (it != std::end(previousMounts)) {
+                m_mounts.push_back(std::move(*it));
+                previousMounts.erase(it);
+            } else {
+                m_mounts.push_back(Mount{path, createFileSystem(), indexed, stamp});
+            }
         }
 
-        bool GameFileSystem::doFileExists(const IO::Path& /* path */) const {
-            return false;
+        void GameFileSystem::rebuildIndex() {
+            m_fileIndex.clear();
+            m_directoryIndex.clear();
+            for (size_t i = 0; i < m_mounts.size(); ++i) {
+                addToIndex(i);
+            }
         }
 
-        std::vector<IO::Path> GameFileSystem::doGetDirectoryContents(const IO::Path& /* path */) const {
-            return std::vector<IO::Path>();
+        void GameFileSystem::addToIndex(const size_t mountIndex) {
+            const auto& mount = m_mounts[mountIndex];
+            if (!mount.indexed) {
+                return;
+            }
+
+            const auto& imageFS = static_cast<const IO::ImageFileSystemBase&>(*mount.fileSystem);
+            for (const auto& filePath : imageFS.filePaths()) {
+                // later mounts shadow earlier mounts
+                m_fileIndex[indexKey(filePath)] = mountIndex;
+
+                auto path = filePath;
+                while (!path.isEmpty()) {
+                    const auto name = path.lastComponent();
+                    path = path.deleteLastComponent();
+                    if (!m_directoryIndex[indexKey(path)].insert(name).second) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        std::optional<size_t> GameFileSystem::findFileMount(const IO::Path& path) const {
+            const auto it = m_fileIndex.find(indexKey(path));
+            const auto indexedMount = it != std::end(m_fileIndex) ? std::optional<size_t>{it->second} : std::nullopt;
+
+            // directories on the disk shadow the indexed mount if they were mounted after it
+            const auto firstMount = indexedMount ? *indexedMount + 1u : 0u;
+            for (size_t i = m_mounts.size(); i > firstMount; --i) {
+                const auto& mount = m_mounts[i - 1u];
+                if (!mount.indexed && mount.fileSystem->fileExists(path)) {
+                    return i - 1u;
+                }
+            }
+            return indexedMount;
+        }
+
+        IO::Path GameFileSystem::doMakeAbsolute(const IO::Path& path) const {
+            if (const auto mountIndex = findFileMount(path)) {
+                return m_mounts[*mountIndex].fileSystem->makeAbsolute(path);
+            }
+            // only the directories on the disk have absolute paths
+            for (auto it = m_mounts.rbegin(); it != m_mounts.rend(); ++it) {
+                if (!it->indexed && it->fileSystem->directoryExists(path)) {
+                    return it->fileSystem->makeAbsolute(path);
+                }
+            }
+            throw FileSystemException("Cannot make absolute path of '" + path.asString() + "'");
+        }
+
+        bool GameFileSystem::doDirectoryExists(const IO::Path& path) const {
+            const auto key = indexKey(path);
+            if (m_directoryIndex.count(key) > 0u) {
+                return true;
+            }
+            if (m_fileIndex.count(key) > 0u) {
+                // don't check the disk for every file when searching a package recursively
+                return false;
+            }
+            return std::any_of(std::begin(m_mounts), std::end(m_mounts), [&](const auto& mount) {
+                return !mount.indexed && mount.fileSystem->directoryExists(path);
+            });
+        }
+
+        bool GameFileSystem::doFileExists(const IO::Path& path) const {
+            if (m_fileIndex.count(indexKey(path)) > 0u) {
+                return true;
+            }
+            return std::any_of(std::begin(m_mounts), std::end(m_mounts), [&](const auto& mount) {
+                return !mount.indexed && mount.fileSystem->fileExists(path);
+            });
+        }
+
+        std::vector<IO::Path> GameFileSystem::doGetDirectoryContents(const IO::Path& path) const {
+            auto result = std::vector<IO::Path>{};
+
+            const auto it = m_directoryIndex.find(indexKey(path));
+            if (it != std::end(m_directoryIndex)) {
+                result.insert(std::end(result), std::begin(it->second), std::end(it->second));
+            }
+
+            for (const auto& mount : m_mounts) {
+                if (!mount.indexed && mount.fileSystem->directoryExists(path)) {
+                    result = kdl::vec_concat(std::move(result), mount.fileSystem->getDirectoryContents(path));
+                }
+            }
+
+            return kdl::vec_sort_and_remove_duplicates(std::move(result));
         }
 
         std::shared_ptr<IO::File> GameFileSystem::doOpenFile(const IO::Path& path) const {
+            if (const auto mountIndex = findFileMount(path)) {
+                return m_mounts[*mountIndex].fileSystem->openFile(path);
+            }
             throw FileSystemException("File not found: '" + path.asString() + "'");
         }
     }
@@ -19,36 +19,82 @@
 
 #pragma once
 
+#include "IO/DiskIO.h"
 #include "IO/FileSystem.h"
+#include "IO/Path.h"
+
+#include <kdl/string_compare.h>
 
 #include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
     class Logger;
 
     namespace IO {
-        class Path;
         class Quake3ShaderFileSystem;
     }
 
     namespace Model {
         class GameConfig;
 
+        /**
+         * Provides access to the files of a game, its mods and the default assets.
+         *
+         * The file systems of the search paths and packages are mounted side by side instead of being chained. Later
+         * mounts shadow earlier mounts. The contents of all packages are merged into one index that maps every path to
+         * the mount that provides it, so that looking up a file doesn't depend on the number of mounts. Directories on
+         * the disk are not indexed because their contents may change, but there are only a few of them.
+         */
         class GameFileSystem : public IO::FileSystem {
         private:
+            struct Mount {
+                IO::Path path;
+                std::shared_ptr<IO::FileSystem> fileSystem;
+                bool indexed;
+                // the stamp of the package file when it was mounted, empty for directories
+                std::optional<IO::Disk::FileStamp> stamp;
+            };
+
+            using NameSet = std::set<IO::Path, IO::Path::Less<kdl::ci::string_less>>;
+
+            std::vector<Mount> m_mounts;
             IO::Quake3ShaderFileSystem* m_shaderFS;
+
+            // maps lower case paths to the index of the indexed mount with the highest priority that contains them
+            std::unordered_map<std::string, size_t> m_fileIndex;
+            // maps lower case directory paths to the merged contents of the indexed mounts
+            std::unordered_map<std::string, NameSet> m_directoryIndex;
         public:
             GameFileSystem();
+            ~GameFileSystem() override;
+
+            /**
+             * Mounts the file systems for the given configuration and search paths. File systems that were already
+             * mounted for the same path are reused unless the package file was modified since, so that adding or
+             * removing a mod only reads the new packages.
+             */
             void initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger);
             void reloadShaders();
         private:
-            void addDefaultAssetPaths(const GameConfig& config, Logger& logger);
-            void addGameFileSystems(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger);
+            void addDefaultAssetPaths(const GameConfig& config, std::vector<Mount>& previousMounts, Logger& logger);
+            void addGameFileSystems(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, std::vector<Mount>& previousMounts, Logger& logger);
             void addShaderFileSystem(const GameConfig& config, Logger& logger);
-            void addFileSystemPath(const IO::Path& path, Logger& logger);
-            void addFileSystemPackages(const GameConfig& config, const IO::Path& searchPath, Logger& logger);
+            void addFileSystemPath(const IO::Path& path, std::vector<Mount>& previousMounts, Logger& logger);
+            void addFileSystemPackages(const GameConfig& config, const IO::Path& searchPath, std::vector<Mount>& previousMounts, Logger& logger);
+
+            template <typename CreateFileSystem>
+            void addMount(const IO::Path& path, bool indexed, std::vector<Mount>& previousMounts, const CreateFileSystem& createFileSystem);
+
+            void rebuildIndex();
+            void addToIndex(size_t mountIndex);
+            std::optional<size_t> findFileMount(const IO::Path& path) const;
         private:
+            IO::Path doMakeAbsolute(const IO::Path& path) const override;
             bool doDirectoryExists(const IO::Path& path) const override;
             bool doFileExists(const IO::Path& path) const override;
             std::vector<IO::Path> doGetDirectoryContents(const IO::Path& path) const override;
@@ -56,4 +102,3 @@ namespace TrenchBroom {
         };
     }
 }
-
@@ -23,6 +23,8 @@
 #include "Exceptions.h"
 #include "Logger.h"
 #include "Macros.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "Assets/Palette.h"
 #include "Assets/EntityModel.h"
 #include "Assets/EntityDefinitionFileSpec.h"
@@ -39,6 +41,7 @@
 #include "IO/FileMatcher.h"
 #include "IO/GameConfigParser.h"
 #include "IO/IOUtils.h"
+#include "IO/MapSnapshot.h"
 #include "IO/MdlParser.h"
 #include "IO/Md2Parser.h"
 #include "IO/Md3Parser.h"
@@ -178,12 +181,21 @@ namespace TrenchBroom {
         std::unique_ptr<WorldNode> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const {
             IO::SimpleParserStatus parserStatus(logger);
             auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+            // the file is memory mapped, so buffering does not copy its contents and the map is parsed in place
             auto fileReader = file->reader().buffer();
-            if (format == MapFormat::Unknown) {
+
+            const auto possibleFormats = format == MapFormat::Unknown
                 // Try all formats listed in the game config
-                const auto possibleFormats = kdl::vec_transform(m_config.fileFormats(), [](const MapFormatConfig& config) {
+                ? kdl::vec_transform(m_config.fileFormats(), [](const MapFormatConfig& config) {
                     return Model::formatFromName(config.format);
-                });
+                })
+                : std::vector<MapFormat>{format};
+
+            if (pref(Preferences::CacheMapSnapshots)) {
+                return loadMapWithSnapshot(fileReader.stringView(), possibleFormats, worldBounds, path, parserStatus, logger);
+            }
+
+            if (format == MapFormat::Unknown) {
                 return IO::WorldReader::tryRead(fileReader.stringView(), possibleFormats, worldBounds, parserStatus);
             } else {
                 IO::WorldReader worldReader(fileReader.stringView(), format);
@@ -191,6 +203,53 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Returns the contents of the file that the given game configuration was loaded from. If the file cannot be
+         * read, e.g. because the configuration was not loaded from a file, the name of the game is returned instead.
+         */
+        static std::string readGameConfigContents(const GameConfig& config) {
+            try {
+                auto file = IO::Disk::openFile(IO::Disk::fixPath(config.path()));
+                auto reader = file->reader().buffer();
+                return std::string{reader.stringView()};
+            } catch (const Exception&) {
+                return config.name();
+            }
+        }
+
+        /**
+         * Restores the world from the snapshot file next to the map file if that snapshot was recorded for the
+         * current file contents. Otherwise, the map file is parsed and a new snapshot is written.
+         *
+         * Problems with the snapshot file are never fatal since the map file can always be parsed instead.
+         */
+        std::unique_ptr<WorldNode> GameImpl::loadMapWithSnapshot(const std::string_view str, const std::vector<MapFormat>& possibleFormats, const vm::bbox3& worldBounds, const IO::Path& path, IO::ParserStatus& parserStatus, Logger& logger) const {
+            const auto snapshotKey = IO::computeMapSnapshotKey(str, readGameConfigContents(m_config), possibleFormats, worldBounds);
+            const auto snapshotPath = IO::mapSnapshotPath(IO::Disk::fixPath(path));
+
+            if (IO::Disk::fileExists(snapshotPath)) {
+                try {
+                    auto snapshotFile = IO::Disk::openFile(snapshotPath);
+                    auto snapshotReader = snapshotFile->reader().buffer();
+                    if (auto worldNode = IO::WorldReader::readSnapshot(snapshotReader.stringView(), snapshotKey, worldBounds, parserStatus)) {
+                        logger.debug() << "Restored map from snapshot " << snapshotPath.asString();
+                        return worldNode;
+                    }
+                } catch (const Exception& e) {
+                    logger.warn() << "Could not read map snapshot " << snapshotPath.asString() << ": " << e.what();
+                }
+            }
+
+            auto [worldNode, snapshot] = IO::WorldReader::tryReadAndRecordSnapshot(str, possibleFormats, snapshotKey, worldBounds, parserStatus);
+
+            auto snapshotStream = openPathAsOutputStream(snapshotPath, std::ios::out | std::ios::binary);
+            if (!snapshotStream || !snapshotStream.write(snapshot.data(), static_cast<std::streamsize>(snapshot.size()))) {
+                logger.warn() << "Could not write map snapshot " << snapshotPath.asString();
+            }
+
+            return std::move(worldNode);
+        }
+
         void GameImpl::doWriteMap(WorldNode& world, const IO::Path& path, const bool exporting) const {
             const auto mapFormatName = formatName(world.mapFormat());
 
@@ -272,7 +331,7 @@ namespace TrenchBroom {
             const auto paths = extractTextureCollections(entity);
 
             const auto fileSearchPaths = textureCollectionSearchPaths(documentPath);
-            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger);
+            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger, pref(Preferences::LoadTexturesOnDemand));
             textureLoader.loadTextures(paths, textureManager);
         }
 
@@ -368,17 +427,17 @@ namespace TrenchBroom {
                 auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
                 auto reader = file->reader().buffer();
                 IO::FgdParser parser(reader.stringView(), defaultColor, file->path());
-                return parser.parseDefinitions(status);
+                return parser.parseDefinitions(status, file->path());
             } else if (kdl::ci::str_is_equal("def", extension)) {
                 auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
                 auto reader = file->reader().buffer();
                 IO::DefParser parser(reader.stringView(), defaultColor);
-                return parser.parseDefinitions(status);
+                return parser.parseDefinitions(status, file->path());
             } else if (kdl::ci::str_is_equal("ent", extension)) {
                 auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
                 auto reader = file->reader().buffer();
                 IO::EntParser parser(reader.stringView(), defaultColor);
-                return parser.parseDefinitions(status);
+                return parser.parseDefinitions(status, file->path());
             } else {
                 throw GameException("Unknown entity definition format: '" + path.asString() + "'");
             }
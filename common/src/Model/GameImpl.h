@@ -27,11 +27,16 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace TrenchBroom {
     class Logger;
 
+    namespace IO {
+        class ParserStatus;
+    }
+
     namespace Assets {
         class Palette;
     }
@@ -107,6 +112,7 @@ namespace TrenchBroom {
             const BrushFaceAttributes& doDefaultFaceAttribs() const override;
             const std::vector<CompilationTool>& doCompilationTools() const override;
         private:
+            std::unique_ptr<WorldNode> loadMapWithSnapshot(std::string_view str, const std::vector<MapFormat>& possibleFormats, const vm::bbox3& worldBounds, const IO::Path& path, IO::ParserStatus& parserStatus, Logger& logger) const;
             void writeLongAttribute(EntityNodeBase& node, const std::string& baseName, const std::string& value, size_t maxLength) const;
             std::string readLongAttribute(const EntityNodeBase& node, const std::string& baseName) const;
         };
@@ -30,6 +30,7 @@
 
 #include <vecmath/bbox.h>
 
+#include <atomic>
 #include <cassert>
 #include <iterator>
 #include <ostream>
@@ -74,6 +75,7 @@ namespace TrenchBroom {
         Node::~Node() {
             clearChildren();
             clearIssues();
+            clearCachedSerialization();
         }
 
         const std::string& Node::name() const {
@@ -415,12 +417,14 @@ namespace TrenchBroom {
             if (m_parent != nullptr)
                 m_parent->childWillChange(this);
             invalidateIssues();
+            clearCachedSerialization();
         }
 
         void Node::nodeDidChange() {
             if (m_parent != nullptr)
                 m_parent->childDidChange(this);
             invalidateIssues();
+            clearCachedSerialization();
         }
 
         Node::NotifyNodeChange::NotifyNodeChange(Node* node) :
@@ -674,6 +678,37 @@ namespace TrenchBroom {
             return lineNumber >= m_lineNumber && lineNumber < m_lineNumber + m_lineCount;
         }
 
+        std::shared_ptr<const CachedSerialization> Node::cachedSerialization(const MapFormat format) const {
+            return m_cachedSerialization && m_cachedSerialization->format == format ? m_cachedSerialization : nullptr;
+        }
+
+        static std::atomic<size_t> totalCachedSerializationBytes{0u};
+
+        void Node::setCachedSerialization(std::shared_ptr<const CachedSerialization> cachedSerialization) const {
+            clearCachedSerialization();
+            if (cachedSerialization) {
+                const auto bytes = cachedSerialization->text.size();
+                auto total = totalCachedSerializationBytes.load();
+                do {
+                    if (bytes > MaxCachedSerializationBytes - total) {
+                        return;
+                    }
+                } while (!totalCachedSerializationBytes.compare_exchange_weak(total, total + bytes));
+                m_cachedSerialization = std::move(cachedSerialization);
+            }
+        }
+
+        size_t Node::cachedSerializationBytes() {
+            return totalCachedSerializationBytes.load();
+        }
+
+        void Node::clearCachedSerialization() const {
+            if (m_cachedSerialization) {
+                totalCachedSerializationBytes -= m_cachedSerialization->text.size();
+                m_cachedSerialization.reset();
+            }
+        }
+
         const std::vector<Issue*>& Node::issues(const std::vector<IssueGenerator*>& issueGenerators) {
             validateIssues(issueGenerators);
             return m_issues;
@@ -41,6 +41,7 @@ namespace TrenchBroom {
         class Issue;
         class IssueGenerator;
         enum class LockState;
+        enum class MapFormat;
         class NodeVisitor;
         class PickResult;
         enum class VisibilityState;
@@ -53,6 +54,15 @@ namespace TrenchBroom {
         bool operator!=(const NodePath& lhs, const NodePath& rhs);
         std::ostream& operator<<(std::ostream& str, const NodePath& path);
 
+        /**
+         * The text that a map file serializer produced for a node.
+         */
+        struct CachedSerialization {
+            MapFormat format;
+            std::string text;
+            size_t lineCount;
+        };
+
         class Node : public Taggable {
         private:
             Node* m_parent;
@@ -72,6 +82,8 @@ namespace TrenchBroom {
             mutable std::vector<Issue*> m_issues;
             mutable bool m_issuesValid;
             IssueType m_hiddenIssues;
+
+            mutable std::shared_ptr<const CachedSerialization> m_cachedSerialization;
         protected:
             Node();
         private:
@@ -326,6 +338,32 @@ namespace TrenchBroom {
             size_t lineNumber() const;
             void setFilePosition(size_t lineNumber, size_t lineCount) const;
             bool containsLine(size_t lineNumber) const;
+        public: // serialization cache
+            /**
+             * The maximum total number of bytes of the texts cached on all nodes.
+             */
+            static constexpr size_t MaxCachedSerializationBytes = 128u * 1024u * 1024u;
+
+            /**
+             * Returns the text that was cached when this node was last serialized in the given format, or null if
+             * there is no such text or if this node has changed since.
+             */
+            std::shared_ptr<const CachedSerialization> cachedSerialization(MapFormat format) const;
+
+            /**
+             * Caches the given text on this node, replacing any previously cached text. The text is not cached if
+             * that would exceed MaxCachedSerializationBytes.
+             *
+             * Threadsafe as long as no two threads access the same node.
+             */
+            void setCachedSerialization(std::shared_ptr<const CachedSerialization> cachedSerialization) const;
+
+            /**
+             * Returns the total number of bytes of the texts cached on all nodes.
+             */
+            static size_t cachedSerializationBytes();
+        private:
+            void clearCachedSerialization() const;
         public: // issue management
             const std::vector<Issue*>& issues(const std::vector<IssueGenerator*>& issueGenerators);
 
@@ -43,9 +43,11 @@ namespace TrenchBroom {
         };
 
         PickResult::PickResult(std::shared_ptr<CompareHits> compare) :
+        m_sorted(true),
         m_compare(std::move(compare)) {}
 
         PickResult::PickResult() :
+        m_sorted(true),
         m_compare(std::make_shared<CompareHitsByDistance>()) {}
 
         PickResult::~PickResult() = default;
@@ -74,17 +76,18 @@ namespace TrenchBroom {
             if (vm::is_nan(hit.distance()) || vm::is_nan(hit.hitPoint())) {
                 return;
             }
-            ensure(m_compare.get() != nullptr, "compare is null");
-            auto pos = std::upper_bound(std::begin(m_hits), std::end(m_hits), hit, CompareWrapper(m_compare.get()));
-            m_hits.insert(pos, hit);
+            m_hits.push_back(hit);
+            m_sorted = false;
         }
 
         const std::vector<Hit>& PickResult::all() const {
+            sortHits();
             return m_hits;
         }
 
         const Hit& PickResult::first(const HitFilter& filter) const {
             const auto occluder = HitFilters::type(HitType::AnyType);
+            sortHits();
 
             if (!m_hits.empty()) {
                 auto it = std::begin(m_hits);
@@ -121,11 +124,22 @@ namespace TrenchBroom {
         }
 
         std::vector<Hit> PickResult::all(const HitFilter& filter) const {
+            sortHits();
             return kdl::vec_filter(m_hits, filter);
         }
 
         void PickResult::clear() {
             m_hits.clear();
+            m_sorted = true;
+        }
+
+        void PickResult::sortHits() const {
+            if (!m_sorted) {
+                // a stable sort keeps hits that compare equal in the order in which they were added
+                ensure(m_compare.get() != nullptr, "compare is null");
+                std::stable_sort(std::begin(m_hits), std::end(m_hits), CompareWrapper(m_compare.get()));
+                m_sorted = true;
+            }
         }
     }
 }
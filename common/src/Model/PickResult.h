@@ -33,9 +33,14 @@ namespace TrenchBroom {
         class CompareHits;
         class HitQuery;
 
+        /**
+         * The hits found when picking with a ray. Hits are sorted using the given comparator only when they are
+         * queried, so adding hits is cheap and results that are never queried are never sorted.
+         */
         class PickResult {
         private:
-            std::vector<Hit> m_hits;
+            mutable std::vector<Hit> m_hits;
+            mutable bool m_sorted;
             std::shared_ptr<CompareHits> m_compare;
             class CompareWrapper;
         public:
@@ -59,6 +64,8 @@ namespace TrenchBroom {
             std::vector<Hit> all(const HitFilter& filter) const;
 
             void clear();
+        private:
+            void sortHits() const;
         };
     }
 }
@@ -101,6 +101,14 @@ namespace TrenchBroom {
              */
             explicit Polyhedron_Vertex(const vm::vec<T,3>& position);
         public:
+            /**
+             * The elements of a polyhedron are allocated from fixed size pools instead of the heap. Elements created
+             * one after another, e.g. while building or copying a polyhedron, are then adjacent in memory, and
+             * creating and deleting them does not require a heap allocation.
+             */
+            static void* operator new(size_t size);
+            static void operator delete(void* ptr) noexcept;
+
             /**
              * Returns the position of this vertex.
              */
@@ -235,6 +243,9 @@ namespace TrenchBroom {
              */
             Polyhedron_Edge(HalfEdge* first, HalfEdge* second = nullptr);
         public:
+            static void* operator new(size_t size);
+            static void operator delete(void* ptr) noexcept;
+
             /**
              * Returns the origin of the first half edge.
              */
@@ -513,6 +524,9 @@ namespace TrenchBroom {
              */
             Polyhedron_HalfEdge(Vertex* origin);
         public:
+            static void* operator new(size_t size);
+            static void operator delete(void* ptr) noexcept;
+
             /**
              * Returns the origin vertex of this half edge.
              */
@@ -718,6 +732,9 @@ namespace TrenchBroom {
              */
             explicit Polyhedron_Face(HalfEdgeList&& boundary, const vm::plane<T,3>& plane);
         public:
+            static void* operator new(size_t size);
+            static void operator delete(void* ptr) noexcept;
+
             /**
              * Returns the circular list of half edges that make up the boundary of this face.
              */
@@ -1097,6 +1114,21 @@ namespace TrenchBroom {
              */
             explicit Polyhedron(std::vector<vm::vec<T,3>> positions);
 
+            /**
+             * Constructs a closed polyhedron with the given vertices and faces without computing a convex hull, e.g.
+             * to restore a polyhedron that was recorded earlier. Every face is given by the indices of its vertices in
+             * counter clockwise order and by its plane.
+             *
+             * The given topology must be valid: every index must refer to a position, every face must have at least
+             * three vertices, and every pair of consecutive face vertices must occur exactly once in the reverse
+             * order in another face.
+             *
+             * @param positions the vertex positions
+             * @param faceVertices the vertex indices of every face
+             * @param facePlanes the plane of every face
+             */
+            Polyhedron(const std::vector<vm::vec<T,3>>& positions, const std::vector<std::vector<size_t>>& faceVertices, const std::vector<vm::plane<T,3>>& facePlanes);
+
             /**
              * Copy constructor.
              */
@@ -23,6 +23,8 @@
 
 #include "Polyhedron.h"
 
+#include <kdl/fixed_size_pool.h>
+
 #include <vecmath/vec.h>
 #include <vecmath/ray.h>
 #include <vecmath/plane.h>
@@ -64,6 +66,18 @@ m_link(this)
             countAndSetFace(m_boundary.front(), m_boundary.back(), this);
         }
 
+        template <typename T, typename FP, typename VP>
+        void* Polyhedron_Face<T,FP,VP>::operator new(const size_t size) {
+            assert(size == sizeof(Polyhedron_Face));
+            unused(size);
+            return kdl::fixed_size_pool<sizeof(Polyhedron_Face), alignof(Polyhedron_Face)>::allocate();
+        }
+
+        template <typename T, typename FP, typename VP>
+        void Polyhedron_Face<T,FP,VP>::operator delete(void* ptr) noexcept {
+            kdl::fixed_size_pool<sizeof(Polyhedron_Face), alignof(Polyhedron_Face)>::deallocate(ptr);
+        }
+
         template <typename T, typename FP, typename VP>
         const typename Polyhedron_Face<T,FP,VP>::HalfEdgeList& Polyhedron_Face<T,FP,VP>::boundary() const {
             return m_boundary;
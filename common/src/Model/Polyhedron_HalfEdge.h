@@ -20,6 +20,9 @@
 #pragma once
 
 #include "Polyhedron.h"
+#include "Macros.h"
+
+#include <kdl/fixed_size_pool.h>
 
 namespace TrenchBroom {
     namespace Model {
@@ -52,6 +55,18 @@ m_link(this)
             setAsLeaving();
         }
 
+        template <typename T, typename FP, typename VP>
+        void* Polyhedron_HalfEdge<T,FP,VP>::operator new(const size_t size) {
+            assert(size == sizeof(Polyhedron_HalfEdge));
+            unused(size);
+            return kdl::fixed_size_pool<sizeof(Polyhedron_HalfEdge), alignof(Polyhedron_HalfEdge)>::allocate();
+        }
+
+        template <typename T, typename FP, typename VP>
+        void Polyhedron_HalfEdge<T,FP,VP>::operator delete(void* ptr) noexcept {
+            kdl::fixed_size_pool<sizeof(Polyhedron_HalfEdge), alignof(Polyhedron_HalfEdge)>::deallocate(ptr);
+        }
+
         template <typename T, typename FP, typename VP>
         typename Polyhedron_HalfEdge<T,FP,VP>::Vertex* Polyhedron_HalfEdge<T,FP,VP>::origin() const {
             return m_origin;
@@ -194,6 +194,53 @@ namespace TrenchBroom {
             addPoints(std::move(positions));
         }
 
+        template <typename T, typename FP, typename VP>
+        Polyhedron<T,FP,VP>::Polyhedron(const std::vector<vm::vec<T,3>>& positions, const std::vector<std::vector<size_t>>& faceVertices, const std::vector<vm::plane<T,3>>& facePlanes) {
+            assert(faceVertices.size() == facePlanes.size());
+
+            auto vertices = std::vector<Vertex*>{};
+            vertices.reserve(positions.size());
+            for (const auto& position : positions) {
+                Vertex* vertex = new Vertex(position);
+                m_vertices.push_back(vertex);
+                vertices.push_back(vertex);
+            }
+
+            // maps the indices of the origin and the destination of a half edge without a twin to the half edge
+            const auto key = [&](const size_t origin, const size_t destination) {
+                return origin * positions.size() + destination;
+            };
+            auto unmatchedHalfEdges = std::unordered_map<size_t, HalfEdge*>{};
+
+            for (size_t i = 0; i < faceVertices.size(); ++i) {
+                const auto& indices = faceVertices[i];
+                assert(indices.size() >= 3u);
+
+                HalfEdgeList boundary;
+                for (size_t j = 0; j < indices.size(); ++j) {
+                    const auto origin = indices[j];
+                    const auto destination = indices[(j + 1u) % indices.size()];
+                    assert(origin < vertices.size() && destination < vertices.size());
+
+                    HalfEdge* halfEdge = new HalfEdge(vertices[origin]);
+                    boundary.push_back(halfEdge);
+
+                    const auto twin = unmatchedHalfEdges.find(key(destination, origin));
+                    if (twin != std::end(unmatchedHalfEdges)) {
+                        m_edges.push_back(new Edge(twin->second, halfEdge));
+                        unmatchedHalfEdges.erase(twin);
+                    } else {
+                        unmatchedHalfEdges.emplace(key(origin, destination), halfEdge);
+                    }
+                }
+
+                m_faces.push_back(new Face(std::move(boundary), facePlanes[i]));
+            }
+
+            assert(unmatchedHalfEdges.empty());
+            updateBounds();
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron<T,FP,VP>::Polyhedron(const Polyhedron<T,FP,VP>& other) {
             Copy copy(other.faces(), other.edges(), other.vertices(), *this, CopyCallback());
@@ -112,7 +112,7 @@ namespace TrenchBroom {
 
         bool TextureNameTagMatcher::matches(const Taggable& taggable) const {
             BrushFaceMatchVisitor visitor([this](const BrushFace& face) {
-                return matchesTextureName(face.attributes().textureName());
+                return matchesTextureName(face.attributes().internedTextureName());
             });
 
             taggable.accept(visitor);
@@ -123,7 +123,18 @@ namespace TrenchBroom {
             if (texture == nullptr) {
                 return false;
             }
-            return matchesTextureName(texture->name());
+            return matchesTextureName(std::string_view{texture->name()});
+        }
+
+        bool TextureNameTagMatcher::matchesTextureName(const kdl::interned_string& textureName) const {
+            const auto it = m_matchesByTextureName.find(textureName);
+            if (it != std::end(m_matchesByTextureName)) {
+                return it->second;
+            }
+
+            const auto result = matchesTextureName(std::string_view{textureName.str()});
+            m_matchesByTextureName.emplace(textureName, result);
+            return result;
         }
 
         bool TextureNameTagMatcher::matchesTextureName(std::string_view textureName) const {
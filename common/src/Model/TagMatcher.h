@@ -23,12 +23,14 @@
 #include "Model/Tag.h"
 #include "Model/TagVisitor.h"
 
+#include <kdl/interned_string.h>
 #include <kdl/vector_set.h>
 
 #include <functional>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -81,12 +83,15 @@ namespace TrenchBroom {
         class TextureNameTagMatcher : public TextureTagMatcher {
         private:
             std::string m_pattern;
+            // glob matching results by texture name, most faces share a handful of names
+            mutable std::unordered_map<kdl::interned_string, bool> m_matchesByTextureName;
         public:
             explicit TextureNameTagMatcher(const std::string& pattern);
             std::unique_ptr<TagMatcher> clone() const override;
             bool matches(const Taggable& taggable) const override;
         private:
             bool matchesTexture(const Assets::Texture* texture) const override;
+            bool matchesTextureName(const kdl::interned_string& textureName) const;
             bool matchesTextureName(std::string_view textureName) const;
         };
 
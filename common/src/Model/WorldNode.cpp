@@ -67,6 +67,10 @@ namespace TrenchBroom {
             return *m_nodeTree;
         }
 
+        std::vector<Node*> WorldNode::findNodesInFrustum(const std::vector<vm::plane3>& frustumPlanes) const {
+            return m_nodeTree->findInFrustum(frustumPlanes);
+        }
+
         LayerNode* WorldNode::defaultLayer() {
             ensure(m_defaultLayer != nullptr, "defaultLayer is null");
             return m_defaultLayer;
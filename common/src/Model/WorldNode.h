@@ -28,6 +28,8 @@
 
 #include <kdl/result_forward.h>
 
+#include <vecmath/forward.h>
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -63,6 +65,15 @@ namespace TrenchBroom {
             MapFormat mapFormat() const;
 
             const NodeTree& nodeTree() const;
+
+            /**
+             * Returns the entities, brushes and patches whose physical bounds intersect the frustum bounded by the
+             * given planes. The normals of the planes must point out of the frustum.
+             *
+             * Some nodes whose bounds are close to the corners of the frustum are returned even though they don't
+             * intersect it.
+             */
+            std::vector<Node*> findNodesInFrustum(const std::vector<vm::plane3>& frustumPlanes) const;
         public: // layer management
             LayerNode* defaultLayer();
 
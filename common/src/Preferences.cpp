@@ -131,6 +131,8 @@ namespace TrenchBroom {
 
         Preference<int> TextureMinFilter(IO::Path("Renderer/Texture mode min filter"), 0x2700);
         Preference<int> TextureMagFilter(IO::Path("Renderer/Texture mode mag filter"), 0x2600);
+        Preference<bool> LoadTexturesOnDemand(IO::Path("Renderer/Load textures on demand"), false);
+        Preference<int> TextureMemoryBudget(IO::Path("Renderer/Texture memory budget"), 1024);
         Preference<bool> EnableMSAA(IO::Path("Renderer/Enable multisampling"), true);
 
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
@@ -229,6 +231,8 @@ namespace TrenchBroom {
         }
         Preference<QString> EntityLinkMode(IO::Path("Map view/Entity link mode"), "direct");
 
+        Preference<bool> CacheMapSnapshots(IO::Path("Map/Cache map snapshots"), false);
+
         const std::vector<PreferenceBase*>& staticPreferences() {
             static const std::vector<PreferenceBase*> list {
                 &MapViewLayout,
@@ -296,6 +300,8 @@ namespace TrenchBroom {
                 &GridColor2D,
                 &TextureMinFilter,
                 &TextureMagFilter,
+                &LoadTexturesOnDemand,
+                &TextureMemoryBudget,
                 &TextureLock,
                 &UVLock,
                 &RendererFontPath(),
@@ -341,7 +347,8 @@ namespace TrenchBroom {
                 &ShowSoftMapBounds,
                 &ShowPointEntities,
                 &ShowBrushes,
-                &EntityLinkMode
+                &EntityLinkMode,
+                &CacheMapSnapshots
             };
 
             return list;
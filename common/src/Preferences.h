@@ -124,6 +124,9 @@ namespace TrenchBroom {
 
         extern Preference<int> TextureMinFilter;
         extern Preference<int> TextureMagFilter;
+        extern Preference<bool> LoadTexturesOnDemand;
+        // in MiB, only applies if textures are loaded on demand
+        extern Preference<int> TextureMemoryBudget;
         extern Preference<bool> EnableMSAA;
 
         extern Preference<bool> TextureLock;
@@ -197,6 +200,8 @@ namespace TrenchBroom {
         QString entityLinkModeNone();
         extern Preference<QString> EntityLinkMode;
 
+        extern Preference<bool> CacheMapSnapshots;
+
         /**
          * Returns all Preferences declared in this file. Needed for migrating preference formats
          * or if we wanted to do a Path to Preference lookup.
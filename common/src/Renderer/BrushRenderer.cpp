@@ -29,6 +29,7 @@
 #include "Model/TagAttribute.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/FrustumCulling.h"
 #include "Renderer/RenderContext.h"
 
 #include <cassert>
@@ -133,7 +134,8 @@ namespace TrenchBroom {
         m_showOccludedEdges(false),
         m_forceTransparent(false),
         m_transparencyAlpha(1.0f),
-        m_showHiddenBrushes(false) {
+        m_showHiddenBrushes(false),
+        m_indexRangesValid(false) {
             clear();
         }
 
@@ -208,6 +210,7 @@ namespace TrenchBroom {
             m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
             m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
             m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            m_indexRangesValid = false;
         }
 
         void BrushRenderer::setFaceColor(const Color& faceColor) {
@@ -263,6 +266,11 @@ namespace TrenchBroom {
             }
         }
 
+        void BrushRenderer::setFrustumCulling(std::shared_ptr<const FrustumCulling> frustumCulling) {
+            m_frustumCulling = std::move(frustumCulling);
+            m_indexRangesValid = false;
+        }
+
         void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             renderOpaque(renderContext, renderBatch);
             renderTransparent(renderContext, renderBatch);
@@ -273,6 +281,7 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                validateIndexRanges();
                 if (renderContext.showFaces()) {
                     renderOpaqueFaces(renderBatch);
                 }
@@ -287,6 +296,7 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                validateIndexRanges();
                 if (renderContext.showFaces()) {
                     renderTransparentFaces(renderBatch);
                 }
@@ -297,6 +307,7 @@ namespace TrenchBroom {
             m_opaqueFaceRenderer.setGrayscale(m_grayscale);
             m_opaqueFaceRenderer.setTint(m_tint);
             m_opaqueFaceRenderer.setTintColor(m_tintColor);
+            m_opaqueFaceRenderer.setIndexRanges(m_opaqueFaceRanges);
             m_opaqueFaceRenderer.render(renderBatch);
         }
 
@@ -305,16 +316,74 @@ namespace TrenchBroom {
             m_transparentFaceRenderer.setTint(m_tint);
             m_transparentFaceRenderer.setTintColor(m_tintColor);
             m_transparentFaceRenderer.setAlpha(m_transparencyAlpha);
+            m_transparentFaceRenderer.setIndexRanges(m_transparentFaceRanges);
             m_transparentFaceRenderer.render(renderBatch);
         }
 
         void BrushRenderer::renderEdges(RenderBatch& renderBatch) {
+            m_edgeRenderer.setIndexRanges(m_edgeRanges);
             if (m_showOccludedEdges) {
                 m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
             }
             m_edgeRenderer.render(renderBatch, m_edgeColor);
         }
 
+        void BrushRenderer::validateIndexRanges() {
+            if (m_indexRangesValid) {
+                return;
+            }
+            m_indexRangesValid = true;
+
+            if (!m_frustumCulling) {
+                m_opaqueFaceRanges = nullptr;
+                m_transparentFaceRanges = nullptr;
+                m_edgeRanges = nullptr;
+                return;
+            }
+
+            m_opaqueFaceRanges = std::make_shared<TextureToBrushIndexRangesMap>();
+            m_transparentFaceRanges = std::make_shared<TextureToBrushIndexRangesMap>();
+            m_edgeRanges = std::make_shared<BrushIndexRanges>();
+
+            const auto addRanges = [&](const BrushInfo& info) {
+                if (info.edgeIndicesKey != nullptr) {
+                    m_edgeRanges->add(info.edgeIndicesKey);
+                }
+                for (const auto& [texture, opaqueKey] : info.opaqueFaceIndicesKeys) {
+                    (*m_opaqueFaceRanges)[texture].add(opaqueKey);
+                }
+                for (const auto& [texture, transparentKey] : info.transparentFaceIndicesKeys) {
+                    (*m_transparentFaceRanges)[texture].add(transparentKey);
+                }
+            };
+
+            // renderers for a few brushes, e.g. the selection, test the brush bounds, while renderers for most of the
+            // map look up the visible brushes found by the node tree
+            const auto& visibleBrushes = m_frustumCulling->visibleBrushes();
+            if (m_brushInfo.size() <= visibleBrushes.size()) {
+                for (const auto& [brush, info] : m_brushInfo) {
+                    if (m_frustumCulling->visible(brush->physicalBounds())) {
+                        addRanges(info);
+                    }
+                }
+            } else {
+                for (const auto* brush : visibleBrushes) {
+                    const auto it = m_brushInfo.find(brush);
+                    if (it != std::end(m_brushInfo)) {
+                        addRanges(it->second);
+                    }
+                }
+            }
+
+            m_edgeRanges->compact();
+            for (auto& [texture, ranges] : *m_opaqueFaceRanges) {
+                ranges.compact();
+            }
+            for (auto& [texture, ranges] : *m_transparentFaceRanges) {
+                ranges.compact();
+            }
+        }
+
         class BrushRenderer::FilterWrapper : public BrushRenderer::Filter {
         private:
             const Filter& m_filter;
@@ -350,6 +419,7 @@ namespace TrenchBroom {
             m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
             m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
             m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            m_indexRangesValid = false;
         }
 
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
@@ -628,6 +698,7 @@ namespace TrenchBroom {
             }
 
             m_brushInfo.erase(it);
+            m_indexRangesValid = false;
         }
     }
 }
@@ -39,6 +39,9 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class BrushIndexRanges;
+        class FrustumCulling;
+
         class BrushRenderer {
         public:
             class Filter {
@@ -161,6 +164,13 @@ namespace TrenchBroom {
             float m_transparencyAlpha;
 
             bool m_showHiddenBrushes;
+
+            using TextureToBrushIndexRangesMap = std::unordered_map<const Assets::Texture*, BrushIndexRanges>;
+            std::shared_ptr<const FrustumCulling> m_frustumCulling;
+            bool m_indexRangesValid;
+            std::shared_ptr<TextureToBrushIndexRangesMap> m_opaqueFaceRanges;
+            std::shared_ptr<TextureToBrushIndexRangesMap> m_transparentFaceRanges;
+            std::shared_ptr<BrushIndexRanges> m_edgeRanges;
         public:
             template <typename FilterT>
             explicit BrushRenderer(const FilterT& filter) :
@@ -171,7 +181,8 @@ namespace TrenchBroom {
             m_showOccludedEdges(false),
             m_forceTransparent(false),
             m_transparencyAlpha(1.0f),
-            m_showHiddenBrushes(false) {
+            m_showHiddenBrushes(false),
+            m_indexRangesValid(false) {
                 clear();
             }
 
@@ -265,6 +276,12 @@ namespace TrenchBroom {
              * Specifies whether or not brushes which are currently hidden should be rendered regardless.
              */
             void setShowHiddenBrushes(bool showHiddenBrushes);
+
+            /**
+             * Restricts rendering to the brushes that are visible according to the given frustum culling. The brushes
+             * must be part of the world's node tree. If the given culling is null, all brushes are rendered.
+             */
+            void setFrustumCulling(std::shared_ptr<const FrustumCulling> frustumCulling);
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -273,6 +290,7 @@ namespace TrenchBroom {
             void renderOpaqueFaces(RenderBatch& renderBatch);
             void renderTransparentFaces(RenderBatch& renderBatch);
             void renderEdges(RenderBatch& renderBatch);
+            void validateIndexRanges();
 
         public:
             /**
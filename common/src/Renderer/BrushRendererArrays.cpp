@@ -68,6 +68,40 @@ namespace TrenchBroom {
             return m_dirtySize == 0;
         }
 
+        // BrushIndexRanges
+
+        void BrushIndexRanges::add(const AllocationTracker::Block* block) {
+            m_ranges.push_back(Range{block->pos, block->size});
+        }
+
+        void BrushIndexRanges::compact() {
+            if (m_ranges.empty()) {
+                return;
+            }
+
+            std::sort(std::begin(m_ranges), std::end(m_ranges), [](const Range& lhs, const Range& rhs) {
+                return lhs.offset < rhs.offset;
+            });
+
+            auto last = std::begin(m_ranges);
+            for (auto it = std::next(last); it != std::end(m_ranges); ++it) {
+                if (last->offset + last->count == it->offset) {
+                    last->count += it->count;
+                } else {
+                    *++last = *it;
+                }
+            }
+            m_ranges.erase(std::next(last), std::end(m_ranges));
+        }
+
+        bool BrushIndexRanges::empty() const {
+            return m_ranges.empty();
+        }
+
+        size_t BrushIndexRanges::size() const {
+            return m_ranges.size();
+        }
+
         // IndexHolder
 
         IndexHolder::IndexHolder() : VboHolder<Index>(VboType::ElementArrayBuffer) {}
@@ -87,6 +121,24 @@ namespace TrenchBroom {
             glAssert(glDrawElements(toGL(primType), renderCount, glType<Index>(), renderOffset));
         }
 
+        void IndexHolder::render(const PrimType primType, const BrushIndexRanges& ranges) const {
+            if (ranges.empty()) {
+                return;
+            }
+
+            auto renderCounts = std::vector<GLsizei>{};
+            auto renderOffsets = std::vector<const GLvoid*>{};
+            renderCounts.reserve(ranges.size());
+            renderOffsets.reserve(ranges.size());
+
+            ranges.forEachRange([&](const size_t offset, const size_t count) {
+                renderCounts.push_back(static_cast<GLsizei>(count));
+                renderOffsets.push_back(reinterpret_cast<const GLvoid*>(m_vbo->offset() + sizeof(Index) * offset));
+            });
+
+            glAssert(glMultiDrawElements(toGL(primType), renderCounts.data(), glType<Index>(), renderOffsets.data(), static_cast<GLsizei>(renderCounts.size())));
+        }
+
         std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index> &elements) {
             return std::make_shared<IndexHolder>(elements);
         }
@@ -136,6 +188,11 @@ namespace TrenchBroom {
             m_indexHolder.render(primType, 0, m_indexHolder.size());
         }
 
+        void BrushIndexArray::render(const PrimType primType, const BrushIndexRanges& ranges) const {
+            assert(m_indexHolder.prepared());
+            m_indexHolder.render(primType, ranges);
+        }
+
         bool BrushIndexArray::prepared() const {
             return m_indexHolder.prepared();
         }
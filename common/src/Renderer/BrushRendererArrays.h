@@ -213,6 +213,42 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * A list of ranges of indices in an index VBO block. Used to render only a part of the indices, e.g. the indices
+         * of the brushes that are visible.
+         */
+        class BrushIndexRanges {
+        private:
+            struct Range {
+                size_t offset;
+                size_t count;
+            };
+
+            std::vector<Range> m_ranges;
+        public:
+            /**
+             * Adds the range of indices that was allocated as the given block.
+             */
+            void add(const AllocationTracker::Block* block);
+
+            /**
+             * Sorts the ranges by their offsets and merges adjacent ranges. Must be called after the last range was
+             * added and before the ranges are rendered.
+             */
+            void compact();
+
+            bool empty() const;
+
+            template <typename F>
+            void forEachRange(F&& f) const {
+                for (const auto& range : m_ranges) {
+                    f(range.offset, range.count);
+                }
+            }
+
+            size_t size() const;
+        };
+
         class IndexHolder : public VboHolder<GLuint> {
         public:
             using Index = GLuint;
@@ -224,6 +260,7 @@ namespace TrenchBroom {
             explicit IndexHolder(std::vector<Index>& elements);
             void zeroRange(size_t offsetWithinBlock, size_t count);
             void render(PrimType primType, size_t offset, size_t count) const;
+            void render(PrimType primType, const BrushIndexRanges& ranges) const;
 
             static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
         };
@@ -260,6 +297,11 @@ namespace TrenchBroom {
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
             void render(const PrimType primType) const;
+
+            /**
+             * Renders only the given ranges of indices. The ranges must have been compacted.
+             */
+            void render(const PrimType primType, const BrushIndexRanges& ranges) const;
             bool prepared() const;
             void prepare(VboManager& vboManager);
 
@@ -25,6 +25,7 @@
 #include "Model/Polyhedron.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -68,6 +69,9 @@ namespace TrenchBroom {
             m_cachedFacesSortedByTexture.clear();
             m_cachedFacesSortedByTexture.reserve(brush.faceCount());
 
+            auto vertexIndices = std::unordered_map<const Model::BrushVertex*, size_t>{};
+            vertexIndices.reserve(brush.vertexCount());
+
             for (const Model::BrushFace& face : brush.faces()) {
                 const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
 
@@ -75,14 +79,14 @@ namespace TrenchBroom {
                 auto& boundary = face.geometry()->boundary();
                 for (auto it = std::rbegin(boundary), end = std::rend(boundary); it != end; ++it) {
                     Model::BrushHalfEdge* current = *it;
-                    Model::BrushVertex* vertex = current->origin();
+                    const Model::BrushVertex* vertex = current->origin();
 
-                    // Set the vertex payload to the index, relative to the brush's first vertex being 0.
+                    // Remember the index of the vertex, relative to the brush's first vertex being 0.
                     // This is used below when building the edge cache.
-                    // NOTE: we'll overwrite the payload as we visit the same vertex several times while visiting
-                    // different faces, this is fine.
-                    const auto currentIndex = m_cachedVertices.size();
-                    vertex->setPayload(static_cast<GLuint>(currentIndex));
+                    // NOTE: we'll overwrite the index as we visit the same vertex several times while visiting
+                    // different faces, this is fine. The geometry may be shared with copies of the brush, so we must
+                    // not store the index in the vertex payload.
+                    vertexIndices[vertex] = m_cachedVertices.size();
 
                     const auto& position = vertex->position();
                     m_cachedVertices.emplace_back(vm::vec3f(position), vm::vec3f(face.boundary().normal), face.textureCoords(position));
@@ -114,8 +118,8 @@ namespace TrenchBroom {
                 const auto& face1 = brush.face(*faceIndex1);
                 const auto& face2 = brush.face(*faceIndex2);
                 
-                const auto vertexIndex1RelativeToBrush = currentEdge->firstVertex()->payload();
-                const auto vertexIndex2RelativeToBrush = currentEdge->secondVertex()->payload();
+                const auto vertexIndex1RelativeToBrush = vertexIndices.at(currentEdge->firstVertex());
+                const auto vertexIndex2RelativeToBrush = vertexIndices.at(currentEdge->secondVertex());
 
                 m_cachedEdges.emplace_back(&face1, &face2, vertexIndex1RelativeToBrush, vertexIndex2RelativeToBrush);
             }
@@ -29,6 +29,7 @@
 namespace TrenchBroom {
     namespace Renderer {
         class BrushIndexArray;
+        class BrushIndexRanges;
         class BrushVertexArray;
         class RenderBatch;
 
@@ -105,8 +106,9 @@ namespace TrenchBroom {
             private:
                 std::shared_ptr<BrushVertexArray> m_vertexArray;
                 std::shared_ptr<BrushIndexArray> m_indexArray;
+                std::shared_ptr<const BrushIndexRanges> m_indexRanges;
             public:
-                Render(const Params& params, std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray);
+                Render(const Params& params, std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray, std::shared_ptr<const BrushIndexRanges> indexRanges);
             private:
                 void prepareVerticesAndIndices(VboManager& vboManager) override;
                 void doRender(RenderContext& renderContext) override;
@@ -115,6 +117,7 @@ namespace TrenchBroom {
         private:
             std::shared_ptr<BrushVertexArray> m_vertexArray;
             std::shared_ptr<BrushIndexArray> m_indexArray;
+            std::shared_ptr<const BrushIndexRanges> m_indexRanges;
         public:
             IndexedEdgeRenderer();
             IndexedEdgeRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray);
@@ -123,6 +126,12 @@ namespace TrenchBroom {
             IndexedEdgeRenderer& operator=(IndexedEdgeRenderer other);
 
             friend void swap(IndexedEdgeRenderer& left, IndexedEdgeRenderer& right);
+
+            /**
+             * Restricts rendering to the given ranges of the index array. If the given ranges are null, all indices
+             * are rendered.
+             */
+            void setIndexRanges(std::shared_ptr<const BrushIndexRanges> indexRanges);
         private:
             void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
         };
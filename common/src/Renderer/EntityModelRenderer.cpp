@@ -32,6 +32,7 @@
 #include "Model/EntityNode.h"
 #include "Renderer/ActiveShader.h"
 #include "Renderer/RenderBatch.h"
+#include "Renderer/FrustumCulling.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/Shaders.h"
 #include "Renderer/ShaderManager.h"
@@ -115,6 +116,10 @@ namespace TrenchBroom {
             m_showHiddenEntities = showHiddenEntities;
         }
 
+        void EntityModelRenderer::setFrustumCulling(std::shared_ptr<const FrustumCulling> frustumCulling) {
+            m_frustumCulling = std::move(frustumCulling);
+        }
+
         void EntityModelRenderer::render(RenderBatch& renderBatch) {
             renderBatch.add(this);
         }
@@ -143,18 +148,37 @@ namespace TrenchBroom {
             glAssert(glEnable(GL_TEXTURE_2D));
             glAssert(glActiveTexture(GL_TEXTURE0));
 
-            for (const auto& [entityNode, renderer] : m_entities) {
-                if (!m_showHiddenEntities && !m_editorContext.visible(entityNode)) {
-                    continue;
+            if (!m_frustumCulling) {
+                for (const auto& [entityNode, renderer] : m_entities) {
+                    renderModel(renderContext, shader, entityNode, renderer);
+                }
+            } else if (m_entities.size() <= m_frustumCulling->visibleEntities().size()) {
+                for (const auto& [entityNode, renderer] : m_entities) {
+                    if (m_frustumCulling->visible(entityNode->physicalBounds())) {
+                        renderModel(renderContext, shader, entityNode, renderer);
+                    }
                 }
+            } else {
+                for (auto* entityNode : m_frustumCulling->visibleEntities()) {
+                    const auto it = m_entities.find(entityNode);
+                    if (it != std::end(m_entities)) {
+                        renderModel(renderContext, shader, it->first, it->second);
+                    }
+                }
+            }
+        }
 
-                const auto transformation = entityNode->entity().modelTransformation();
-                MultiplyModelMatrix multMatrix(renderContext.transformation(), vm::mat4x4f(transformation));
+        void EntityModelRenderer::renderModel(RenderContext& renderContext, ActiveShader& shader, Model::EntityNode* entityNode, TexturedRenderer* renderer) const {
+            if (!m_showHiddenEntities && !m_editorContext.visible(entityNode)) {
+                return;
+            }
 
-                shader.set("ModelMatrix", vm::mat4x4f(transformation));
+            const auto transformation = entityNode->entity().modelTransformation();
+            MultiplyModelMatrix multMatrix(renderContext.transformation(), vm::mat4x4f(transformation));
 
-                renderer->render();
-            }
+            shader.set("ModelMatrix", vm::mat4x4f(transformation));
+
+            renderer->render();
         }
     }
 }
@@ -23,6 +23,7 @@
 #include "Renderer/Renderable.h"
 
 #include <map>
+#include <memory>
 
 namespace TrenchBroom {
     class Logger;
@@ -37,6 +38,8 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class FrustumCulling;
+        class ActiveShader;
         class RenderBatch;
         class TexturedRenderer;
 
@@ -55,6 +58,8 @@ namespace TrenchBroom {
             Color m_tintColor;
 
             bool m_showHiddenEntities;
+
+            std::shared_ptr<const FrustumCulling> m_frustumCulling;
         public:
             EntityModelRenderer(Logger& logger, Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext);
             ~EntityModelRenderer() override;
@@ -93,10 +98,17 @@ namespace TrenchBroom {
             bool showHiddenEntities() const;
             void setShowHiddenEntities(bool showHiddenEntities);
 
+            /**
+             * Restricts rendering to the models of the entities that are visible according to the given frustum
+             * culling. If the given culling is null, all models are rendered.
+             */
+            void setFrustumCulling(std::shared_ptr<const FrustumCulling> frustumCulling);
+
             void render(RenderBatch& renderBatch);
         private:
             void doPrepareVertices(VboManager& vboManager) override;
             void doRender(RenderContext& renderContext) override;
+            void renderModel(RenderContext& renderContext, ActiveShader& shader, Model::EntityNode* entityNode, TexturedRenderer* renderer) const;
         };
     }
 }
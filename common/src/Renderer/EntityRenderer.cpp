@@ -153,6 +153,10 @@ namespace TrenchBroom {
             m_showHiddenEntities = showHiddenEntities;
         }
 
+        void EntityRenderer::setFrustumCulling(std::shared_ptr<const FrustumCulling> frustumCulling) {
+            m_modelRenderer.setFrustumCulling(std::move(frustumCulling));
+        }
+
         void EntityRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             if (!m_entities.empty()) {
                 renderBounds(renderContext, renderBatch);
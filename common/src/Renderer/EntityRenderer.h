@@ -27,6 +27,7 @@
 
 #include <vecmath/forward.h>
 
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
@@ -43,6 +44,7 @@ namespace TrenchBroom {
 
     namespace Renderer {
         class AttrString;
+        class FrustumCulling;
 
         class EntityRenderer {
         private:
@@ -98,6 +100,12 @@ namespace TrenchBroom {
             void setAngleColor(const Color& angleColor);
 
             void setShowHiddenEntities(bool showHiddenEntities);
+
+            /**
+             * Restricts rendering of entity models to the entities that are visible according to the given frustum
+             * culling. Entity bounds, angles and classnames are always rendered.
+             */
+            void setFrustumCulling(std::shared_ptr<const FrustumCulling> frustumCulling);
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
         private:
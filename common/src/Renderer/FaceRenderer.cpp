@@ -46,8 +46,8 @@ namespace TrenchBroom {
 
             void before(const Assets::Texture* texture) override {
                 if (texture != nullptr) {
-                    texture->activate();
-                    shader.set("ApplyTexture", applyTexture);
+                    const auto resident = texture->activate();
+                    shader.set("ApplyTexture", applyTexture && resident);
                     shader.set("Color", texture->averageColor());
                 } else {
                     shader.set("ApplyTexture", false);
@@ -79,6 +79,7 @@ namespace TrenchBroom {
         IndexedRenderable(other),
         m_vertexArray(other.m_vertexArray),
         m_indexArrayMap(other.m_indexArrayMap),
+        m_indexRangesMap(other.m_indexRangesMap),
         m_faceColor(other.m_faceColor),
         m_grayscale(other.m_grayscale),
         m_tint(other.m_tint),
@@ -95,6 +96,7 @@ namespace TrenchBroom {
             using std::swap;
             swap(left.m_vertexArray, right.m_vertexArray);
             swap(left.m_indexArrayMap, right.m_indexArrayMap);
+            swap(left.m_indexRangesMap, right.m_indexRangesMap);
             swap(left.m_faceColor, right.m_faceColor);
             swap(left.m_grayscale, right.m_grayscale);
             swap(left.m_tint, right.m_tint);
@@ -118,6 +120,10 @@ namespace TrenchBroom {
             m_alpha = alpha;
         }
 
+        void FaceRenderer::setIndexRanges(std::shared_ptr<TextureToBrushIndexRangesMap> indexRangesMap) {
+            m_indexRangesMap = std::move(indexRangesMap);
+        }
+
         void FaceRenderer::render(RenderBatch& renderBatch) {
             renderBatch.add(this);
         }
@@ -177,6 +183,15 @@ namespace TrenchBroom {
                         continue;
                     }
 
+                    const BrushIndexRanges* ranges = nullptr;
+                    if (m_indexRangesMap) {
+                        const auto it = m_indexRangesMap->find(texture);
+                        if (it == std::end(*m_indexRangesMap) || it->second.empty()) {
+                            continue;
+                        }
+                        ranges = &it->second;
+                    }
+
                     const bool enableMasked = texture != nullptr && texture->masked();
                     
                     // set any per-texture uniforms
@@ -185,7 +200,11 @@ namespace TrenchBroom {
 
                     func.before(texture);
                     brushIndexHolderPtr->setupIndices();
-                    brushIndexHolderPtr->render(PrimType::Triangles);
+                    if (ranges != nullptr) {
+                        brushIndexHolderPtr->render(PrimType::Triangles, *ranges);
+                    } else {
+                        brushIndexHolderPtr->render(PrimType::Triangles);
+                    }
                     brushIndexHolderPtr->cleanupIndices();
                     func.after(texture);
                 }
@@ -35,6 +35,7 @@ namespace TrenchBroom {
 
     namespace Renderer {
         class BrushIndexArray;
+        class BrushIndexRanges;
         class BrushVertexArray;
         class RenderBatch;
 
@@ -43,9 +44,11 @@ namespace TrenchBroom {
             struct RenderFunc;
 
             using TextureToBrushIndicesMap = const std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
+            using TextureToBrushIndexRangesMap = const std::unordered_map<const Assets::Texture*, BrushIndexRanges>;
 
             std::shared_ptr<BrushVertexArray> m_vertexArray;
             std::shared_ptr<TextureToBrushIndicesMap> m_indexArrayMap;
+            std::shared_ptr<TextureToBrushIndexRangesMap> m_indexRangesMap;
             Color m_faceColor;
             bool m_grayscale;
             bool m_tint;
@@ -64,6 +67,12 @@ namespace TrenchBroom {
             void setTintColor(const Color& color);
             void setAlpha(float alpha);
 
+            /**
+             * Restricts rendering to the given ranges of the index arrays. Textures without ranges are skipped. If the
+             * given map is null, all indices are rendered.
+             */
+            void setIndexRanges(std::shared_ptr<TextureToBrushIndexRangesMap> indexRangesMap);
+
             void render(RenderBatch& renderBatch);
         private:
             void prepareVerticesAndIndices(VboManager& vboManager) override;
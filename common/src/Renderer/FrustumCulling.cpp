@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrustumCulling.h"
+
+#include "AABBTree.h"
+#include "FloatType.h"
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+#include "Renderer/Camera.h"
+
+#include <kdl/overload.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static std::vector<vm::plane3> computeFrustumPlanes(const Camera& camera) {
+            vm::plane3f topPlane, rightPlane, bottomPlane, leftPlane;
+            camera.frustumPlanes(topPlane, rightPlane, bottomPlane, leftPlane);
+
+            const auto toPlane3 = [](const vm::plane3f& plane) {
+                return vm::plane3{vm::vec3{plane.anchor()}, vm::vec3{plane.normal}};
+            };
+
+            return {
+                toPlane3(topPlane),
+                toPlane3(rightPlane),
+                toPlane3(bottomPlane),
+                toPlane3(leftPlane)
+            };
+        }
+
+        FrustumCulling::FrustumCulling(const Camera& camera, const Model::WorldNode& world) :
+        m_frustumPlanes{computeFrustumPlanes(camera)} {
+            for (auto* node : world.findNodesInFrustum(m_frustumPlanes)) {
+                node->accept(kdl::overload(
+                    [] (Model::WorldNode*) {},
+                    [] (Model::LayerNode*) {},
+                    [] (Model::GroupNode*) {},
+                    [&](Model::EntityNode* entity) { m_visibleEntities.push_back(entity); },
+                    [&](Model::BrushNode* brush)   { m_visibleBrushes.push_back(brush); },
+                    [] (Model::PatchNode*) {}
+                ));
+            }
+        }
+
+        bool FrustumCulling::visible(const vm::bbox3& bounds) const {
+            // use the same test as the node tree so that both agree on which nodes are visible
+            return std::none_of(std::begin(m_frustumPlanes), std::end(m_frustumPlanes), [&](const auto& plane) {
+                return AABBTree<FloatType, 3, Model::Node*>::isInFrontOf(bounds, plane);
+            });
+        }
+
+        const std::vector<Model::BrushNode*>& FrustumCulling::visibleBrushes() const {
+            return m_visibleBrushes;
+        }
+
+        const std::vector<Model::EntityNode*>& FrustumCulling::visibleEntities() const {
+            return m_visibleEntities;
+        }
+    }
+}
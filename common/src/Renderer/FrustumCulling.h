@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+
+#include <vecmath/forward.h>
+#include <vecmath/plane.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class BrushNode;
+        class EntityNode;
+        class WorldNode;
+    }
+
+    namespace Renderer {
+        class Camera;
+
+        /**
+         * The brushes and entities of a map whose bounds intersect the view frustum of a camera.
+         *
+         * The visible objects are found using the node tree of the world node. Renderers that are given an instance
+         * of this class only render the visible objects. Since the view frustum is only bounded by its side planes,
+         * objects behind the far plane are considered visible.
+         */
+        class FrustumCulling {
+        private:
+            std::vector<vm::plane3> m_frustumPlanes;
+            std::vector<Model::BrushNode*> m_visibleBrushes;
+            std::vector<Model::EntityNode*> m_visibleEntities;
+        public:
+            FrustumCulling(const Camera& camera, const Model::WorldNode& world);
+
+            /**
+             * Indicates whether the given bounds intersect the view frustum. Like the node tree query, this test
+             * accepts some bounds close to the corners of the frustum that don't actually intersect it.
+             *
+             * Renderers that render only a few objects can use this instead of looking up the visible objects.
+             */
+            bool visible(const vm::bbox3& bounds) const;
+
+            const std::vector<Model::BrushNode*>& visibleBrushes() const;
+            const std::vector<Model::EntityNode*>& visibleEntities() const;
+        };
+    }
+}
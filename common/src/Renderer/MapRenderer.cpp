@@ -34,6 +34,7 @@
 #include "Model/WorldNode.h"
 #include "Renderer/BrushRenderer.h"
 #include "Renderer/EntityLinkRenderer.h"
+#include "Renderer/FrustumCulling.h"
 #include "Renderer/GroupLinkRenderer.h"
 #include "Renderer/ObjectRenderer.h"
 #include "Renderer/RenderBatch.h"
@@ -191,6 +192,7 @@ namespace TrenchBroom {
 
         void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             commitPendingChanges();
+            setupFrustumCulling(renderContext);
             setupGL(renderBatch);
             renderDefaultOpaque(renderContext, renderBatch);
             renderLockedOpaque(renderContext, renderBatch);
@@ -209,6 +211,16 @@ namespace TrenchBroom {
             document->commitPendingAssets();
         }
 
+        void MapRenderer::setupFrustumCulling(RenderContext& renderContext) {
+            auto document = kdl::mem_lock(m_document);
+            const auto* world = document->world();
+
+            auto frustumCulling = world != nullptr ? std::make_shared<FrustumCulling>(renderContext.camera(), *world) : nullptr;
+            m_defaultRenderer->setFrustumCulling(frustumCulling);
+            m_lockedRenderer->setFrustumCulling(frustumCulling);
+            m_selectionRenderer->setFrustumCulling(std::move(frustumCulling));
+        }
+
         class SetupGL : public Renderable {
         private:
             void doRender(RenderContext&) override {
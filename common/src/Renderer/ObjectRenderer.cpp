@@ -147,6 +147,11 @@ namespace TrenchBroom {
             m_brushRenderer.setShowHiddenBrushes(showHiddenObjects);
         }
 
+        void ObjectRenderer::setFrustumCulling(std::shared_ptr<const FrustumCulling> frustumCulling) {
+            m_entityRenderer.setFrustumCulling(frustumCulling);
+            m_brushRenderer.setFrustumCulling(std::move(frustumCulling));
+        }
+
         void ObjectRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
             m_brushRenderer.renderOpaque(renderContext, renderBatch);
             m_patchRenderer.render(renderContext, renderBatch);
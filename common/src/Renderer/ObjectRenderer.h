@@ -24,6 +24,7 @@
 #include "Renderer/GroupRenderer.h"
 #include "Renderer/PatchRenderer.h"
 
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
@@ -44,6 +45,7 @@ namespace TrenchBroom {
 
     namespace Renderer {
         class FontManager;
+        class FrustumCulling;
         class RenderBatch;
 
         class ObjectRenderer {
@@ -93,6 +95,12 @@ namespace TrenchBroom {
             void setBrushEdgeColor(const Color& brushEdgeColor);
 
             void setShowHiddenObjects(bool showHiddenObjects);
+
+            /**
+             * Restricts rendering of brushes and entity models to the objects that are visible according to the
+             * given frustum culling. If the given culling is null, all objects are rendered.
+             */
+            void setFrustumCulling(std::shared_ptr<const FrustumCulling> frustumCulling);
         public: // rendering
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
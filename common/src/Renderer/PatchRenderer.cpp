@@ -246,8 +246,8 @@ namespace TrenchBroom {
                 void before(const Assets::Texture* texture) override {
                     shader.set("GridColor", gridColorForTexture(texture));
                     if (texture != nullptr) {
-                        texture->activate();
-                        shader.set("ApplyTexture", applyTexture);
+                        const auto resident = texture->activate();
+                        shader.set("ApplyTexture", applyTexture && resident);
                         shader.set("Color", texture->averageColor());
                     } else {
                         shader.set("ApplyTexture", false);
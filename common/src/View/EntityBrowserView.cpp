@@ -80,7 +80,8 @@ namespace TrenchBroom {
         m_logger(logger),
         m_group(false),
         m_hideUnused(false),
-        m_sortOrder(Assets::EntityDefinitionSortOrder::Name) {
+        m_sortOrder(Assets::EntityDefinitionSortOrder::Name),
+        m_waitingForModels(false) {
             const vm::quatf hRotation = vm::quatf(vm::vec3f::pos_z(), vm::to_radians(-30.0f));
             const vm::quatf vRotation = vm::quatf(vm::vec3f::pos_y(), vm::to_radians(20.0f));
             m_rotation = vRotation * hRotation;
@@ -235,6 +236,16 @@ namespace TrenchBroom {
             renderBounds(layout, y, height);
             renderModels(layout, y, height, transformation);
             renderNames(layout, y, height, projection);
+
+            // the layout shows the definition bounds of models that are still loading, rebuild it once they are loaded
+            if (m_entityModelManager.hasPendingModels()) {
+                m_waitingForModels = true;
+                update();
+            } else if (m_waitingForModels) {
+                m_waitingForModels = false;
+                invalidate();
+                update();
+            }
         }
 
         bool EntityBrowserView::doShouldRenderFocusIndicator() const {
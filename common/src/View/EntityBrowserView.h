@@ -79,6 +79,7 @@ namespace TrenchBroom {
             bool m_hideUnused;
             Assets::EntityDefinitionSortOrder m_sortOrder;
             std::string m_filterText;
+            bool m_waitingForModels;
 
             NotifierConnection m_notifierConnection;
         public:
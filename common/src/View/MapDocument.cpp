@@ -122,6 +122,7 @@
 #include <cstdlib> // for std::abs
 #include <map>
 #include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -2944,6 +2945,15 @@ namespace TrenchBroom {
 
         void MapDocument::commitPendingAssets() {
             m_textureManager->commitChanges();
+
+            const auto loadedModelPaths = m_entityModelManager->takeLoadedModelPaths();
+            if (!loadedModelPaths.empty()) {
+                setLoadedEntityModels(loadedModelPaths);
+            }
+        }
+
+        bool MapDocument::hasPendingAssets() const {
+            return m_textureManager->hasPendingUploads() || m_entityModelManager->hasPendingModels();
         }
 
         void MapDocument::pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const {
@@ -3099,12 +3109,20 @@ namespace TrenchBroom {
         void MapDocument::loadTextures() {
             try {
                 const IO::Path docDir = m_path.isEmpty() ? IO::Path() : m_path.deleteLastComponent();
+                m_textureManager->setMemoryBudget(textureMemoryBudget());
                 m_game->loadTextureCollections(m_world->entity(), docDir, *m_textureManager, logger());
             } catch (const Exception& e) {
                 error(e.what());
             }
         }
 
+        size_t MapDocument::textureMemoryBudget() const {
+            if (!pref(Preferences::LoadTexturesOnDemand)) {
+                return 0u;
+            }
+            return static_cast<size_t>(std::max(pref(Preferences::TextureMemoryBudget), 1)) * 1024u * 1024u;
+        }
+
         void MapDocument::unloadTextures() {
             unsetTextures();
             m_textureManager->clear();
@@ -3120,7 +3138,7 @@ namespace TrenchBroom {
                     const Model::Brush& brush = brushNode->brush();
                     for (size_t i = 0u; i < brush.faceCount(); ++i) {
                         const Model::BrushFace& face = brush.face(i);
-                        Assets::Texture* texture = manager.texture(face.attributes().textureName());
+                        Assets::Texture* texture = manager.cachedTexture(face.attributes().internedTextureName());
                         brushNode->setFaceTexture(i, texture);
                     }
                 },
@@ -3272,6 +3290,43 @@ namespace TrenchBroom {
             Model::Node::visitAll(nodes, makeSetEntityModelsVisitor(*this, *m_entityModelManager));
         }
 
+        /**
+         * Sets the model frames of the entities that use one of the given models, which have been loaded in the
+         * background. Until then, these entities were shown with their definition bounds.
+         */
+        void MapDocument::setLoadedEntityModels(const std::vector<IO::Path>& modelPaths) {
+            if (m_world == nullptr) {
+                return;
+            }
+
+            const auto modelPathSet = std::set<IO::Path>(std::begin(modelPaths), std::end(modelPaths));
+            auto nodes = std::vector<Model::Node*>{};
+            m_world->accept(kdl::overload(
+                [] (auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
+                [&](Model::EntityNode* entityNode)                  {
+                    const auto modelSpec = Assets::safeGetModelSpecification(*this, entityNode->entity().classname(), [&]() {
+                        return entityNode->entity().modelSpecification();
+                    });
+                    if (modelPathSet.count(modelSpec.path) > 0u) {
+                        nodes.push_back(entityNode);
+                    }
+                },
+                [] (Model::BrushNode*) {},
+                [] (Model::PatchNode*) {}
+            ));
+
+            if (!nodes.empty()) {
+                // the bounds of the parents depend on the bounds of the entities
+                const auto parents = Model::collectParents(nodes);
+                NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
+                NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
+                setEntityModels(nodes);
+                invalidateSelectionBounds();
+            }
+        }
+
         void MapDocument::unsetEntityModels() {
             m_world->accept(makeUnsetEntityModelsVisitor());
         }
@@ -3568,9 +3623,10 @@ namespace TrenchBroom {
             if (isGamePathPreference(path)) {
                 const Model::GameFactory& gameFactory = Model::GameFactory::instance();
                 const IO::Path newGamePath = gameFactory.gamePath(m_game->gameName());
-                m_game->setGamePath(newGamePath, logger());
 
+                // the entity models may reference the file systems that are replaced when the game path changes
                 clearEntityModels();
+                m_game->setGamePath(newGamePath, logger());
                 setEntityModels();
 
                 reloadTextures();
@@ -3579,6 +3635,11 @@ namespace TrenchBroom {
                        path == Preferences::TextureMagFilter.path()) {
                 m_entityModelManager->setTextureMode(pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
                 m_textureManager->setTextureMode(pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
+            } else if (path == Preferences::LoadTexturesOnDemand.path()) {
+                reloadTextures();
+                setTextures();
+            } else if (path == Preferences::TextureMemoryBudget.path()) {
+                m_textureManager->setMemoryBudget(textureMemoryBudget());
             }
         }
 
@@ -511,6 +511,11 @@ namespace TrenchBroom {
             virtual std::unique_ptr<CommandResult> doExecuteAndStore(std::unique_ptr<UndoableCommand>&& command) = 0;
         public: // asset state management
             void commitPendingAssets();
+            /**
+             * Indicates whether assets that were used for rendering are not ready yet, e.g. textures that wait to be
+             * uploaded. Views should render again after committing them.
+             */
+            bool hasPendingAssets() const;
         public: // picking
             void pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const;
             std::vector<Model::Node*> findNodesContaining(const vm::vec3& point) const;
@@ -544,6 +549,7 @@ namespace TrenchBroom {
         protected:
             void reloadTextures();
             void loadTextures();
+            size_t textureMemoryBudget() const;
             void unloadTextures();
 
             void setTextures();
@@ -562,6 +568,7 @@ namespace TrenchBroom {
 
             void setEntityModels();
             void setEntityModels(const std::vector<Model::Node*>& nodes);
+            void setLoadedEntityModels(const std::vector<IO::Path>& modelPaths);
             void unsetEntityModels();
             void unsetEntityModels(const std::vector<Model::Node*>& nodes);
         protected: // search paths and mods
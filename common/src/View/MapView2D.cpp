@@ -149,13 +149,8 @@ namespace TrenchBroom {
         }
 
         Model::PickResult MapView2D::doPick(const vm::ray3& pickRay) const {
-            auto document = kdl::mem_lock(m_document);
             const auto axis = vm::find_abs_max_component(pickRay.direction);
-
-            auto pickResult = Model::PickResult::bySize(axis);
-            document->pick(pickRay, pickResult);
-
-            return pickResult;
+            return pickDocument(pickRay, Model::PickResult::bySize(axis));
         }
 
         void MapView2D::initializeGL() {
@@ -187,11 +187,7 @@ namespace TrenchBroom {
         }
 
         Model::PickResult MapView3D::doPick(const vm::ray3& pickRay) const {
-            auto document = kdl::mem_lock(m_document);
-            Model::PickResult pickResult = Model::PickResult::byDistance();
-
-            document->pick(pickRay, pickResult);
-            return pickResult;
+            return pickDocument(pickRay, Model::PickResult::byDistance());
         }
 
         void MapView3D::doUpdateViewport(const int x, const int y, const int width, const int height) {
@@ -111,6 +111,28 @@ namespace TrenchBroom {
             createActionsAndUpdatePicking();
         }
 
+        Model::PickResult MapViewBase::pickDocument(const vm::ray3& pickRay, Model::PickResult pickResult) const {
+            auto document = kdl::mem_lock(m_document);
+            const auto modificationCount = document->modificationCount();
+            const auto editorContextRevision = document->editorContext().revision();
+
+            if (m_pickCache
+                && m_pickCache->pickRay.origin == pickRay.origin
+                && m_pickCache->pickRay.direction == pickRay.direction
+                && m_pickCache->modificationCount == modificationCount
+                && m_pickCache->editorContextRevision == editorContextRevision) {
+                return m_pickCache->pickResult;
+            }
+
+            document->pick(pickRay, pickResult);
+            m_pickCache = PickCache{pickRay, modificationCount, editorContextRevision, pickResult};
+            return pickResult;
+        }
+
+        void MapViewBase::invalidatePickCache() {
+            m_pickCache = std::nullopt;
+        }
+
         MapViewBase::~MapViewBase() {
             // Deleting m_compass will access the VBO so we need to be current
             // see: http://doc.qt.io/qt-5/qopenglwidget.html#resource-initialization-and-cleanup
@@ -159,10 +181,12 @@ namespace TrenchBroom {
         void MapViewBase::createActionsAndUpdatePicking() {
             createActions();
             updateActionStates();
+            invalidatePickCache();
             updatePickResult();
         }
 
         void MapViewBase::nodesDidChange(const std::vector<Model::Node*>&) {
+            invalidatePickCache();
             updatePickResult();
             update();
         }
@@ -175,12 +199,14 @@ namespace TrenchBroom {
 
         void MapViewBase::commandDone(Command*) {
             updateActionStates();
+            invalidatePickCache();
             updatePickResult();
             update();
         }
 
         void MapViewBase::commandUndone(UndoableCommand*) {
             updateActionStates();
+            invalidatePickCache();
             updatePickResult();
             update();
         }
@@ -194,12 +220,14 @@ namespace TrenchBroom {
         }
 
         void MapViewBase::entityDefinitionsDidChange() {
+            invalidatePickCache();
             createActions();
             updateActionStates();
             update();
         }
 
         void MapViewBase::modsDidChange() {
+            invalidatePickCache();
             update();
         }
 
@@ -225,6 +253,8 @@ namespace TrenchBroom {
                 fontManager().clearCache();
             }
 
+            // preferences such as ShowBrushes affect which nodes are visible and thus pickable
+            invalidatePickCache();
             updateActionBindings();
             update();
         }
@@ -840,6 +870,10 @@ namespace TrenchBroom {
             renderFPS(renderContext, renderBatch);
 
             renderBatch.render(renderContext);
+
+            if (document->hasPendingAssets()) {
+                update();
+            }
         }
 
         void MapViewBase::setupGL(Renderer::RenderContext& context) {
@@ -20,13 +20,17 @@
 #pragma once
 
 #include "NotifierConnection.h"
+#include "Model/PickResult.h"
 #include "View/ActionContext.h"
 #include "View/CameraLinkHelper.h"
 #include "View/MapView.h"
 #include "View/RenderView.h"
 #include "View/ToolBoxConnector.h"
 
+#include <vecmath/ray.h>
+
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -99,6 +103,19 @@ namespace TrenchBroom {
             bool m_isCurrent;
 
             NotifierConnection m_notifierConnection;
+
+            struct PickCache {
+                vm::ray3 pickRay;
+                size_t modificationCount;
+                size_t editorContextRevision;
+                Model::PickResult pickResult;
+            };
+
+            /**
+             * The result of the most recent call to pickDocument. Mouse and keyboard events frequently request a new
+             * pick result for an unchanged ray, e.g. when a mouse button is pressed or a modifier key changes.
+             */
+            mutable std::optional<PickCache> m_pickCache;
         private: // shortcuts
             std::vector<std::pair<QShortcut*, const Action*>> m_shortcuts;
         protected:
@@ -117,6 +134,16 @@ namespace TrenchBroom {
              * no document notifications to handle these tasks, so it must be done by the constructor.
              */
             void mapViewBaseVirtualInit();
+
+            /**
+             * Picks the objects of the document with the given ray and returns the given pick result with the hits
+             * added.
+             *
+             * The result is reused if the ray, the document's modification count and the editor context's revision
+             * are unchanged since the previous call and if the document didn't notify any changes since then.
+             */
+            Model::PickResult pickDocument(const vm::ray3& pickRay, Model::PickResult pickResult) const;
+            void invalidatePickCache();
         public:
             ~MapViewBase() override;
         public:
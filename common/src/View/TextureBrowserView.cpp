@@ -297,6 +297,11 @@ namespace TrenchBroom {
             renderBounds(layout, y, height);
             renderTextures(layout, y, height);
             renderNames(layout, y, height);
+
+            // render again once the textures requested by this frame are uploaded
+            if (doc->textureManager().hasPendingUploads()) {
+                update();
+            }
         }
 
         bool TextureBrowserView::doShouldRenderFocusIndicator() const {
@@ -376,7 +381,9 @@ namespace TrenchBroom {
                                 }));
 
                                 shader.set("GrayScale", texture->overridden());
-                                texture->activate();
+                                const auto resident = texture->activate(Assets::TextureUploadPriority::Browser);
+                                shader.set("ApplyTexture", resident);
+                                shader.set("Color", texture->averageColor());
 
                                 vertexArray.prepare(vboManager());
                                 vertexArray.render(Renderer::PrimType::Quads);
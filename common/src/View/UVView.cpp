@@ -162,6 +162,10 @@ namespace TrenchBroom {
                 renderTextureAxes(renderContext, renderBatch);
 
                 renderBatch.render(renderContext);
+
+                if (document->hasPendingAssets()) {
+                    update();
+                }
             }
         }
 
@@ -242,10 +246,10 @@ namespace TrenchBroom {
                 const auto* texture = m_helper.face()->texture();
                 ensure(texture != nullptr, "texture is null");
 
-                texture->activate();
+                const auto resident = texture->activate();
 
                 Renderer::ActiveShader shader(renderContext.shaderManager(), Renderer::Shaders::UVViewShader);
-                shader.set("ApplyTexture", true);
+                shader.set("ApplyTexture", resident);
                 shader.set("Color", texture->averageColor());
                 shader.set("Brightness", pref(Preferences::Brightness));
                 shader.set("RenderGrid", true);
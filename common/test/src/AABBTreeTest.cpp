@@ -20,8 +20,10 @@
 #include "AABBTree.h"
 
 #include <vecmath/vec.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 
+#include <numeric>
 #include <set>
 #include <sstream>
 
@@ -32,6 +34,7 @@ namespace TrenchBroom {
     using BOX = AABB::Box;
     using RAY = vm::ray<AABB::FloatType, AABB::Components>;
     using VEC = vm::vec<AABB::FloatType, AABB::Components>;
+    using PLANE = vm::plane<AABB::FloatType, AABB::Components>;
 
 
     static void assertTree(const std::string& exp, const AABB& actual) {
@@ -550,4 +553,141 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
         CHECK_FALSE(tree.contains(2u));
         REQUIRE_THAT(tree.findContainers(vm::vec3d{0.5, 0.5, 0.5}), Catch::UnorderedEquals(std::vector<size_t>{}));
     }
+
+    static std::vector<BOX> makeGridBounds(const size_t countPerAxis) {
+        auto result = std::vector<BOX>{};
+        for (size_t x = 0; x < countPerAxis; ++x) {
+            for (size_t y = 0; y < countPerAxis; ++y) {
+                for (size_t z = 0; z < countPerAxis; ++z) {
+                    const auto min = VEC(double(x), double(y), double(z)) * 2.0;
+                    const auto size = 1.0 + double((x + y + z) % 3);
+                    result.emplace_back(min, min + VEC(size, size, size));
+                }
+            }
+        }
+        return result;
+    }
+
+    static void assertQueriesMatchBounds(const AABB& tree, const std::vector<BOX>& bounds, const std::vector<VEC>& points, const std::vector<RAY>& rays) {
+        for (const auto& point : points) {
+            auto expected = std::vector<size_t>{};
+            for (size_t i = 0; i < bounds.size(); ++i) {
+                if (tree.contains(i) && bounds[i].contains(point)) {
+                    expected.push_back(i);
+                }
+            }
+            CHECK_THAT(tree.findContainers(point), Catch::UnorderedEquals(expected));
+        }
+
+        for (const auto& ray : rays) {
+            auto expected = std::vector<size_t>{};
+            for (size_t i = 0; i < bounds.size(); ++i) {
+                if (tree.contains(i) && (bounds[i].contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds[i])))) {
+                    expected.push_back(i);
+                }
+            }
+            CHECK_THAT(tree.findIntersectors(ray), Catch::UnorderedEquals(expected));
+        }
+    }
+
+    TEST_CASE("AABBTreeTest.clearAndBuild", "[AABBTreeTest]") {
+        // large enough for the subtrees to be built in parallel
+        const auto bounds = makeGridBounds(18u);
+
+        auto indices = std::vector<size_t>(bounds.size());
+        std::iota(std::begin(indices), std::end(indices), 0u);
+
+        AABB tree;
+        tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), bounds.size());
+        tree.clearAndBuild(indices, [&](const size_t i) { return bounds[i]; });
+
+        CHECK_FALSE(tree.contains(bounds.size()));
+        for (const auto i : indices) {
+            CHECK(tree.contains(i));
+        }
+        CHECK(tree.bounds() == BOX(VEC(0.0, 0.0, 0.0), VEC(37.0, 37.0, 37.0)));
+
+        const auto points = std::vector<VEC>{
+            VEC(0.5, 0.5, 0.5),
+            VEC(2.0, 3.0, 2.5),
+            VEC(17.0, 21.0, 9.5),
+            VEC(36.5, 36.5, 36.5),
+            VEC(-1.0, 0.0, 0.0),
+        };
+        const auto rays = std::vector<RAY>{
+            RAY(VEC(-1.0, 0.5, 0.5), VEC::pos_x()),
+            RAY(VEC(10.5, -1.0, 20.5), VEC::pos_y()),
+            RAY(VEC(17.0, 21.0, 9.5), VEC::neg_z()),
+            RAY(VEC(-1.0, 0.5, 0.5), VEC::neg_x()),
+        };
+
+        assertQueriesMatchBounds(tree, bounds, points, rays);
+
+        SECTION("Modifying the tree after building it") {
+            tree.remove(0u);
+            tree.update(BOX(VEC(20.0, 20.0, 20.0), VEC(21.0, 21.0, 21.0)), 1u);
+
+            auto modifiedBounds = bounds;
+            modifiedBounds[1u] = BOX(VEC(20.0, 20.0, 20.0), VEC(21.0, 21.0, 21.0));
+
+            CHECK_FALSE(tree.contains(0u));
+            assertQueriesMatchBounds(tree, modifiedBounds, points, rays);
+        }
+
+        SECTION("Rebuilding with duplicate data") {
+            const auto duplicates = std::vector<size_t>{0u, 1u, 0u};
+            CHECK_THROWS_AS(tree.clearAndBuild(duplicates, [&](const size_t i) { return bounds[i]; }), NodeTreeException);
+            CHECK(tree.empty());
+            CHECK_FALSE(tree.contains(0u));
+            CHECK(tree.findContainers(VEC(0.5, 0.5, 0.5)).empty());
+        }
+
+        SECTION("Rebuilding with a single object") {
+            tree.clearAndBuild(std::vector<size_t>{3u}, [&](const size_t i) { return bounds[i]; });
+            CHECK(tree.height() == 1u);
+            CHECK(tree.findContainers(bounds[3u].center()) == std::vector<size_t>{3u});
+        }
+    }
+
+    TEST_CASE("AABBTreeTest.findInFrustum", "[AABBTreeTest]") {
+        const auto bounds = makeGridBounds(8u);
+
+        auto indices = std::vector<size_t>(bounds.size());
+        std::iota(std::begin(indices), std::end(indices), 0u);
+
+        // a frustum with axis aligned planes, so that the test for the bounds is exact
+        const auto frustumPlanes = std::vector<PLANE>{
+            PLANE(VEC(4.5, 0.0, 0.0), VEC::neg_x()),
+            PLANE(VEC(10.0, 0.0, 0.0), VEC::pos_x()),
+            PLANE(VEC(0.0, 3.0, 0.0), VEC::neg_y()),
+            PLANE(VEC(0.0, 7.5, 0.0), VEC::pos_y()),
+        };
+
+        auto expected = std::vector<size_t>{};
+        for (const auto i : indices) {
+            const auto& box = bounds[i];
+            if (box.max.x() >= 4.5 && box.min.x() <= 10.0 && box.max.y() >= 3.0 && box.min.y() <= 7.5) {
+                expected.push_back(i);
+            }
+        }
+        REQUIRE(!expected.empty());
+        REQUIRE(expected.size() < indices.size());
+
+        AABB tree;
+        SECTION("Tree built in bulk") {
+            tree.clearAndBuild(indices, [&](const size_t i) { return bounds[i]; });
+            CHECK_THAT(tree.findInFrustum(frustumPlanes), Catch::UnorderedEquals(expected));
+        }
+
+        SECTION("Tree built incrementally") {
+            for (const auto i : indices) {
+                tree.insert(bounds[i], i);
+            }
+            CHECK_THAT(tree.findInFrustum(frustumPlanes), Catch::UnorderedEquals(expected));
+        }
+
+        SECTION("Empty tree") {
+            CHECK(tree.findInFrustum(frustumPlanes).empty());
+        }
+    }
 }
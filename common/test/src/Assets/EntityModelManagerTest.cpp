@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Exceptions.h"
+#include "Logger.h"
+#include "Assets/EntityModel.h"
+#include "Assets/EntityModelManager.h"
+#include "Assets/ModelDefinition.h"
+#include "IO/EntityModelLoader.h"
+#include "IO/Path.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        class TestEntityModelLoader : public IO::EntityModelLoader {
+        private:
+            std::unique_ptr<EntityModel> doInitializeModel(const IO::Path& path, Logger& /* logger */) const override {
+                if (path.extension() != "mdl") {
+                    throw GameException("Unsupported model format '" + path.asString() + "'");
+                }
+
+                auto model = std::make_unique<EntityModel>(path.asString(), PitchType::Normal);
+                model->addFrames(2);
+                return model;
+            }
+
+            void doLoadFrame(const IO::Path& /* path */, const size_t frameIndex, EntityModel& model, Logger& /* logger */) const override {
+                model.loadFrame(frameIndex, "frame", vm::bbox3f{8.0f});
+            }
+        };
+
+        static std::vector<IO::Path> waitForLoadedModels(EntityModelManager& manager) {
+            auto result = std::vector<IO::Path>{};
+            while (manager.hasPendingModels()) {
+                result = kdl::vec_concat(std::move(result), manager.takeLoadedModelPaths());
+                std::this_thread::yield();
+            }
+            return result;
+        }
+
+        TEST_CASE("EntityModelManagerTest.loadModelAsync", "[EntityModelManagerTest]") {
+            auto logger = NullLogger{};
+            auto loader = TestEntityModelLoader{};
+
+            auto manager = EntityModelManager{0, 0, logger};
+            manager.setLoader(&loader);
+
+            const auto spec = ModelSpecification{IO::Path("models/test.mdl"), 0, 1};
+            CHECK(manager.frame(spec) == nullptr);
+
+            CHECK(waitForLoadedModels(manager) == std::vector<IO::Path>{spec.path});
+
+            const auto* frame = manager.frame(spec);
+            REQUIRE(frame != nullptr);
+            CHECK(frame->loaded());
+            CHECK(frame->index() == 1u);
+
+            // a frame requested after the model was loaded is loaded immediately
+            const auto* otherFrame = manager.frame(ModelSpecification{spec.path, 0, 0});
+            REQUIRE(otherFrame != nullptr);
+            CHECK(otherFrame->loaded());
+            CHECK_FALSE(manager.hasPendingModels());
+        }
+
+        TEST_CASE("EntityModelManagerTest.loadInvalidModelAsync", "[EntityModelManagerTest]") {
+            auto logger = NullLogger{};
+            auto loader = TestEntityModelLoader{};
+
+            auto manager = EntityModelManager{0, 0, logger};
+            manager.setLoader(&loader);
+
+            const auto spec = ModelSpecification{IO::Path("models/test.abc"), 0, 0};
+            CHECK(manager.frame(spec) == nullptr);
+            CHECK(waitForLoadedModels(manager).empty());
+
+            // the model is not loaded again
+            CHECK(manager.frame(spec) == nullptr);
+            CHECK_FALSE(manager.hasPendingModels());
+        }
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Assets/TextureUploadQueue.h"
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        static std::vector<std::string> uploadAll(TextureUploadQueue& queue) {
+            auto uploaded = std::vector<std::string>{};
+            queue.upload(0u, std::chrono::milliseconds{0}, [&](const Texture& texture) {
+                uploaded.push_back(texture.name());
+                return size_t(0);
+            });
+            return uploaded;
+        }
+
+        TEST_CASE("TextureUploadQueueTest.uploadByPriority", "[TextureUploadQueueTest]") {
+            const auto a = Texture{"a", 8, 8};
+            const auto b = Texture{"b", 8, 8};
+            const auto c = Texture{"c", 8, 8};
+            const auto d = Texture{"d", 8, 8};
+
+            auto queue = TextureUploadQueue{};
+            queue.push(a, std::nullopt);
+            queue.push(b, TextureUploadPriority::Browser);
+            queue.push(c, TextureUploadPriority::Visible);
+            queue.push(d, std::nullopt);
+
+            CHECK(queue.size() == 4u);
+            CHECK(queue.requestedCount() == 2u);
+
+            SECTION("Requested textures are uploaded first") {
+                CHECK(uploadAll(queue) == std::vector<std::string>{"c", "b", "a", "d"});
+            }
+
+            SECTION("Raising the priority of a queued texture") {
+                queue.push(a, TextureUploadPriority::Visible);
+                queue.push(d, TextureUploadPriority::Browser);
+
+                CHECK(queue.size() == 4u);
+                CHECK(queue.requestedCount() == 4u);
+                CHECK(uploadAll(queue) == std::vector<std::string>{"c", "a", "b", "d"});
+            }
+
+            SECTION("Lowering the priority of a queued texture has no effect") {
+                queue.push(c, TextureUploadPriority::Browser);
+                queue.push(b, std::nullopt);
+
+                CHECK(queue.size() == 4u);
+                CHECK(queue.requestedCount() == 2u);
+                CHECK(uploadAll(queue) == std::vector<std::string>{"c", "b", "a", "d"});
+            }
+
+            SECTION("Removed textures are not uploaded") {
+                queue.push(a, TextureUploadPriority::Visible);
+                queue.remove(a);
+                queue.remove(b);
+
+                CHECK(queue.size() == 2u);
+                CHECK(queue.requestedCount() == 1u);
+                CHECK(uploadAll(queue) == std::vector<std::string>{"c", "d"});
+            }
+
+            SECTION("Uploaded textures can be queued again") {
+                uploadAll(queue);
+                CHECK(queue.size() == 0u);
+
+                queue.push(a, TextureUploadPriority::Browser);
+                CHECK(queue.size() == 1u);
+                CHECK(queue.requestedCount() == 1u);
+                CHECK(uploadAll(queue) == std::vector<std::string>{"a"});
+            }
+        }
+
+        TEST_CASE("TextureUploadQueueTest.uploadBudget", "[TextureUploadQueueTest]") {
+            const auto a = Texture{"a", 8, 8};
+            const auto b = Texture{"b", 8, 8};
+            const auto c = Texture{"c", 8, 8};
+
+            auto queue = TextureUploadQueue{};
+            queue.push(a, TextureUploadPriority::Visible);
+            queue.push(b, TextureUploadPriority::Browser);
+            queue.push(c, std::nullopt);
+
+            auto uploaded = std::vector<std::string>{};
+
+            SECTION("Byte budget") {
+                const auto uploadTexture = [&](const Texture& texture) {
+                    uploaded.push_back(texture.name());
+                    return size_t(60);
+                };
+
+                auto stats = queue.upload(100u, std::chrono::milliseconds{0}, uploadTexture);
+                CHECK(uploaded == std::vector<std::string>{"a", "b"});
+                CHECK(stats.uploadedTextures == 2u);
+                CHECK(stats.uploadedBytes == 120u);
+                CHECK(stats.queuedTextures == 1u);
+                CHECK(stats.requestedTextures == 0u);
+                CHECK(stats.totalUploadedBytes == 0u);
+
+                stats = queue.upload(100u, std::chrono::milliseconds{0}, uploadTexture);
+                CHECK(uploaded == std::vector<std::string>{"a", "b", "c"});
+                CHECK(stats.uploadedTextures == 1u);
+                CHECK(stats.uploadedBytes == 60u);
+                CHECK(stats.queuedTextures == 0u);
+                CHECK(stats.requestedTextures == 0u);
+            }
+
+            SECTION("At least one texture is uploaded") {
+                const auto stats = queue.upload(1u, std::chrono::milliseconds{0}, [&](const Texture& texture) {
+                    uploaded.push_back(texture.name());
+                    return size_t(60);
+                });
+
+                CHECK(uploaded == std::vector<std::string>{"a"});
+                CHECK(stats.uploadedTextures == 1u);
+                CHECK(stats.uploadedBytes == 60u);
+                CHECK(stats.queuedTextures == 2u);
+                CHECK(stats.requestedTextures == 1u);
+            }
+
+            SECTION("Time budget") {
+                const auto stats = queue.upload(0u, std::chrono::milliseconds{1}, [&](const Texture& texture) {
+                    uploaded.push_back(texture.name());
+                    std::this_thread::sleep_for(std::chrono::milliseconds{2});
+                    return size_t(60);
+                });
+
+                CHECK(uploaded == std::vector<std::string>{"a"});
+                CHECK(stats.uploadedTextures == 1u);
+                CHECK(stats.queuedTextures == 2u);
+                CHECK(stats.requestedTextures == 1u);
+            }
+
+            SECTION("Stale entries do not count against the budget") {
+                queue.push(c, TextureUploadPriority::Visible);
+
+                const auto stats = queue.upload(100u, std::chrono::milliseconds{0}, [&](const Texture& texture) {
+                    uploaded.push_back(texture.name());
+                    return size_t(60);
+                });
+
+                CHECK(uploaded == std::vector<std::string>{"a", "c"});
+                CHECK(stats.uploadedTextures == 2u);
+                CHECK(stats.queuedTextures == 1u);
+                CHECK(stats.requestedTextures == 1u);
+            }
+        }
+    }
+}
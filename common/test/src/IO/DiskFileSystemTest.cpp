@@ -147,6 +147,15 @@ namespace TrenchBroom {
             CHECK_THROWS_AS(Disk::openFile(env.dir() + Path("does_not_exist.txt")), FileNotFoundException);
             CHECK(Disk::openFile(env.dir() + Path("test.txt")) != nullptr);
             CHECK(Disk::openFile(env.dir() + Path("anotherDir/subDirTest/test2.map")) != nullptr);
+
+            const auto file = Disk::openFile(env.dir() + Path("test.txt"));
+            CHECK(file->size() == 12U);
+
+            const auto bufferedReader = file->reader().buffer();
+            CHECK(bufferedReader.stringView() == "some content");
+
+            // the file is memory mapped, so buffering its reader must not copy its contents
+            CHECK(file->reader().buffer().begin() == bufferedReader.begin());
         }
 
         TEST_CASE("DiskTest.resolvePath", "[DiskTest]") {
@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -885,6 +886,87 @@ decor_goddess_statue : "Goddess Statue" [])";
             kdl::vec_clear_and_delete(defs);
         }
 
+        TEST_CASE("FgdParserTest.parseIncludeMessageOrder", "[FgdParserTest]") {
+            const Path path = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Fgd/parseIncludeMessageOrder/host.fgd");
+            auto file = Disk::openFile(path);
+            auto reader = file->reader().buffer();
+
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(reader.stringView(), defaultColor, file->path());
+
+            TestParserStatus status;
+            auto defs = parser.parseDefinitions(status);
+            CHECK(defs.size() == 4u);
+
+            // the messages of the included files are logged at the positions of the include directives
+            auto includeMessages = std::vector<std::string>{};
+            for (const auto& message : status.messages(LogLevel::Debug)) {
+                if (message.find("Parsing included file") != std::string::npos) {
+                    includeMessages.push_back(message);
+                }
+            }
+            REQUIRE(includeMessages.size() == 3u);
+            CHECK_THAT(includeMessages[0], Catch::Contains("'first.fgd'"));
+            CHECK_THAT(includeMessages[1], Catch::Contains("'nested.fgd'"));
+            CHECK_THAT(includeMessages[2], Catch::Contains("'second.fgd'"));
+
+            kdl::vec_clear_and_delete(defs);
+        }
+
+        TEST_CASE("FgdParserTest.parseCachedDefinitions", "[FgdParserTest]") {
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+
+            const auto parseFile = [&](const Path& path, TestParserStatus& status) {
+                auto file = Disk::openFile(path);
+                auto reader = file->reader().buffer();
+
+                FgdParser parser(reader.stringView(), defaultColor, file->path());
+                return parser.parseDefinitions(status, file->path());
+            };
+
+            SECTION("Definitions are parsed again from the cache") {
+                const Path path = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Fgd/parseNestedInclude/host.fgd");
+
+                for (size_t i = 0; i < 2; ++i) {
+                    TestParserStatus status;
+                    auto defs = parseFile(path, status);
+                    CHECK(defs.size() == 3u);
+                    CHECK(std::any_of(std::begin(defs), std::end(defs), [](const auto* def) { return def->name() == "worldspawn"; }));
+                    CHECK(std::any_of(std::begin(defs), std::end(defs), [](const auto* def) { return def->name() == "info_player_start"; }));
+                    CHECK(std::any_of(std::begin(defs), std::end(defs), [](const auto* def) { return def->name() == "info_player_coop"; }));
+
+                    kdl::vec_clear_and_delete(defs);
+                }
+            }
+
+            SECTION("Cached definitions are used without parsing the file again") {
+                const Path path = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Fgd/parseNestedInclude/host.fgd");
+
+                TestParserStatus status;
+                kdl::vec_clear_and_delete(parseFile(path, status));
+
+                // a parser that reads nothing returns the definitions of the file only if they were cached
+                FgdParser emptyParser("", defaultColor);
+                auto defs = emptyParser.parseDefinitions(status, path);
+                CHECK(defs.size() == 3u);
+
+                kdl::vec_clear_and_delete(defs);
+            }
+
+            SECTION("Messages are logged again when cached definitions are used") {
+                const Path path = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Fgd/parseRecursiveInclude/host.fgd");
+
+                for (size_t i = 0; i < 2; ++i) {
+                    TestParserStatus status;
+                    auto defs = parseFile(path, status);
+                    CHECK(defs.size() == 1u);
+                    CHECK(status.countStatus(LogLevel::Error) == 1u);
+
+                    kdl::vec_clear_and_delete(defs);
+                }
+            }
+        }
+
         TEST_CASE("FgdParserTest.parseStringContinuations", "[FgdParserTest]") {
             const std::string file =
                 "@PointClass = cont_description :\n"
@@ -20,12 +20,16 @@
 #include "TestLogger.h"
 
 #include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
 #include "IO/DiskIO.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/FreeImageTextureReader.h"
 #include "IO/Path.h"
 #include "IO/TextureReader.h"
 
+#include <vecmath/vec.h>
+
+#include <cstdlib>
 #include <string>
 
 #include "TestUtils.h"
@@ -85,7 +89,7 @@ namespace TrenchBroom {
 
             CHECK(texture.width() == w);
             CHECK(texture.height() == h);
-            CHECK(texture.buffersIfUnprepared().size() == 1u);
+            CHECK(texture.buffersIfUnprepared().size() == 7u);
             CHECK((GL_BGRA == texture.format() || GL_RGBA == texture.format()));
             CHECK(texture.type() == Assets::TextureType::Opaque);
 
@@ -113,6 +117,37 @@ namespace TrenchBroom {
             testImageContents(loadTexture("jpgContentsTest.jpg"), ColorMatch::Approximate);
         }
 
+        TEST_CASE("FreeImageTextureReaderTest.testGenerateMips", "[FreeImageTextureReaderTest]") {
+            const auto texture = loadTexture("707x710.png");
+            const auto& buffers = texture.buffersIfUnprepared();
+            REQUIRE(buffers.size() == 10u);
+
+            for (size_t level = 0; level < buffers.size(); ++level) {
+                const auto mipSize = Assets::sizeAtMipLevel(707u, 710u, level);
+                CHECK(buffers[level].size() == 4u * mipSize.x() * mipSize.y());
+            }
+            CHECK(Assets::sizeAtMipLevel(707u, 710u, 9u) == vm::vec2s(1u, 1u));
+        }
+
+        TEST_CASE("FreeImageTextureReaderTest.testMipContents", "[FreeImageTextureReaderTest]") {
+            const auto texture = loadTexture("pngContentsTest.png");
+            const auto& buffers = texture.buffersIfUnprepared();
+            REQUIRE(buffers.size() == 7u);
+
+            // the red and green corner pixels are averaged away in linear space
+            const auto& mip1 = buffers[1];
+            for (size_t i = 0; i < 4u; ++i) {
+                CHECK(std::abs(int(mip1.data()[4u * 33u + i]) - (i == 3u ? 255 : 161)) <= 1);
+            }
+
+            const auto& mip6 = buffers[6];
+            REQUIRE(mip6.size() == 4u);
+            for (size_t i = 0; i < 3u; ++i) {
+                CHECK(std::abs(int(mip6.data()[i]) - 161) <= 1);
+            }
+            CHECK(int(mip6.data()[3]) == 255);
+        }
+
         TEST_CASE("FreeImageTextureReaderTest.alphaMaskTest", "[FreeImageTextureReaderTest]") {
             const auto texture = loadTexture("alphaMaskTest.png");
             const std::size_t w = 25u;
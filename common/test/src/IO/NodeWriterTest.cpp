@@ -18,6 +18,7 @@
  */
 
 #include "Exceptions.h"
+#include "IO/MapFileSerializer.h"
 #include "IO/NodeWriter.h"
 #include "Model/BezierPatch.h"
 #include "Model/BrushNode.h"
@@ -1181,6 +1182,148 @@ common/caulk
             CHECK(actual == expected);
         }
 
+        TEST_CASE("NodeWriterTest.writeMapWithMemoryBudget", "[NodeWriterTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+
+            auto map = Model::WorldNode{Model::Entity{}, Model::MapFormat::Standard};
+            const Model::BrushBuilder builder(map.mapFormat(), worldBounds);
+            const auto createBrushNode = [&](const std::string& textureName) {
+                return new Model::BrushNode{builder.createCube(64.0, textureName).value()};
+            };
+
+            auto* groupNode = new Model::GroupNode{Model::Group{"Group"}};
+            groupNode->addChild(createBrushNode("group1"));
+            groupNode->addChild(createBrushNode("group2"));
+
+            auto* entityNode = new Model::EntityNode{Model::Entity({{"classname", "func_door"}})};
+            entityNode->addChild(createBrushNode("entity"));
+
+            auto* layerNode = new Model::LayerNode{Model::Layer{"Custom Layer"}};
+            layerNode->addChild(createBrushNode("layer"));
+
+            map.defaultLayer()->addChild(createBrushNode("world1"));
+            map.defaultLayer()->addChild(groupNode);
+            map.defaultLayer()->addChild(createBrushNode("world2"));
+            map.defaultLayer()->addChild(entityNode);
+            map.defaultLayer()->addChild(new Model::PatchNode{Model::BezierPatch{3, 3, {
+                {0, 0, 0, 0, 0}, {1, 0, 0, 0, 0}, {2, 0, 0, 0, 0},
+                {0, 1, 0, 0, 0}, {1, 1, 0, 0, 0}, {2, 1, 0, 0, 0},
+                {0, 2, 0, 0, 0}, {1, 2, 0, 0, 0}, {2, 2, 0, 0, 0} }, "patch"}});
+            map.addChild(layerNode);
+
+            const auto writeMap = [&](const size_t memoryBudget) {
+                auto str = std::stringstream{};
+                auto writer = NodeWriter{map, MapFileSerializer::create(map.mapFormat(), str, memoryBudget)};
+                writer.writeMap();
+                return str.str();
+            };
+
+            const auto writeNodes = [&](const size_t memoryBudget) {
+                auto str = std::stringstream{};
+                auto writer = NodeWriter{map, MapFileSerializer::create(map.mapFormat(), str, memoryBudget)};
+                writer.writeNodes({groupNode, entityNode, map.defaultLayer()->children().front()});
+                return str.str();
+            };
+
+            const auto expectedMap = writeMap(MapFileSerializer::DefaultMemoryBudget);
+            const auto expectedNodes = writeNodes(MapFileSerializer::DefaultMemoryBudget);
+
+            const auto memoryBudget = GENERATE(size_t(0), size_t(2000), size_t(4000));
+            CAPTURE(memoryBudget);
+
+            CHECK(writeMap(memoryBudget) == expectedMap);
+            CHECK(writeNodes(memoryBudget) == expectedNodes);
+        }
+
+        TEST_CASE("NodeWriterTest.exportMapDoesNotSerializeOmittedLayers", "[NodeWriterTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+
+            auto map = Model::WorldNode{Model::Entity{}, Model::MapFormat::Standard};
+            const Model::BrushBuilder builder(map.mapFormat(), worldBounds);
+
+            auto* worldBrushNode = new Model::BrushNode{builder.createCube(64.0, "world").value()};
+            map.defaultLayer()->addChild(worldBrushNode);
+
+            auto layer = Model::Layer{"Omitted Layer"};
+            layer.setOmitFromExport(true);
+            auto* layerNode = new Model::LayerNode{std::move(layer)};
+            auto* omittedBrushNode = new Model::BrushNode{builder.createCube(64.0, "omitted").value()};
+            layerNode->addChild(omittedBrushNode);
+            map.addChild(layerNode);
+
+            auto str = std::stringstream{};
+            auto writer = NodeWriter{map, MapFileSerializer::create(map.mapFormat(), str, 0u)};
+            writer.setExporting(true);
+            writer.writeMap();
+
+            CHECK(str.str().find("omitted") == std::string::npos);
+            CHECK(worldBrushNode->cachedSerialization(Model::MapFormat::Standard) != nullptr);
+            CHECK(omittedBrushNode->cachedSerialization(Model::MapFormat::Standard) == nullptr);
+        }
+
+        TEST_CASE("NodeWriterTest.writeMapWithCachedSerializations", "[NodeWriterTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+
+            auto map = Model::WorldNode{Model::Entity{}, Model::MapFormat::Standard};
+            const Model::BrushBuilder builder(map.mapFormat(), worldBounds);
 
+            auto* brushNode1 = new Model::BrushNode{builder.createCube(64.0, "tex1").value()};
+            auto* brushNode2 = new Model::BrushNode{builder.createCube(64.0, "tex2").value()};
+            map.defaultLayer()->addChild(brushNode1);
+            map.defaultLayer()->addChild(brushNode2);
+
+            const auto writeMap = [&]() {
+                auto str = std::stringstream{};
+                auto writer = NodeWriter{map, str};
+                writer.writeMap();
+                return str.str();
+            };
+
+            CHECK(brushNode1->cachedSerialization(Model::MapFormat::Standard) == nullptr);
+            const auto cachedBytes = Model::Node::cachedSerializationBytes();
+
+            const auto original = writeMap();
+            const auto cachedSerialization1 = brushNode1->cachedSerialization(Model::MapFormat::Standard);
+            const auto cachedSerialization2 = brushNode2->cachedSerialization(Model::MapFormat::Standard);
+            REQUIRE(cachedSerialization1 != nullptr);
+            REQUIRE(cachedSerialization2 != nullptr);
+            CHECK(cachedSerialization1->lineCount == 6u);
+            CHECK(brushNode1->cachedSerialization(Model::MapFormat::Valve) == nullptr);
+            CHECK(Model::Node::cachedSerializationBytes() == cachedBytes + cachedSerialization1->text.size() + cachedSerialization2->text.size());
+
+            // writing again uses the cached serializations
+            CHECK(writeMap() == original);
+            CHECK(brushNode1->cachedSerialization(Model::MapFormat::Standard) == cachedSerialization1);
+
+            // changing a node invalidates its cached serialization only
+            brushNode1->setBrush(builder.createCube(64.0, "tex3").value());
+            CHECK(brushNode1->cachedSerialization(Model::MapFormat::Standard) == nullptr);
+            CHECK(brushNode2->cachedSerialization(Model::MapFormat::Standard) == cachedSerialization2);
+            CHECK(Model::Node::cachedSerializationBytes() == cachedBytes + cachedSerialization2->text.size());
+
+            const auto changed = writeMap();
+            CHECK(changed != original);
+            CHECK(changed.find("tex1") == std::string::npos);
+            CHECK(changed.find("tex3") != std::string::npos);
+            CHECK(brushNode2->cachedSerialization(Model::MapFormat::Standard) == cachedSerialization2);
+        }
+
+        TEST_CASE("NodeWriterTest.cachedSerializationsAreBounded", "[NodeWriterTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            const Model::BrushBuilder builder(Model::MapFormat::Standard, worldBounds);
+
+            auto brushNode = Model::BrushNode{builder.createCube(64.0, "tex").value()};
+            const auto cachedBytes = Model::Node::cachedSerializationBytes();
+
+            brushNode.setCachedSerialization(std::make_shared<const Model::CachedSerialization>(Model::CachedSerialization{Model::MapFormat::Standard, "text", 1u}));
+            CHECK(brushNode.cachedSerialization(Model::MapFormat::Standard) != nullptr);
+            CHECK(Model::Node::cachedSerializationBytes() == cachedBytes + 4u);
+
+            // a text that exceeds the limit is not cached and releases the previous text
+            auto hugeText = std::string(Model::Node::MaxCachedSerializationBytes - cachedBytes + 1u, ' ');
+            brushNode.setCachedSerialization(std::make_shared<const Model::CachedSerialization>(Model::CachedSerialization{Model::MapFormat::Standard, std::move(hugeText), 1u}));
+            CHECK(brushNode.cachedSerialization(Model::MapFormat::Standard) == nullptr);
+            CHECK(Model::Node::cachedSerializationBytes() == cachedBytes);
+        }
     }
 }
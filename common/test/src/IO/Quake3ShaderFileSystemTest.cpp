@@ -21,9 +21,11 @@
 #include "Assets/Quake3Shader.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/Path.h"
 #include "IO/Quake3ShaderFileSystem.h"
+#include "IO/TestEnvironment.h"
 
 #include <memory>
 
@@ -82,5 +84,45 @@ namespace TrenchBroom {
                 texturePrefix + Path("test/not_existing2"),
             }));
         }
+
+        TEST_CASE("Quake3ShaderFileSystemTest.testShaderCache", "[Quake3ShaderFileSystemTest]") {
+            NullLogger logger;
+
+            const auto workDir = IO::Disk::getCurrentWorkingDir();
+            const auto testDir = workDir + Path("fixture/test/IO/Shader/fs/linking");
+            const auto fallbackDir = testDir + Path("fallback");
+            const auto texturePrefix = Path("textures");
+            const auto shaderSearchPath = Path("scripts");
+            const auto textureSearchPaths = std::vector<Path> { texturePrefix };
+
+            TestEnvironment env("Quake3ShaderFileSystemTest_testShaderCache");
+            const auto cachePath = env.dir() + Path("cache/test.shaders");
+
+            std::shared_ptr<FileSystem> fs = std::make_shared<DiskFileSystem>(fallbackDir);
+            fs = std::make_shared<DiskFileSystem>(fs, testDir);
+
+            const auto expectedItems = std::vector<Path>{
+                texturePrefix + Path("test/editor_image"),
+                texturePrefix + Path("test/test"),
+                texturePrefix + Path("test/test2"),
+                texturePrefix + Path("test/not_existing"),
+                texturePrefix + Path("test/not_existing2"),
+            };
+
+            // the first file system links the shaders and writes the cache
+            const auto linkedFS = std::make_shared<Quake3ShaderFileSystem>(fs, shaderSearchPath, textureSearchPaths, logger, cachePath);
+            CHECK(Disk::fileExists(cachePath));
+            CHECK_THAT(linkedFS->findItems(texturePrefix + Path("test"), FileExtensionMatcher("")), Catch::UnorderedEquals(expectedItems));
+
+            // the second file system restores the shaders from the cache
+            const auto cachedFS = std::make_shared<Quake3ShaderFileSystem>(fs, shaderSearchPath, textureSearchPaths, logger, cachePath);
+            CHECK_THAT(cachedFS->findItems(texturePrefix + Path("test"), FileExtensionMatcher("")), Catch::UnorderedEquals(expectedItems));
+
+            for (const auto& path : expectedItems) {
+                const auto linkedFile = std::static_pointer_cast<ObjectFile<Assets::Quake3Shader>>(linkedFS->openFile(path));
+                const auto cachedFile = std::static_pointer_cast<ObjectFile<Assets::Quake3Shader>>(cachedFS->openFile(path));
+                CHECK(cachedFile->object() == linkedFile->object());
+            }
+        }
     }
 }
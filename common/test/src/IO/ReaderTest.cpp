@@ -35,7 +35,8 @@ namespace TrenchBroom {
         }
 
         static std::shared_ptr<File> file() {
-            static auto result = Disk::openFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/10byte"));
+            // use a CFile explicitly, Disk::openFile returns a memory mapped file which is read through a buffer source
+            static auto result = std::make_shared<CFile>(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/10byte"));
             return result;
         }
 
@@ -56,10 +57,16 @@ namespace TrenchBroom {
         }
 
         TEST_CASE("FileReaderTest.createEmpty", "[FileReaderTest]") {
-            const auto emptyFile = Disk::openFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/empty"));
+            const auto emptyFile = std::make_shared<CFile>(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/empty"));
             createEmpty(emptyFile->reader());
         }
 
+        TEST_CASE("MappedFileReaderTest.createEmpty", "[MappedFileReaderTest]") {
+            const auto emptyFile = MappedFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/empty"));
+            CHECK(emptyFile.size() == 0U);
+            createEmpty(emptyFile.reader());
+        }
+
         static void createNonEmpty(Reader&& r) {
             CHECK(r.size() == 10U);
             CHECK(r.position() == 0U);
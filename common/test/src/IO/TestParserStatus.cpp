@@ -25,7 +25,9 @@ namespace TrenchBroom {
     namespace IO {
         NullLogger TestParserStatus::_logger;
 
-        TestParserStatus::TestParserStatus() : ParserStatus(_logger, "") {}
+        TestParserStatus::TestParserStatus() :
+        ParserStatus(_logger, ""),
+        m_progress(0.0) {}
 
         size_t TestParserStatus::countStatus(const LogLevel level) const {
             const auto it = m_messages.find(level);
@@ -43,7 +45,13 @@ namespace TrenchBroom {
             return it->second;
         }
 
-        void TestParserStatus::doProgress(const double) {}
+        double TestParserStatus::lastProgress() const {
+            return m_progress;
+        }
+
+        void TestParserStatus::doProgress(const double progress) {
+            m_progress = progress;
+        }
 
         void TestParserStatus::doLog(const LogLevel level, const std::string& str) {
             m_messages[level].push_back(str);
@@ -32,11 +32,13 @@ namespace TrenchBroom {
         private:
             static NullLogger _logger;
             std::map<LogLevel, std::vector<std::string>> m_messages;
+            double m_progress;
         public:
             TestParserStatus();
         public:
             size_t countStatus(LogLevel level) const;
             const std::vector<std::string>& messages(LogLevel level) const;
+            double lastProgress() const;
         private:
             void doProgress(double progress) override;
             void doLog(LogLevel level, const std::string& str) override;
@@ -19,13 +19,20 @@
 
 #include "Logger.h"
 #include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
 #include "Assets/TextureManager.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/FileMatcher.h"
 #include "IO/Path.h"
 #include "IO/TextureLoader.h"
+#include "IO/WadFileSystem.h"
 #include "Model/GameConfig.h"
 
+#include <kdl/overload.h>
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
 #include <string>
 
 #include "Catch2.h"
@@ -144,5 +151,92 @@ namespace TrenchBroom {
                 CHECK(texture->height() == height);
             }
         }
+   
+        TEST_CASE("TextureLoaderTest.testLoadTextureCollections", "[TextureLoaderTest]") {
+            const std::vector<IO::Path> paths({
+                Path("fixture/test/IO/Wad/cr8_czg.wad"),
+                Path("fixture/test/IO/Wad/q1_masked.wad"),
+            });
+
+            const IO::Path root = IO::Disk::getCurrentWorkingDir();
+            const std::vector<IO::Path> fileSearchPaths{ root };
+            const IO::DiskFileSystem fileSystem(root, true);
+
+            const Model::TextureConfig textureConfig(
+                Model::TexturePackageConfig(
+                    Model::PackageFormatConfig("wad", "idmip")),
+                    Model::PackageFormatConfig("D", "idmip"),
+                    IO::Path("fixture/test/palette.lmp"),
+                    "wad",
+                    IO::Path(),
+                    {});
+
+            auto logger = NullLogger();
+            IO::TextureLoader textureLoader(fileSystem, fileSearchPaths, textureConfig, logger);
+            auto results = textureLoader.loadTextureCollections(paths);
+            REQUIRE(results.size() == paths.size());
+
+            for (size_t i = 0; i < paths.size(); ++i) {
+                // the textures are in the order in which the WAD file lists them
+                auto wadFS = WadFileSystem(root + paths[i], logger);
+                const auto expectedNames = kdl::vec_transform(wadFS.findItems(Path(""), FileExtensionMatcher("D")), [](const auto& path) {
+                    return path.deleteExtension().asString();
+                });
+
+                CHECK(results[i].is_success());
+                std::move(results[i]).visit(kdl::overload(
+                    [&](const Assets::TextureCollection& collection) {
+                        CHECK(collection.path() == paths[i]);
+                        const auto names = kdl::vec_transform(collection.textures(), [](const auto& texture) {
+                            return texture.name();
+                        });
+                        CHECK(names == expectedNames);
+                    },
+                    [](const TextureCollectionLoadError&) {}
+                ));
+            }
+        }
+
+        TEST_CASE("TextureLoaderTest.testLoadPixelsOnDemand", "[TextureLoaderTest]") {
+            const std::vector<IO::Path> paths({ Path("fixture/test/IO/Wad/cr8_czg.wad") });
+
+            const IO::Path root = IO::Disk::getCurrentWorkingDir();
+            const std::vector<IO::Path> fileSearchPaths{ root };
+            const IO::DiskFileSystem fileSystem(root, true);
+
+            const Model::TextureConfig textureConfig(
+                Model::TexturePackageConfig(
+                    Model::PackageFormatConfig("wad", "idmip")),
+                    Model::PackageFormatConfig("D", "idmip"),
+                    IO::Path("fixture/test/palette.lmp"),
+                    "wad",
+                    IO::Path(),
+                    {});
+
+            auto logger = NullLogger();
+            auto eagerTextureManager = Assets::TextureManager(0, 0, logger);
+            auto lazyTextureManager = Assets::TextureManager(0, 0, logger);
+
+            IO::TextureLoader eagerTextureLoader(fileSystem, fileSearchPaths, textureConfig, logger);
+            eagerTextureLoader.loadTextures(paths, eagerTextureManager);
+
+            IO::TextureLoader lazyTextureLoader(fileSystem, fileSearchPaths, textureConfig, logger, true);
+            lazyTextureLoader.loadTextures(paths, lazyTextureManager);
+
+            REQUIRE(lazyTextureManager.textures().size() == eagerTextureManager.textures().size());
+            for (const auto* eagerTexture : eagerTextureManager.textures()) {
+                const auto* lazyTexture = lazyTextureManager.texture(eagerTexture->name());
+                REQUIRE(lazyTexture != nullptr);
+
+                CHECK_FALSE(eagerTexture->hasDeferredPixels());
+                CHECK(lazyTexture->hasDeferredPixels());
+                CHECK(lazyTexture->buffersIfUnprepared().empty());
+
+                CHECK(lazyTexture->width() == eagerTexture->width());
+                CHECK(lazyTexture->height() == eagerTexture->height());
+                CHECK(lazyTexture->type() == eagerTexture->type());
+                CHECK(lazyTexture->averageColor() == eagerTexture->averageColor());
+            }
+        }
     }
 }
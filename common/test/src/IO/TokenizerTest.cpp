@@ -242,5 +242,43 @@ namespace TrenchBroom {
             CHECK((token = tokenizer.nextToken()).type() == SimpleToken::CBrace);
             CHECK(tokenizer.nextToken().type() == SimpleToken::Eof);
         }
+
+        TEST_CASE("TokenizerTest.simpleLanguageTokenPositions", "[TokenizerTest]") {
+            const std::string testString("{\r\n"
+                                         "    attribute = -12.5e2;\r"
+                                         "\tvalue=12;\n"
+                                         "}");
+
+            SimpleTokenizer tokenizer(testString);
+            SimpleTokenizer::Token token;
+            CHECK((token = tokenizer.nextToken()).type() == SimpleToken::OBrace);
+            CHECK(token.line() == 1u);
+            CHECK(token.column() == 1u);
+            CHECK((token = tokenizer.nextToken()).type() == SimpleToken::String);
+            CHECK(token.line() == 2u);
+            CHECK(token.column() == 5u);
+            CHECK((token = tokenizer.nextToken()).type() == SimpleToken::Equals);
+            CHECK(token.column() == 15u);
+            CHECK((token = tokenizer.nextToken()).type() == SimpleToken::Decimal);
+            CHECK(token.column() == 17u);
+            CHECK(token.toFloat<double>() == -1250.0);
+            CHECK((token = tokenizer.nextToken()).type() == SimpleToken::Semicolon);
+            CHECK(token.line() == 2u);
+            CHECK(token.column() == 24u);
+            CHECK((token = tokenizer.nextToken()).type() == SimpleToken::String);
+            CHECK(token.line() == 3u);
+            CHECK(token.column() == 2u);
+            CHECK((token = tokenizer.nextToken()).type() == SimpleToken::Equals);
+            CHECK(token.column() == 7u);
+            CHECK((token = tokenizer.nextToken()).type() == SimpleToken::Integer);
+            CHECK(token.column() == 8u);
+            CHECK(token.toInteger<int>() == 12);
+            CHECK((token = tokenizer.nextToken()).type() == SimpleToken::Semicolon);
+            CHECK(token.column() == 10u);
+            CHECK((token = tokenizer.nextToken()).type() == SimpleToken::CBrace);
+            CHECK(token.line() == 4u);
+            CHECK(token.column() == 1u);
+            CHECK(tokenizer.nextToken().type() == SimpleToken::Eof);
+        }
     }
 }
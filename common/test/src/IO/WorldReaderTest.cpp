@@ -17,8 +17,11 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Exceptions.h"
+#include "Logger.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
+#include "IO/MapSnapshot.h"
 #include "IO/TestParserStatus.h"
 #include "IO/WorldReader.h"
 #include "Model/BezierPatch.h"
@@ -26,6 +29,7 @@
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceAttributes.h"
 #include "Model/Entity.h"
+#include "Model/Group.h"
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
@@ -39,7 +43,9 @@
 
 #include <fmt/format.h>
 
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "TestUtils.h"
 #include "Catch2.h"
@@ -1554,6 +1560,226 @@ common/caulk
             }
         }
 
+        TEST_CASE("WorldReaderTest.splitIntoChunks", "[WorldReaderTest]") {
+            const auto data = std::string{R"({
+"classname" "worldspawn"
+"wad" "some\\path\\"
+{
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) {grate 0 0 0 1 1
+}
+{
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) "tex}" 0 0 0 1 1
+}
+}
+// a comment with a brace }
+{
+"classname" "light"
+})"};
+
+            // not larger than the chunk size
+            const auto wholeData = StandardMapParser::splitIntoChunks(data, data.size());
+            REQUIRE(wholeData.size() == 1u);
+            CHECK(wholeData[0].str == data);
+            CHECK(wholeData[0].entityLine == std::nullopt);
+
+            // unbalanced braces
+            CHECK(StandardMapParser::splitIntoChunks("} {\n}", 1u).size() == 1u);
+
+            const auto chunks = StandardMapParser::splitIntoChunks(data, 1u);
+            REQUIRE(chunks.size() == 4u);
+
+            CHECK(chunks[0].line == 1u);
+            CHECK(chunks[0].column == 1u);
+            CHECK(chunks[0].entityLine == std::nullopt);
+            CHECK(chunks[0].str.back() == '}');
+
+            CHECK(chunks[1].line == 6u);
+            CHECK(chunks[1].column == 2u);
+            CHECK(chunks[1].entityLine == 1u);
+            CHECK(chunks[1].str.back() == '}');
+
+            CHECK(chunks[2].line == 9u);
+            CHECK(chunks[2].column == 2u);
+            CHECK(chunks[2].entityLine == 1u);
+            CHECK(chunks[2].str == "\n}");
+
+            CHECK(chunks[3].line == 10u);
+            CHECK(chunks[3].column == 2u);
+            CHECK(chunks[3].entityLine == std::nullopt);
+
+            auto joined = std::string{};
+            for (const auto& chunk : chunks) {
+                joined += chunk.str;
+            }
+            CHECK(joined == data);
+        }
+
+        TEST_CASE("WorldReaderTest.parseInParallelChunks", "[WorldReaderTest]") {
+            const auto data = std::string{R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+{
+( -712 1280 -448 ) ( -904 1280 -448 ) ( -904 992 -448 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -904 992 -416 ) ( -904 1280 -416 ) ( -712 1280 -416 ) rtz/b_rc_v16w 32 32 0 1 1
+( -832 968 -416 ) ( -832 1256 -416 ) ( -832 1256 -448 ) rtz/c_mf_v3c 16 96 0 1 1
+( -920 1088 -448 ) ( -920 1088 -416 ) ( -680 1088 -416 ) rtz/c_mf_v3c 56 96 0 1 1
+( -968 1152 -448 ) ( -920 1152 -448 ) ( -944 1152 -416 ) rtz/c_mf_v3c 56 96 0 1 1
+( -896 1056 -416 ) ( -896 1056 -448 ) ( -896 1344 -448 ) rtz/c_mf_v3c 16 96 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "My Group"
+"_tb_id" "1"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+{
+"classname" "func_door"
+"_tb_group" "1"
+"target" "a"
+"target" "b"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+})"};
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            const auto chunkSize = GENERATE(size_t(1), size_t(500), size_t(1000));
+            CAPTURE(chunkSize);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data, Model::MapFormat::Standard);
+            reader.setParallelChunkSize(chunkSize);
+
+            auto world = reader.read(worldBounds, status);
+
+            CHECK(status.countStatus(LogLevel::Warn) == 1u);
+            CHECK(status.lastProgress() > 0.0);
+
+            REQUIRE(world->childCount() == 1u);
+            auto* defaultLayer = world->children().front();
+            REQUIRE(defaultLayer->childCount() == 3u);
+
+            auto* brush1 = dynamic_cast<Model::BrushNode*>(defaultLayer->children()[0]);
+            REQUIRE(brush1 != nullptr);
+            CHECK(brush1->lineNumber() == 4u);
+
+            auto* brush2 = dynamic_cast<Model::BrushNode*>(defaultLayer->children()[1]);
+            REQUIRE(brush2 != nullptr);
+            CHECK(brush2->lineNumber() == 12u);
+
+            auto* groupNode = dynamic_cast<Model::GroupNode*>(defaultLayer->children()[2]);
+            REQUIRE(groupNode != nullptr);
+            CHECK(groupNode->lineNumber() == 21u);
+            REQUIRE(groupNode->childCount() == 3u);
+
+            CHECK(groupNode->children()[0]->lineNumber() == 26u);
+            CHECK(groupNode->children()[1]->lineNumber() == 34u);
+
+            auto* entityNode = dynamic_cast<Model::EntityNode*>(groupNode->children()[2]);
+            REQUIRE(entityNode != nullptr);
+            CHECK(entityNode->lineNumber() == 43u);
+            REQUIRE(entityNode->childCount() == 1u);
+            CHECK(entityNode->children().front()->lineNumber() == 48u);
+        }
+
+        TEST_CASE("WorldReaderTest.parseInParallelChunksWithDuplicateProperties", "[WorldReaderTest]") {
+            const auto data = std::string{R"(
+{
+"classname" "worldspawn"
+"message" "first"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+"message" "second"
+"wad" "unique"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+"wad" "duplicate"
+})"};
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            // a chunk size of 0 parses the input sequentially, a chunk size of 1 starts a new chunk after every brush
+            const auto chunkSize = GENERATE(size_t(0), size_t(1));
+            CAPTURE(chunkSize);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data, Model::MapFormat::Standard);
+            reader.setParallelChunkSize(chunkSize);
+
+            auto world = reader.read(worldBounds, status);
+            CHECK(*world->entity().property("message") == "first");
+
+            CHECK(status.messages(LogLevel::Warn) == std::vector<std::string>{
+                "Ignoring duplicate entity property 'message' (line 13, column 1)",
+                "Ignoring duplicate entity property 'wad' (line 23, column 1)",
+            });
+        }
+
+        TEST_CASE("WorldReaderTest.parseInParallelChunksWithError", "[WorldReaderTest]") {
+            const auto data = std::string{R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+}
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1
+}
+}
+)"};
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data, Model::MapFormat::Standard);
+            reader.setParallelChunkSize(1u);
+
+            CHECK_THROWS_AS(reader.read(worldBounds, status), ParserException);
+        }
+
         TEST_CASE("WorldReaderTest.parseUnknownFormatEmptyMap", "[WorldReaderTest]") {
             const auto data = R"(
 {
@@ -1568,5 +1794,122 @@ common/caulk
             REQUIRE(world != nullptr);
             CHECK(world->mapFormat() == Model::MapFormat::Standard);
         }
+
+        TEST_CASE("WorldReaderTest.readSnapshot", "[WorldReaderTest]") {
+            const auto data = std::string{R"(
+// entity 0
+{
+"classname" "worldspawn"
+"message" "yay"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) __TB_empty [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) __TB_empty [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) __TB_empty [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) __TB_empty [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) __TB_empty [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+// entity 1
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "My Group"
+"_tb_id" "1"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex [ 0 -1 0 0 ] [ 0 0 -1 0 ] 45 0.5 2
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) tex [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) tex [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) tex [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) tex [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) tex [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+)"};
+
+            const vm::bbox3 worldBounds(8192.0);
+            const auto formats = std::vector<Model::MapFormat>{Model::MapFormat::Standard, Model::MapFormat::Valve};
+            const auto gameConfig = std::string{R"({ "version": 4, "name": "Quake" })"};
+            const auto key = computeMapSnapshotKey(data, gameConfig, formats, worldBounds);
+
+            CHECK(computeMapSnapshotKey(data, gameConfig, formats, worldBounds) == key);
+            CHECK(computeMapSnapshotKey(data, R"({ "version": 4, "name": "Quake", "icon": "Icon.png" })", formats, worldBounds) != key);
+            CHECK(computeMapSnapshotKey(data + " ", gameConfig, formats, worldBounds) != key);
+            CHECK(computeMapSnapshotKey(data, gameConfig, {Model::MapFormat::Standard}, worldBounds) != key);
+            CHECK(computeMapSnapshotKey(data, gameConfig, formats, vm::bbox3(4096.0)) != key);
+
+            IO::TestParserStatus status;
+            auto [parsedWorld, snapshot] = WorldReader::tryReadAndRecordSnapshot(data, formats, key, worldBounds, status);
+            REQUIRE(parsedWorld != nullptr);
+            REQUIRE(!snapshot.empty());
+
+            CHECK(WorldReader::readSnapshot(snapshot, key + 1u, worldBounds, status) == nullptr);
+            CHECK(WorldReader::readSnapshot(snapshot.substr(0u, snapshot.size() / 2u), key, worldBounds, status) == nullptr);
+
+            auto world = WorldReader::readSnapshot(snapshot, key, worldBounds, status);
+            REQUIRE(world != nullptr);
+            CHECK(world->mapFormat() == Model::MapFormat::Valve);
+            REQUIRE(world->entity().property("message") != nullptr);
+            CHECK(*world->entity().property("message") == "yay");
+
+            auto* defaultLayer = world->defaultLayer();
+            REQUIRE(defaultLayer->childCount() == 2u);
+
+            auto* brushNode = dynamic_cast<Model::BrushNode*>(defaultLayer->children()[0]);
+            REQUIRE(brushNode != nullptr);
+            CHECK(brushNode->lineNumber() == 7u);
+            CHECK(brushNode->brush().faceCount() == 6u);
+
+            // the brush geometry was restored from the snapshot
+            auto* parsedBrushNode = dynamic_cast<Model::BrushNode*>(parsedWorld->defaultLayer()->children()[0]);
+            REQUIRE(parsedBrushNode != nullptr);
+            CHECK(brushNode->brush().vertexCount() == 8u);
+            CHECK(brushNode->brush().closed());
+            CHECK(brushNode->brush().bounds() == parsedBrushNode->brush().bounds());
+            CHECK_THAT(brushNode->brush().vertexPositions(), Catch::UnorderedEquals(parsedBrushNode->brush().vertexPositions()));
+
+            auto* groupNode = dynamic_cast<Model::GroupNode*>(defaultLayer->children()[1]);
+            REQUIRE(groupNode != nullptr);
+            CHECK(groupNode->lineNumber() == 17u);
+            CHECK(groupNode->group().name() == "My Group");
+            REQUIRE(groupNode->childCount() == 1u);
+
+            auto* groupedBrushNode = dynamic_cast<Model::BrushNode*>(groupNode->children().front());
+            REQUIRE(groupedBrushNode != nullptr);
+            CHECK(groupedBrushNode->lineNumber() == 23u);
+
+            const auto& face = groupedBrushNode->brush().face(0u);
+            CHECK(face.lineNumber() == 24u);
+            CHECK(face.attributes().textureName() == "tex");
+            CHECK(face.attributes().rotation() == 45.0f);
+            CHECK(face.attributes().scale() == vm::vec2f(0.5f, 2.0f));
+            CHECK(dynamic_cast<const Model::ParallelTexCoordSystem*>(&face.texCoordSystem()) != nullptr);
+            CHECK(face.texCoordSystem().xAxis() == vm::vec3(0, -1, 0));
+        }
+
+        TEST_CASE("WorldReaderTest.readInvalidSnapshot", "[WorldReaderTest]") {
+            const auto key = uint64_t(1u);
+            const auto makeObjectInfos = [](const std::optional<size_t> parentIndex) {
+                return std::vector<MapReader::ObjectInfo>{
+                    MapReader::EntityInfo{{}, 1u, 1u},
+                    MapReader::BrushInfo{{}, 2u, 1u, std::nullopt, std::nullopt},
+                    MapReader::BrushInfo{{}, 3u, 1u, parentIndex, std::nullopt},
+                };
+            };
+
+            CHECK(readMapSnapshot(writeMapSnapshot(key, Model::MapFormat::Standard, makeObjectInfos(std::nullopt)), key).has_value());
+            CHECK(readMapSnapshot(writeMapSnapshot(key, Model::MapFormat::Standard, makeObjectInfos(0u)), key).has_value());
+
+            // the parent must be a preceding entity
+            CHECK_FALSE(readMapSnapshot(writeMapSnapshot(key, Model::MapFormat::Standard, makeObjectInfos(1u)), key).has_value());
+            CHECK_FALSE(readMapSnapshot(writeMapSnapshot(key, Model::MapFormat::Standard, makeObjectInfos(2u)), key).has_value());
+            CHECK_FALSE(readMapSnapshot(writeMapSnapshot(key, Model::MapFormat::Standard, makeObjectInfos(42u)), key).has_value());
+
+            // the format must be known
+            CHECK_FALSE(readMapSnapshot(writeMapSnapshot(key, Model::MapFormat::Unknown, makeObjectInfos(std::nullopt)), key).has_value());
+            CHECK_FALSE(readMapSnapshot(writeMapSnapshot(key, static_cast<Model::MapFormat>(42), makeObjectInfos(std::nullopt)), key).has_value());
+        }
     }
 }
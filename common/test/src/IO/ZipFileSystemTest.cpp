@@ -20,11 +20,19 @@
 #include "Exceptions.h"
 #include "IO/DiskIO.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
+#include "IO/Reader.h"
 #include "IO/ZipFileSystem.h"
 
+#include <kdl/parallel.h>
+#include <kdl/vector_utils.h>
+
 #include <algorithm>
 #include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -139,5 +147,41 @@ namespace TrenchBroom {
 
             CHECK(fs.openFile(Path("amnet.cfg")) != nullptr);
         }
+
+        TEST_CASE("ZipFileSystemTest.openFileCached", "[ZipFileSystemTest]") {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
+
+            ZipFileSystem fs(zipPath);
+            const auto file = fs.openFile(Path("amnet.cfg"));
+            CHECK(fs.openFile(Path("AMNET.CFG")) == file);
+
+            fs.setCacheCapacity(0);
+            const auto uncachedFile = fs.openFile(Path("amnet.cfg"));
+            CHECK(uncachedFile != file);
+            CHECK(fs.openFile(Path("amnet.cfg")) != uncachedFile);
+            CHECK(uncachedFile->reader().readString(uncachedFile->size()) == file->reader().readString(file->size()));
+        }
+
+        TEST_CASE("ZipFileSystemTest.openFilesConcurrently", "[ZipFileSystemTest]") {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
+
+            const ZipFileSystem fs(zipPath);
+            const auto paths = fs.findItemsRecursively(Path(""), FileExtensionMatcher("wal"));
+            const auto expectedContents = kdl::vec_transform(paths, [&](const auto& path) {
+                const auto file = fs.openFile(path);
+                return file->reader().readString(file->size());
+            });
+
+            ZipFileSystem uncachedFS(zipPath);
+            uncachedFS.setCacheCapacity(0);
+
+            auto contents = std::vector<std::string>(paths.size());
+            kdl::parallel_for(paths.size(), [&](const size_t i) {
+                const auto file = uncachedFS.openFile(paths[i]);
+                contents[i] = file->reader().readString(file->size());
+            });
+
+            CHECK(contents == expectedContents);
+        }
     }
 }
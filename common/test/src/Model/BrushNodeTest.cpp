@@ -42,6 +42,8 @@
 #include <vecmath/approx.h>
 #include <vecmath/bbox.h>
 #include <vecmath/bbox_io.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/vec.h>
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
@@ -279,6 +281,35 @@ namespace TrenchBroom {
             PickResult hits2;
             brush.pick(editorContext, vm::ray3(vm::vec3(8.0, -8.0, 8.0), vm::vec3::neg_y()), hits2);
             CHECK(hits2.empty());
+
+            // the ray starts inside the brush
+            PickResult hits3;
+            brush.pick(editorContext, vm::ray3(vm::vec3(8.0, 8.0, 8.0), vm::vec3::pos_y()), hits3);
+            CHECK(hits3.empty());
+
+            // the ray enters the brush through the top face at an angle
+            PickResult hits4;
+            brush.pick(editorContext, vm::ray3(vm::vec3(8.0, -8.0, 32.0), vm::normalize(vm::vec3(0.0, 1.0, -1.0))), hits4);
+            CHECK(hits4.size() == 1u);
+            CHECK(hitToFaceHandle(hits4.all().front())->face().boundary().normal == vm::vec3::pos_z());
+
+            // the ray passes the brush
+            PickResult hits5;
+            brush.pick(editorContext, vm::ray3(vm::vec3(8.0, -8.0, 17.0), vm::vec3::pos_y()), hits5);
+            CHECK(hits5.empty());
+
+            // replacing the brush updates the face planes used for picking
+            auto translatedBrush = brush.brush();
+            REQUIRE(translatedBrush.transform(worldBounds, vm::translation_matrix(vm::vec3(0.0, 0.0, 16.0)), false).is_success());
+            brush.setBrush(std::move(translatedBrush));
+
+            PickResult hits6;
+            brush.pick(editorContext, vm::ray3(vm::vec3(8.0, -8.0, 17.0), vm::vec3::pos_y()), hits6);
+            CHECK(hits6.size() == 1u);
+
+            PickResult hits7;
+            brush.pick(editorContext, vm::ray3(vm::vec3(8.0, -8.0, 8.0), vm::vec3::pos_y()), hits7);
+            CHECK(hits7.empty());
         }
 
         TEST_CASE("BrushNodeTest.clone", "[BrushNodeTest]") {
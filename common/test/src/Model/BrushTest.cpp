@@ -132,6 +132,30 @@ namespace TrenchBroom {
             }).is_error());
         }
 
+        TEST_CASE("BrushTest.copyBrush", "[BrushTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            const BrushBuilder builder(MapFormat::Standard, worldBounds);
+
+            const vm::bbox3 originalBounds(vm::vec3(-64, -64, -64), vm::vec3(64, 64, 64));
+            const Brush original = builder.createCuboid(originalBounds, "texture").value();
+            Brush copy = original;
+
+            // the copy shares the geometry with the original
+            REQUIRE(copy.faceCount() == original.faceCount());
+            for (size_t i = 0u; i < original.faceCount(); ++i) {
+                CHECK(copy.face(i).geometry() == original.face(i).geometry());
+            }
+
+            // modifying the copy does not affect the original
+            REQUIRE(copy.expand(worldBounds, 6, true).is_success());
+            CHECK(copy.bounds() == vm::bbox3(vm::vec3(-70, -70, -70), vm::vec3(70, 70, 70)));
+            CHECK(original.bounds() == originalBounds);
+            for (size_t i = 0u; i < original.faceCount(); ++i) {
+                CHECK(original.face(i).geometry() != copy.face(i).geometry());
+                CHECK(original.face(i).vertexCount() == 4u);
+            }
+        }
+
         TEST_CASE("BrushTest.clip", "[BrushTest]") {
             const vm::bbox3 worldBounds(4096.0);
 
@@ -197,6 +197,34 @@ namespace TrenchBroom {
         constexpr auto L_Locked = LockState::Locked;
         constexpr auto L_Unlocked = LockState::Unlocked;
 
+        TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.revision") {
+            auto revision = context.revision();
+            const auto revisionChanged = [&]() {
+                const auto changed = context.revision() != revision;
+                revision = context.revision();
+                return changed;
+            };
+
+            context.setBlockSelection(true);
+            CHECK(revisionChanged());
+
+            context.setBlockSelection(true);
+            CHECK_FALSE(revisionChanged());
+
+            context.setHiddenTags(1u);
+            CHECK(revisionChanged());
+
+            auto* groupNode = createTopLevelGroup();
+            context.pushGroup(groupNode);
+            CHECK(revisionChanged());
+
+            context.popGroup();
+            CHECK(revisionChanged());
+
+            context.reset();
+            CHECK(revisionChanged());
+        }
+
         TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.testTopLevelNodes") {
 
             SECTION("World") {
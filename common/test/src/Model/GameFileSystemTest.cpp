@@ -0,0 +1,175 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Logger.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/GameConfigParser.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "Model/GameConfig.h"
+#include "Model/GameFileSystem.h"
+
+#include <kdl/vector_utils.h>
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static GameConfig createZipGameConfig() {
+            return GameConfig(
+                "Test",
+                IO::Path(),
+                IO::Path(),
+                false,
+                std::vector<MapFormatConfig>(),
+                FileSystemConfig(
+                    IO::Path("base"),
+                    PackageFormatConfig("zip", "zip")
+                ),
+                TextureConfig(
+                    TexturePackageConfig(IO::Path("textures")),
+                    PackageFormatConfig("wal", "wal"),
+                    IO::Path(),
+                    "_tb_textures",
+                    IO::Path(),
+                    std::vector<std::string>()
+                ),
+                EntityConfig(),
+                FaceAttribsConfig(),
+                std::vector<SmartTag>(),
+                std::nullopt, // soft map bounds
+                {} // compilation tools
+            );
+        }
+
+        static std::string readFile(const IO::FileSystem& fs, const IO::Path& path) {
+            const auto file = fs.openFile(path);
+            const auto reader = file->reader().buffer();
+            return std::string(reader.stringView());
+        }
+
+        TEST_CASE("GameFileSystemTest.searchPathPriority", "[GameFileSystemTest]") {
+            const auto config = createZipGameConfig();
+            const auto gamePath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/test/Model/GameFileSystem");
+            auto logger = NullLogger();
+
+            auto fs = GameFileSystem();
+            fs.initialize(config, gamePath, {IO::Path("mod")}, logger);
+
+            // the directory of a later search path shadows all packages of earlier search paths
+            CHECK(readFile(fs, IO::Path("textures/a.txt")) == "mod/textures");
+            // the packages of a search path shadow its directory
+            CHECK(readFile(fs, IO::Path("textures/b.txt")) == "base/pak0.zip");
+            CHECK(readFile(fs, IO::Path("textures/c.txt")) == "base/textures");
+            CHECK(readFile(fs, IO::Path("textures/d.txt")) == "mod/pak0.zip");
+            // lookups ignore the case
+            CHECK(readFile(fs, IO::Path("TEXTURES/D.TXT")) == "mod/pak0.zip");
+
+            CHECK(fs.directoryExists(IO::Path("textures")));
+            CHECK_FALSE(fs.directoryExists(IO::Path("textures/a.txt")));
+            CHECK_FALSE(fs.fileExists(IO::Path("textures/e.txt")));
+
+            // the default assets may add more files
+            const auto contents = fs.getDirectoryContents(IO::Path("textures"));
+            CHECK(kdl::vec_contains(contents, IO::Path("a.txt")));
+            CHECK(kdl::vec_contains(contents, IO::Path("b.txt")));
+            CHECK(kdl::vec_contains(contents, IO::Path("c.txt")));
+            CHECK(kdl::vec_contains(contents, IO::Path("d.txt")));
+            CHECK(contents == kdl::vec_sort_and_remove_duplicates(contents));
+
+            SECTION("Later packages shadow earlier packages") {
+                fs.initialize(config, gamePath, {}, logger);
+
+                CHECK(readFile(fs, IO::Path("textures/a.txt")) == "base/pak1.zip");
+                CHECK(readFile(fs, IO::Path("textures/b.txt")) == "base/pak0.zip");
+                CHECK_FALSE(fs.fileExists(IO::Path("textures/d.txt")));
+            }
+        }
+
+        TEST_CASE("GameFileSystemTest.remount", "[GameFileSystemTest]") {
+            const auto config = createZipGameConfig();
+            const auto gamePath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/test/Model/GameFileSystem");
+            auto logger = NullLogger();
+
+            auto fs = GameFileSystem();
+            fs.initialize(config, gamePath, {IO::Path("mod")}, logger);
+
+            // removing the mod keeps the other mounts
+            fs.initialize(config, gamePath, {}, logger);
+            CHECK(readFile(fs, IO::Path("textures/a.txt")) == "base/pak1.zip");
+            CHECK(readFile(fs, IO::Path("textures/c.txt")) == "base/textures");
+            CHECK_FALSE(fs.fileExists(IO::Path("textures/d.txt")));
+
+            // adding it again restores the previous state
+            fs.initialize(config, gamePath, {IO::Path("mod")}, logger);
+            CHECK(readFile(fs, IO::Path("textures/a.txt")) == "mod/textures");
+            CHECK(readFile(fs, IO::Path("textures/b.txt")) == "base/pak0.zip");
+            CHECK(readFile(fs, IO::Path("textures/d.txt")) == "mod/pak0.zip");
+        }
+
+        TEST_CASE("GameFileSystemTest.remountModifiedPackage", "[GameFileSystemTest]") {
+            const auto config = createZipGameConfig();
+            const auto packagesPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/test/Model/GameFileSystem/packages");
+            auto logger = NullLogger();
+
+            auto env = IO::TestEnvironment("GameFileSystemTest_remountModifiedPackage");
+            env.createDirectory(IO::Path("base"));
+            IO::Disk::copyFile(packagesPath + IO::Path("first.zip"), env.dir() + IO::Path("base/pak0.zip"), false);
+
+            auto fs = GameFileSystem();
+            fs.initialize(config, env.dir(), {}, logger);
+            CHECK(readFile(fs, IO::Path("textures/a.txt")) == "first");
+            CHECK_FALSE(fs.fileExists(IO::Path("textures/e.txt")));
+
+            // a package that was replaced since it was mounted is read again
+            IO::Disk::copyFile(packagesPath + IO::Path("second.zip"), env.dir() + IO::Path("base/pak0.zip"), true);
+            fs.initialize(config, env.dir(), {}, logger);
+            CHECK(readFile(fs, IO::Path("textures/a.txt")) == "second");
+            CHECK(readFile(fs, IO::Path("textures/e.txt")) == "second");
+        }
+
+        TEST_CASE("GameFileSystemTest.reloadShaders", "[GameFileSystemTest]") {
+            const auto configPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/games/Quake3/GameConfig.cfg");
+            const auto configStr = IO::Disk::readTextFile(configPath);
+            auto configParser = IO::GameConfigParser(configStr, configPath);
+            const auto config = configParser.parse();
+            auto logger = NullLogger();
+
+            auto env = IO::TestEnvironment("GameFileSystemTest_reloadShaders");
+            env.createDirectory(IO::Path("baseq3/scripts"));
+            env.createFile(IO::Path("baseq3/scripts/first.shader"), "textures/test/first\n{\n}\n");
+
+            auto fs = GameFileSystem();
+            fs.initialize(config, env.dir(), {}, logger);
+            CHECK(fs.fileExists(IO::Path("textures/test/first")));
+            CHECK_FALSE(fs.fileExists(IO::Path("textures/test/second")));
+
+            env.createFile(IO::Path("baseq3/scripts/second.shader"), "textures/test/second\n{\n}\n");
+            fs.reloadShaders();
+            CHECK(fs.fileExists(IO::Path("textures/test/first")));
+            CHECK(fs.fileExists(IO::Path("textures/test/second")));
+            CHECK(fs.directoryExists(IO::Path("textures/test")));
+        }
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Model/BrushNode.h"
+#include "Model/CompareHits.h"
+#include "Model/Hit.h"
+#include "Model/HitFilter.h"
+#include "Model/HitType.h"
+#include "Model/PickResult.h"
+
+#include <vecmath/vec.h>
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static std::vector<int> targets(const std::vector<Hit>& hits) {
+            auto result = std::vector<int>{};
+            for (const auto& hit : hits) {
+                result.push_back(hit.target<int>());
+            }
+            return result;
+        }
+
+        TEST_CASE("PickResultTest.addHit", "[PickResultTest]") {
+            static const auto HitType1 = HitType::freeType();
+            static const auto HitType2 = HitType::freeType();
+
+            auto pickResult = PickResult::byDistance();
+            pickResult.addHit(Hit{HitType1, 3.0, vm::vec3::zero(), 1});
+            pickResult.addHit(Hit{HitType1, 1.0, vm::vec3::zero(), 2});
+            pickResult.addHit(Hit{HitType2, 2.0, vm::vec3::zero(), 3});
+            pickResult.addHit(Hit{HitType1, 1.0, vm::vec3::zero(), 4});
+
+            CHECK(pickResult.size() == 4u);
+            CHECK(targets(pickResult.all()) == std::vector<int>{2, 4, 3, 1});
+            CHECK(targets(pickResult.all(HitFilters::type(HitType2))) == std::vector<int>{3});
+            CHECK(pickResult.first(HitFilters::type(HitType1)).target<int>() == 2);
+
+            // hits added after querying are sorted again
+            pickResult.addHit(Hit{HitType2, 0.5, vm::vec3::zero(), 5});
+            CHECK(pickResult.first(HitFilters::type(HitType2)).target<int>() == 5);
+            CHECK(targets(pickResult.all()) == std::vector<int>{5, 2, 4, 3, 1});
+
+            pickResult.clear();
+            CHECK(pickResult.empty());
+            CHECK(pickResult.all().empty());
+        }
+
+        TEST_CASE("PickResultTest.addBrushHitsAtSameDistance", "[PickResultTest]") {
+            static const auto OtherHitType = HitType::freeType();
+
+            const auto brushHit1 = Hit{BrushNode::BrushHitType, 1.0, vm::vec3::zero(), 1};
+            const auto brushHit2 = Hit{BrushNode::BrushHitType, 1.0, vm::vec3::zero(), 2};
+            const auto otherHit = Hit{OtherHitType, 1.0, vm::vec3::zero(), 3};
+
+            // two brush hits are equivalent, otherwise sorting them would be undefined behavior
+            const auto compareByType = CompareHitsByType{};
+            CHECK(compareByType.compare(brushHit1, brushHit2) == 0);
+            CHECK(compareByType.compare(brushHit2, brushHit1) == 0);
+            CHECK(compareByType.compare(brushHit1, brushHit1) == 0);
+            CHECK(compareByType.compare(brushHit1, otherHit) < 0);
+            CHECK(compareByType.compare(otherHit, brushHit1) > 0);
+
+            auto pickResult = PickResult::byDistance();
+            pickResult.addHit(otherHit);
+            pickResult.addHit(brushHit1);
+            pickResult.addHit(brushHit2);
+            pickResult.addHit(Hit{BrushNode::BrushHitType, 0.5, vm::vec3::zero(), 4});
+
+            // brush hits precede other hits at the same distance and otherwise keep their order
+            CHECK(targets(pickResult.all()) == std::vector<int>{4, 1, 2, 3});
+        }
+    }
+}
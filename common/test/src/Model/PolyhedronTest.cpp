@@ -23,12 +23,14 @@
 #include "Model/Polyhedron_DefaultPayload.h"
 #include "Model/Polyhedron_Instantiation.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/plane.h>
 #include <vecmath/scalar.h>
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
 #include <iterator>
+#include <map>
 #include <tuple>
 #include <set>
 
@@ -435,6 +437,36 @@ namespace TrenchBroom {
             CHECK(p.hasFace({ p2, p6, p8, p4 }));
         }
 
+        TEST_CASE("PolyhedronTest.constructCubeFromTopology", "[PolyhedronTest]") {
+            const Polyhedron3d cube(vm::bbox3d(8.0));
+
+            std::vector<vm::vec3d> positions;
+            std::map<const PVertex*, size_t> vertexIndices;
+            for (const PVertex* vertex : cube.vertices()) {
+                vertexIndices.emplace(vertex, positions.size());
+                positions.push_back(vertex->position());
+            }
+
+            std::vector<std::vector<size_t>> faceVertices;
+            std::vector<vm::plane3d> facePlanes;
+            for (const PFace* face : cube.faces()) {
+                auto& indices = faceVertices.emplace_back();
+                for (const PHalfEdge* halfEdge : face->boundary()) {
+                    indices.push_back(vertexIndices.at(halfEdge->origin()));
+                }
+                facePlanes.push_back(face->plane());
+            }
+
+            const Polyhedron3d p(positions, faceVertices, facePlanes);
+
+            CHECK(p.closed());
+            CHECK(p.vertexCount() == 8u);
+            CHECK(p.edgeCount() == 12u);
+            CHECK(p.faceCount() == 6u);
+            CHECK(p.bounds() == cube.bounds());
+            CHECK(p == cube);
+        }
+
         TEST_CASE("PolyhedronTest.copy", "[PolyhedronTest]") {
             const vm::vec3d p1( 0.0, 0.0, 8.0);
             const vm::vec3d p2( 8.0, 0.0, 0.0);
@@ -38,6 +38,7 @@
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
 #include <vecmath/mat_io.h>
+#include <vecmath/plane.h>
 
 #include "TestUtils.h"
 #include "Catch2.h"
@@ -248,6 +249,35 @@ namespace TrenchBroom {
             CHECK(nodeTree.contains(patchNode));
         }
 
+        TEST_CASE("WorldNodeTest.findNodesInFrustum") {
+            constexpr auto worldBounds = vm::bbox3d{8192.0};
+            constexpr auto mapFormat = MapFormat::Quake3;
+
+            auto worldNode = WorldNode{Entity{}, mapFormat};
+            auto* entityNode = new EntityNode{Entity{}};
+            auto* nearBrushNode = new BrushNode{BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "texture").value()};
+            auto* farBrushNode = new BrushNode{BrushBuilder{mapFormat, worldBounds}.createCuboid(vm::bbox3{vm::vec3{256, -32, -32}, vm::vec3{320, 32, 32}}, "texture").value()};
+
+            worldNode.defaultLayer()->addChild(entityNode);
+            worldNode.defaultLayer()->addChild(nearBrushNode);
+            worldNode.defaultLayer()->addChild(farBrushNode);
+
+            const auto frustumPlanes = std::vector<vm::plane3>{
+                vm::plane3{vm::vec3{128, 0, 0}, vm::vec3::pos_x()},
+                vm::plane3{vm::vec3{0, 128, 0}, vm::vec3::pos_y()},
+                vm::plane3{vm::vec3{0, -128, 0}, vm::vec3::neg_y()},
+            };
+
+            CHECK_THAT(worldNode.findNodesInFrustum(frustumPlanes), Catch::UnorderedEquals(std::vector<Node*>{
+                entityNode, nearBrushNode
+            }));
+
+            worldNode.rebuildNodeTree();
+            CHECK_THAT(worldNode.findNodesInFrustum(frustumPlanes), Catch::UnorderedEquals(std::vector<Node*>{
+                entityNode, nearBrushNode
+            }));
+        }
+
         TEST_CASE("WorldNodeTest.disableNodeTreeUpdates") {
             constexpr auto worldBounds = vm::bbox3d{8192.0};
             constexpr auto mapFormat = MapFormat::Quake3;
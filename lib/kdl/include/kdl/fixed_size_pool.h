@@ -0,0 +1,196 @@
+/*
+ Copyright 2022 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace kdl {
+    /**
+     * A process wide pool of memory blocks of a fixed size and alignment, intended to back class specific operator
+     * new and operator delete of small objects that are allocated and deleted in large numbers.
+     *
+     * Blocks are carved consecutively from slabs of about 64 KiB, so objects that are allocated one after another
+     * end up next to each other in memory. Every thread keeps its own list of free blocks, so allocating and freeing
+     * blocks does not require any locking in the common case. Blocks may be freed on a different thread than the one
+     * that allocated them. If a thread accumulates too many free blocks, it returns a batch of them to the pool, where
+     * they can be picked up by threads that run out of free blocks.
+     *
+     * Slabs are never released back to the system, the pool only ever grows to the largest number of blocks that were
+     * in use at the same time.
+     *
+     * @tparam Size the size of the blocks in bytes
+     * @tparam Alignment the alignment of the blocks
+     */
+    template <size_t Size, size_t Alignment>
+    class fixed_size_pool {
+    private:
+        union block {
+            block* next;
+            alignas(Alignment) unsigned char storage[Size];
+        };
+
+        static constexpr size_t BlocksPerSlab = std::max(size_t(16), size_t(65536) / sizeof(block));
+        static constexpr size_t BatchSize = 256;
+
+        struct free_list {
+            block* first = nullptr;
+            size_t count = 0;
+
+            void push(block* b) {
+                b->next = first;
+                first = b;
+                ++count;
+            }
+
+            block* pop() {
+                auto* b = first;
+                first = b->next;
+                --count;
+                return b;
+            }
+
+            /**
+             * Removes the first n blocks from this list and returns them as a separate list.
+             */
+            free_list split(const size_t n) {
+                auto result = free_list{first, n};
+
+                auto* last = first;
+                for (size_t i = 1; i < n; ++i) {
+                    last = last->next;
+                }
+                first = last->next;
+                count -= n;
+                last->next = nullptr;
+
+                return result;
+            }
+
+            /**
+             * Moves the blocks of the given list to the front of this list.
+             */
+            void append(const free_list& other) {
+                auto* last = other.first;
+                for (size_t i = 1; i < other.count; ++i) {
+                    last = last->next;
+                }
+                last->next = first;
+                first = other.first;
+                count += other.count;
+            }
+        };
+
+        struct shared_state {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<block[]>> slabs;
+            std::vector<free_list> batches;
+        };
+
+        struct local_state {
+            free_list free;
+            block* slabBegin = nullptr;
+            block* slabEnd = nullptr;
+
+            ~local_state() {
+                // don't lose the free blocks when the thread exits
+                if (free.count > 0u) {
+                    give_back(free);
+                }
+            }
+        };
+
+        static shared_state& shared() {
+            // never destroyed because blocks may still be freed by threads that exit during static destruction
+            static auto* state = new shared_state{};
+            return *state;
+        }
+
+        static local_state& local() {
+            static thread_local auto state = local_state{};
+            return state;
+        }
+
+        /**
+         * Hands the given blocks over to the other threads. This only helps to reuse memory, so if it fails, the blocks
+         * are kept by the calling thread rather than letting an exception escape from a deallocation.
+         *
+         * @return true if the blocks were handed over and false otherwise
+         */
+        static bool give_back(const free_list& blocks) noexcept {
+            try {
+                auto& s = shared();
+                std::lock_guard<std::mutex> lock{s.mutex};
+                s.batches.push_back(blocks);
+                return true;
+            } catch (...) {
+                return false;
+            }
+        }
+    public:
+        /**
+         * Returns a block of memory of at least `Size` bytes, aligned to `Alignment`.
+         */
+        static void* allocate() {
+            auto& l = local();
+            if (l.free.count > 0u) {
+                return l.free.pop();
+            }
+
+            if (l.slabBegin == l.slabEnd) {
+                auto& s = shared();
+                std::lock_guard<std::mutex> lock{s.mutex};
+                if (!s.batches.empty()) {
+                    l.free = s.batches.back();
+                    s.batches.pop_back();
+                    return l.free.pop();
+                }
+
+                s.slabs.push_back(std::make_unique<block[]>(BlocksPerSlab));
+                l.slabBegin = s.slabs.back().get();
+                l.slabEnd = l.slabBegin + BlocksPerSlab;
+            }
+
+            return l.slabBegin++;
+        }
+
+        /**
+         * Returns the given block to the pool. The block must have been obtained by calling allocate().
+         */
+        static void deallocate(void* ptr) noexcept {
+            if (ptr == nullptr) {
+                return;
+            }
+
+            auto& l = local();
+            l.free.push(static_cast<block*>(ptr));
+
+            if (l.free.count >= 2u * BatchSize) {
+                auto batch = l.free.split(BatchSize);
+                if (!give_back(batch)) {
+                    l.free.append(batch);
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,87 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace kdl {
+    /**
+     * The initial value to pass to the hash functions below.
+     */
+    inline constexpr std::uint64_t hash_offset_basis = 0xcbf29ce484222325ull;
+
+    /**
+     * Combines the given hash with the bytes in the given range, using a variant of the FNV-1a hash function that
+     * processes whole words at once.
+     *
+     * The result depends on the native byte order, so it is only suitable for hashes that are not shared between
+     * different platforms, e.g. the keys of local caches.
+     *
+     * @param hash the hash to combine with the given bytes
+     * @param begin the beginning of the range of bytes
+     * @param end the end of the range of bytes
+     * @return the combined hash
+     */
+    inline std::uint64_t hash_bytes(std::uint64_t hash, const char* begin, const char* end) {
+        constexpr std::uint64_t prime = 0x100000001b3ull;
+
+        // hash whole words first, then the remaining bytes
+        while (end - begin >= 8) {
+            std::uint64_t word;
+            std::memcpy(&word, begin, sizeof(word));
+            hash = (hash ^ word) * prime;
+            hash ^= hash >> 29u;
+            begin += 8;
+        }
+        while (begin < end) {
+            hash = (hash ^ static_cast<unsigned char>(*begin++)) * prime;
+        }
+        return hash;
+    }
+
+    /**
+     * Combines the given hash with the object representation of the given value.
+     *
+     * @tparam T the type of the value, must be trivially copyable
+     * @param hash the hash to combine with the given value
+     * @param value the value
+     * @return the combined hash
+     */
+    template <typename T>
+    std::uint64_t hash_value(const std::uint64_t hash, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto* begin = reinterpret_cast<const char*>(&value);
+        return hash_bytes(hash, begin, begin + sizeof(T));
+    }
+
+    /**
+     * Combines the given hash with the size and the characters of the given string. Hashing the size too ensures
+     * that adjacent strings cannot be confused.
+     *
+     * @param hash the hash to combine with the given string
+     * @param str the string
+     * @return the combined hash
+     */
+    inline std::uint64_t hash_string(const std::uint64_t hash, const std::string_view str) {
+        return hash_bytes(hash_value(hash, static_cast<std::uint64_t>(str.size())), str.data(), str.data() + str.size());
+    }
+}
@@ -0,0 +1,159 @@
+/*
+ Copyright 2022 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace kdl {
+    namespace detail {
+        /**
+         * The process wide pool of interned strings.
+         *
+         * The pool is split into shards by the hash of the strings so that threads interning strings concurrently,
+         * e.g. while parsing a file in parallel, rarely contend for the same lock. Every string is stored exactly once
+         * and is never removed, so its address identifies it for the lifetime of the process.
+         */
+        class string_pool {
+        private:
+            struct shard {
+                std::mutex mutex;
+                // a deque never moves its elements, so the views in the index remain valid
+                std::deque<std::string> strings;
+                std::unordered_map<std::string_view, const std::string*> index;
+            };
+
+            static constexpr size_t ShardCount = 16u;
+            std::array<shard, ShardCount> m_shards;
+        public:
+            static string_pool& instance() {
+                static auto pool = string_pool{};
+                return pool;
+            }
+
+            static const std::string& empty_string() {
+                static const auto empty = std::string{};
+                return empty;
+            }
+
+            const std::string* intern(const std::string_view str) {
+                if (str.empty()) {
+                    return &empty_string();
+                }
+
+                auto& s = m_shards[std::hash<std::string_view>{}(str) % ShardCount];
+                std::lock_guard<std::mutex> lock{s.mutex};
+
+                if (const auto it = s.index.find(str); it != s.index.end()) {
+                    return it->second;
+                }
+
+                const auto& stored = s.strings.emplace_back(str);
+                s.index.emplace(std::string_view{stored}, &stored);
+                return &stored;
+            }
+        };
+    }
+
+    /**
+     * An immutable handle to a string that is stored in a process wide pool. Handles to equal strings refer to the
+     * same pooled string, so copying and comparing handles for equality is as cheap as copying and comparing a
+     * pointer, and a handle only takes up the space of a pointer.
+     *
+     * Interning a string requires a hash lookup, and pooled strings are never released. Only intern strings that
+     * occur many times and that are drawn from a limited set, such as names and keys.
+     */
+    class interned_string {
+    private:
+        const std::string* m_str;
+    public:
+        /**
+         * Creates a handle to the empty string.
+         */
+        interned_string() :
+        m_str{&detail::string_pool::empty_string()} {}
+
+        interned_string(const std::string_view str) :
+        m_str{detail::string_pool::instance().intern(str)} {}
+
+        interned_string(const std::string& str) :
+        interned_string{std::string_view{str}} {}
+
+        interned_string(const char* str) :
+        interned_string{std::string_view{str}} {}
+
+        const std::string& str() const {
+            return *m_str;
+        }
+
+        operator const std::string&() const {
+            return *m_str;
+        }
+
+        operator std::string_view() const {
+            return *m_str;
+        }
+
+        bool empty() const {
+            return m_str->empty();
+        }
+
+        /**
+         * Returns the address of the pooled string, which identifies the string's contents.
+         */
+        const std::string* id() const {
+            return m_str;
+        }
+
+        friend bool operator==(const interned_string& lhs, const interned_string& rhs) {
+            return lhs.m_str == rhs.m_str;
+        }
+
+        friend bool operator!=(const interned_string& lhs, const interned_string& rhs) {
+            return lhs.m_str != rhs.m_str;
+        }
+
+        /**
+         * Orders handles lexicographically by the contents of their strings.
+         */
+        friend bool operator<(const interned_string& lhs, const interned_string& rhs) {
+            return lhs.m_str != rhs.m_str && *lhs.m_str < *rhs.m_str;
+        }
+
+        friend std::ostream& operator<<(std::ostream& str, const interned_string& s) {
+            str << *s.m_str;
+            return str;
+        }
+    };
+}
+
+namespace std {
+    template <>
+    struct hash<kdl::interned_string> {
+        size_t operator()(const kdl::interned_string& s) const noexcept {
+            return std::hash<const std::string*>{}(s.id());
+        }
+    };
+}
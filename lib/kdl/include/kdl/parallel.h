@@ -18,82 +18,166 @@
 #ifndef KDL_PARALLEL_H
 #define KDL_PARALLEL_H
 
+#include "kdl/thread_pool.h"
 #include "kdl/vector_utils.h"
 
-#ifdef _WIN32
-#include <ppl.h>
-#endif
-
-#include <atomic>
-#include <future> // for std::async
+#include <algorithm>
+#include <cstddef>
 #include <optional>
-#include <thread>
 #include <utility> // for std::declval
 #include <vector>
 
 namespace kdl {
+    namespace detail {
+        /**
+         * Returns the number of indices that are processed by a single task if `count` indices are to be processed
+         * by the given pool and the caller did not specify a grain size.
+         *
+         * We create a few more chunks than there are threads so that the work can be balanced if some chunks take
+         * longer than others.
+         */
+        inline size_t default_grain_size(const size_t count, const thread_pool& pool) {
+            const auto chunkCount = pool.concurrency() * 4u;
+            return std::max((count + chunkCount - 1u) / chunkCount, size_t(1));
+        }
+    }
+
+    /**
+     * Runs the given lambda once for every chunk of at most `grainSize` consecutive indices in the range
+     * `[0, count)`, passing it the first index of the chunk and the index one past its last index.
+     *
+     * The chunks are processed in parallel using the given thread pool. The calling thread participates in processing
+     * the chunks, so this function may be called from within a task that runs on the pool.
+     *
+     * If the lambda throws an exception, the first such exception is rethrown after all chunks have been processed.
+     *
+     * @tparam L type of lambda, must be of type `void(size_t, size_t)`
+     * @param count the maximum value (exclusive) of the range
+     * @param lambda the lambda to run
+     * @param grainSize the maximum number of indices per chunk, or 0 to choose an appropriate value automatically
+     * @param pool the thread pool to use
+     */
+    template<class L>
+    void parallel_for_chunks(const size_t count, L&& lambda, size_t grainSize = 0u, thread_pool& pool = global_thread_pool()) {
+        if (count == 0u) {
+            return;
+        }
+
+        if (grainSize == 0u) {
+            grainSize = detail::default_grain_size(count, pool);
+        }
+
+        if (count <= grainSize) {
+            lambda(size_t(0), count);
+            return;
+        }
+
+        auto group = task_group{pool};
+        for (size_t begin = grainSize; begin < count; begin += grainSize) {
+            const auto end = std::min(begin + grainSize, count);
+            group.run([&lambda, begin, end]() { lambda(begin, end); });
+        }
+
+        // process the first chunk on the calling thread
+        try {
+            lambda(size_t(0), grainSize);
+        } catch (...) {
+            // the remaining tasks refer to the lambda, so we must wait for them before leaving this function
+            group.wait();
+            throw;
+        }
+        group.wait();
+    }
+
     /**
      * Runs the given lambda `count` times, passing it indices `0` through `count - 1`.
      *
-     * Lambda is executed in parallel, using the number of threads returned by std::thread::hardware_concurrency().
+     * The lambda is executed in parallel using the given thread pool, which defaults to the process wide pool. The
+     * indices are split into chunks of at most `grainSize` indices, and each chunk is processed by one task. Because
+     * the pool threads are reused, the overhead of this function is small, and it can also be used on small data sets
+     * and in interactive code paths.
      *
-     * Because the threads are spawned with std::async(std::launch::async, ...) and no thread pool is used,
-     * there is a relatively large overhead and this should only be used on large/slow to process data sets.
+     * Calls to this function can be nested.
      *
      * @tparam L type of lambda
      * @param count the maximum value (exclusive) to pass to lambda
      * @param lambda the lambda to run
+     * @param grainSize the maximum number of indices per task, or 0 to choose an appropriate value automatically
+     * @param pool the thread pool to use
      */
     template<class L>
-    void parallel_for(const size_t count, L&& lambda) {
-#ifdef _WIN32
-        concurrency::parallel_for<size_t>(0, count, lambda);
-#else
-        size_t numThreads = static_cast<size_t>(std::thread::hardware_concurrency());
-        if (numThreads == 0) {
-            numThreads = 1;
+    void parallel_for(const size_t count, L&& lambda, const size_t grainSize = 0u, thread_pool& pool = global_thread_pool()) {
+        parallel_for_chunks(count, [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                lambda(i);
+            }
+        }, grainSize, pool);
+    }
+
+    /**
+     * Computes `reduce(... reduce(reduce(init, map(0)), map(1)) ..., map(count - 1))` in parallel.
+     *
+     * The indices are split into chunks, and every chunk is reduced into a partial result on the pool. The partial
+     * results are then combined in the order of their chunks, so the result is deterministic for a given grain size
+     * even if `reduce` is not commutative. `reduce` must be associative and `init` must be its identity element.
+     *
+     * @tparam T the type of the result
+     * @tparam M the type of the map function, must be of type `T(size_t)`
+     * @tparam R the type of the reduce function, must be of type `T(T, T)`
+     * @param count the number of indices to map
+     * @param init the identity element of `reduce`
+     * @param map the map function
+     * @param reduce the reduce function
+     * @param grainSize the maximum number of indices per task, or 0 to choose an appropriate value automatically
+     * @param pool the thread pool to use
+     * @return the reduced value
+     */
+    template<class T, class M, class R>
+    T parallel_reduce(const size_t count, T init, M&& map, R&& reduce, size_t grainSize = 0u, thread_pool& pool = global_thread_pool()) {
+        if (count == 0u) {
+            return init;
         }
 
-        std::atomic<size_t> nextIndex(0);
-
-        std::vector<std::future<void>> threads;
-        threads.resize(numThreads);
-
-        for (size_t i = 0; i < numThreads; ++i) {
-            threads[i] = std::async(std::launch::async, [&]() {
-                while (true) {
-                    const size_t ourIndex = std::atomic_fetch_add(&nextIndex, static_cast<size_t>(1));
-                    if (ourIndex >= count) {
-                        break;
-                    }
-                    lambda(ourIndex);
-                }
-            });
+        if (grainSize == 0u) {
+            grainSize = detail::default_grain_size(count, pool);
         }
 
-        for (size_t i = 0; i < numThreads; ++i) {
-            threads[i].wait();
+        const auto chunkCount = (count + grainSize - 1u) / grainSize;
+        auto partialResults = std::vector<std::optional<T>>(chunkCount);
+
+        parallel_for(chunkCount, [&](const size_t chunkIndex) {
+            const auto begin = chunkIndex * grainSize;
+            const auto end = std::min(begin + grainSize, count);
+
+            auto partialResult = init;
+            for (size_t i = begin; i < end; ++i) {
+                partialResult = reduce(std::move(partialResult), map(i));
+            }
+            partialResults[chunkIndex] = std::move(partialResult);
+        }, 1u, pool);
+
+        auto result = std::move(init);
+        for (auto& partialResult : partialResults) {
+            result = reduce(std::move(result), std::move(*partialResult));
         }
-#endif
+        return result;
     }
 
     /**
      * Applies the given lambda to each element of the input (passing elements as rvalue references),
      * and returns a vector of the resulting values, in their original order.
      * 
-     * The lambda is executed in parallel, using the number of threads returned by std::thread::hardware_concurrency().
-     * 
-     * Because the threads are spawned with std::async(std::launch::async, ...) and no thread pool is used,
-     * there is a relatively large overhead and this should only be used on large/slow to process data sets.
+     * The lambda is executed in parallel using the process wide thread pool, see parallel_for.
      *
      * @tparam T the type of the vector elements
      * @tparam L the type of the lambda to apply
      * @param input the vector
      * @param transform the lambda to apply, must be of type `auto(T&&)`
+     * @param grainSize the maximum number of elements per task, or 0 to choose an appropriate value automatically
      * @return a vector containing the transformed values
      */
     template<class T, class L>
-    auto vec_parallel_transform(std::vector<T> input, L&& transform) {
+    auto vec_parallel_transform(std::vector<T> input, L&& transform, const size_t grainSize = 0u) {
         using ResultType = std::optional<decltype(transform(std::declval<T&&>()))>;
 
         std::vector<ResultType> result;
@@ -101,7 +185,7 @@ namespace kdl {
 
         parallel_for(input.size(), [&](const size_t index) {
             result[index] = transform(std::move(input[index]));
-        });
+        }, grainSize);
 
         return vec_transform(std::move(result), [](ResultType&& x) { return std::move(*x); });
     }
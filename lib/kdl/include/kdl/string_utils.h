@@ -22,6 +22,8 @@
 #include <algorithm> // for std::search
 #include <iterator>
 #include <cassert>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -389,5 +391,141 @@ namespace kdl {
             return std::nullopt;
         }
     }
-}
 
+    namespace detail {
+        /**
+         * Reads decimal digits from the given range and accumulates them into the given mantissa. Leading zeros are
+         * skipped. Returns false if the mantissa would overflow.
+         */
+        inline bool str_parse_digits(const char*& cur, const char* end, std::uint64_t& mantissa, int& significantDigits, int& digitCount) {
+            while (cur < end && *cur >= '0' && *cur <= '9') {
+                const auto digit = static_cast<std::uint64_t>(*cur - '0');
+                if (mantissa != 0u || digit != 0u) {
+                    if (++significantDigits > 19) {
+                        return false;
+                    }
+                }
+                mantissa = mantissa * 10u + digit;
+                ++digitCount;
+                ++cur;
+            }
+            return true;
+        }
+    }
+
+    /**
+     * Interprets the given string as a signed long integer and returns it. If the given string cannot be parsed,
+     * returns an empty optional.
+     *
+     * Strings consisting of an optional sign followed by at most 18 digits are parsed directly without allocating
+     * memory. All other strings are passed to str_to_long, so the result is always the same as that of str_to_long.
+     *
+     * @param str the string
+     * @return the signed long integer value or an empty optional if the given string cannot be interpreted as a signed
+     * long integer
+     */
+    inline std::optional<long> str_parse_long(const std::string_view str) {
+        const auto* cur = str.data();
+        const auto* end = str.data() + str.size();
+
+        auto negative = false;
+        if (cur < end && (*cur == '+' || *cur == '-')) {
+            negative = *cur == '-';
+            ++cur;
+        }
+
+        const auto* digitsBegin = cur;
+        auto value = std::uint64_t(0);
+        while (cur < end && *cur >= '0' && *cur <= '9') {
+            value = value * 10u + static_cast<std::uint64_t>(*cur - '0');
+            ++cur;
+        }
+
+        const auto digitCount = cur - digitsBegin;
+        if (cur != end || digitCount == 0 || digitCount > 18 || value > static_cast<std::uint64_t>(std::numeric_limits<long>::max())) {
+            return str_to_long(std::string{str});
+        }
+
+        const auto result = static_cast<long>(value);
+        return negative ? -result : result;
+    }
+
+    /**
+     * Interprets the given string as a 64 bit floating point value and returns it. If the given string cannot be
+     * parsed, returns an empty optional.
+     *
+     * Plain decimal numbers with an optional exponent, such as the ones found in map files, are converted without
+     * allocating memory and independently of the current locale, provided that their value can be computed exactly,
+     * i.e., the digits fit into 53 bits and the decimal exponent is between -22 and 22. All other strings are passed
+     * to str_to_double. In either case, the result is the correctly rounded value of the given string.
+     *
+     * @param str the string
+     * @return the 64 bit floating point value value or an empty optional if the given string cannot be interpreted as an
+     * 64 bit floating point value
+     */
+    inline std::optional<double> str_parse_double(const std::string_view str) {
+        static constexpr double powersOfTen[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        static constexpr auto maxExactMantissa = std::uint64_t(1) << 53;
+
+        const auto* cur = str.data();
+        const auto* end = str.data() + str.size();
+
+        auto negative = false;
+        if (cur < end && (*cur == '+' || *cur == '-')) {
+            negative = *cur == '-';
+            ++cur;
+        }
+
+        auto mantissa = std::uint64_t(0);
+        auto significantDigits = 0;
+        auto integerDigits = 0;
+        auto fractionDigits = 0;
+        if (!detail::str_parse_digits(cur, end, mantissa, significantDigits, integerDigits)) {
+            return str_to_double(std::string{str});
+        }
+        if (cur < end && *cur == '.') {
+            ++cur;
+            if (!detail::str_parse_digits(cur, end, mantissa, significantDigits, fractionDigits)) {
+                return str_to_double(std::string{str});
+            }
+        }
+        if (integerDigits == 0 && fractionDigits == 0) {
+            return str_to_double(std::string{str});
+        }
+
+        auto exponent = -fractionDigits;
+        if (cur < end && (*cur == 'e' || *cur == 'E')) {
+            ++cur;
+            auto negativeExponent = false;
+            if (cur < end && (*cur == '+' || *cur == '-')) {
+                negativeExponent = *cur == '-';
+                ++cur;
+            }
+
+            const auto* exponentBegin = cur;
+            auto explicitExponent = 0;
+            while (cur < end && *cur >= '0' && *cur <= '9' && explicitExponent < 1000) {
+                explicitExponent = explicitExponent * 10 + (*cur - '0');
+                ++cur;
+            }
+            if (cur == exponentBegin) {
+                return str_to_double(std::string{str});
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        if (cur != end || mantissa > maxExactMantissa || exponent < -22 || exponent > 22) {
+            return str_to_double(std::string{str});
+        }
+
+        // both the mantissa and the power of ten are exact, so a single multiplication or division is correctly rounded
+        auto value = static_cast<double>(mantissa);
+        value = exponent < 0
+            ? value / powersOfTen[-exponent]
+            : value * powersOfTen[exponent];
+        return negative ? -value : value;
+    }
+}
@@ -0,0 +1,350 @@
+/*
+ Copyright 2022 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace kdl {
+    /**
+     * A work stealing thread pool.
+     *
+     * Every worker thread owns a task queue. Tasks submitted from a worker thread are pushed onto that worker's
+     * queue, tasks submitted from any other thread are distributed over the queues in a round robin fashion. A worker
+     * takes tasks from the back of its own queue and, if that is empty, steals tasks from the front of the other
+     * queues.
+     *
+     * Threads that wait for a task group to complete (see task_group::wait) help executing the pending tasks of that
+     * group instead of blocking. This makes it safe to use the pool recursively, i.e., to submit and wait for tasks from
+     * within a task.
+     *
+     * The worker threads are started when the pool is created and joined when it is destroyed. Most clients should
+     * use the process wide pool returned by global_thread_pool() instead of creating their own pool.
+     */
+    class thread_pool {
+    public:
+        using task = std::function<void()>;
+    private:
+        struct task_queue {
+            std::mutex mutex;
+            std::deque<task> tasks;
+        };
+
+        struct worker_info {
+            const thread_pool* pool = nullptr;
+            size_t index = 0;
+        };
+
+        std::vector<std::unique_ptr<task_queue>> m_queues;
+        std::vector<std::thread> m_threads;
+
+        std::atomic<size_t> m_pendingTasks;
+        std::atomic<size_t> m_nextQueue;
+
+        std::mutex m_sleepMutex;
+        std::condition_variable m_sleepCondition;
+        bool m_stop;
+    public:
+        /**
+         * Creates a new thread pool with the given number of worker threads. At least one worker thread is created.
+         *
+         * @param threadCount the number of worker threads
+         */
+        explicit thread_pool(const size_t threadCount) :
+        m_pendingTasks{0u},
+        m_nextQueue{0u},
+        m_stop{false} {
+            const auto actualThreadCount = std::max(threadCount, size_t(1));
+            m_queues.reserve(actualThreadCount);
+            for (size_t i = 0; i < actualThreadCount; ++i) {
+                m_queues.push_back(std::make_unique<task_queue>());
+            }
+
+            m_threads.reserve(actualThreadCount);
+            for (size_t i = 0; i < actualThreadCount; ++i) {
+                m_threads.emplace_back([this, i]() { run_worker(i); });
+            }
+        }
+
+        /**
+         * Stops and joins all worker threads. Tasks that are still pending are executed before the workers stop.
+         */
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock{m_sleepMutex};
+                m_stop = true;
+            }
+            m_sleepCondition.notify_all();
+
+            for (auto& thread : m_threads) {
+                thread.join();
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        /**
+         * Returns the number of worker threads of this pool.
+         */
+        size_t thread_count() const {
+            return m_threads.size();
+        }
+
+        /**
+         * Returns the number of threads that can work on tasks concurrently, i.e., the number of worker threads plus
+         * one for the thread that waits for the tasks to complete.
+         */
+        size_t concurrency() const {
+            return thread_count() + 1u;
+        }
+
+        /**
+         * Indicates whether the calling thread is a worker thread of this pool.
+         */
+        bool is_worker_thread() const {
+            return current_worker().pool == this;
+        }
+
+        /**
+         * Submits the given task for execution. The task must not throw; use a task_group if exceptions must be
+         * propagated to the caller.
+         *
+         * @param t the task to execute
+         */
+        void submit(task t) {
+            const auto& worker = current_worker();
+            const auto queueIndex = worker.pool == this
+                ? worker.index
+                : m_nextQueue.fetch_add(1u, std::memory_order_relaxed) % m_queues.size();
+
+            {
+                // increment under the lock to avoid lost wakeups in run_worker, and before the task is pushed so that
+                // the counter never drops below the number of queued tasks
+                std::lock_guard<std::mutex> lock{m_sleepMutex};
+                m_pendingTasks.fetch_add(1u, std::memory_order_release);
+            }
+
+            {
+                auto& queue = *m_queues[queueIndex];
+                std::lock_guard<std::mutex> lock{queue.mutex};
+                queue.tasks.push_back(std::move(t));
+            }
+            m_sleepCondition.notify_one();
+        }
+
+    private:
+        static worker_info& current_worker() {
+            static thread_local auto info = worker_info{};
+            return info;
+        }
+
+        task take_task(const size_t firstQueue) {
+            if (m_pendingTasks.load(std::memory_order_acquire) == 0u) {
+                return task{};
+            }
+
+            // take the most recently submitted task from our own queue
+            {
+                auto& queue = *m_queues[firstQueue];
+                std::lock_guard<std::mutex> lock{queue.mutex};
+                if (!queue.tasks.empty()) {
+                    auto result = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                    m_pendingTasks.fetch_sub(1u, std::memory_order_acq_rel);
+                    return result;
+                }
+            }
+
+            // steal the oldest task from another queue
+            for (size_t i = 1; i < m_queues.size(); ++i) {
+                auto& queue = *m_queues[(firstQueue + i) % m_queues.size()];
+                std::lock_guard<std::mutex> lock{queue.mutex};
+                if (!queue.tasks.empty()) {
+                    auto result = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                    m_pendingTasks.fetch_sub(1u, std::memory_order_acq_rel);
+                    return result;
+                }
+            }
+
+            return task{};
+        }
+
+        void run_worker(const size_t index) {
+            current_worker() = worker_info{this, index};
+
+            while (true) {
+                if (auto t = take_task(index)) {
+                    t();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock{m_sleepMutex};
+                m_sleepCondition.wait(lock, [&]() {
+                    return m_stop || m_pendingTasks.load(std::memory_order_acquire) > 0u;
+                });
+                if (m_stop && m_pendingTasks.load(std::memory_order_acquire) == 0u) {
+                    return;
+                }
+            }
+        }
+    };
+
+    /**
+     * Returns the process wide thread pool. The pool is created on first use and uses one worker thread less than
+     * the hardware concurrency since the thread waiting for a task group also executes tasks.
+     */
+    inline thread_pool& global_thread_pool() {
+        static auto pool = thread_pool{std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(2)) - 1u};
+        return pool;
+    }
+
+    /**
+     * A group of tasks that are executed by a thread pool and that can be waited for collectively.
+     *
+     * If a task throws an exception, the first such exception is captured and rethrown by wait(). Other tasks of the
+     * group are still executed.
+     *
+     * The tasks of a group are kept in a queue that belongs to the group, and the pool only receives a request to run
+     * the next task of the group. Waiting for a task group executes the pending tasks of this group on the waiting
+     * thread, but never tasks of other groups, which might take arbitrarily long. Task groups can be nested, i.e., a
+     * task may create another task group and wait for it.
+     */
+    class task_group {
+    private:
+        struct group_state {
+            std::mutex mutex;
+            std::condition_variable done_condition;
+            std::deque<thread_pool::task> tasks;
+            size_t unfinished_tasks = 0;
+            std::exception_ptr exception;
+        };
+
+        thread_pool& m_pool;
+        // shared with the requests submitted to the pool, which may outlive this group
+        std::shared_ptr<group_state> m_state;
+    public:
+        /**
+         * Creates a new task group that submits its tasks to the given pool.
+         *
+         * @param pool the pool to use
+         */
+        explicit task_group(thread_pool& pool = global_thread_pool()) :
+        m_pool{pool},
+        m_state{std::make_shared<group_state>()} {}
+
+        /**
+         * Waits for all pending tasks. Exceptions thrown by the tasks are swallowed, call wait() before the group is
+         * destroyed to receive them.
+         */
+        ~task_group() {
+            wait_for_tasks();
+        }
+
+        task_group(const task_group&) = delete;
+        task_group& operator=(const task_group&) = delete;
+
+        /**
+         * Submits the given function for execution. The function must be copy constructible.
+         *
+         * @tparam F the type of the function
+         * @param f the function to execute
+         */
+        template <typename F>
+        void run(F&& f) {
+            {
+                std::lock_guard<std::mutex> lock{m_state->mutex};
+                m_state->tasks.emplace_back(std::forward<F>(f));
+                ++m_state->unfinished_tasks;
+            }
+            m_pool.submit([state = m_state]() { run_one(*state); });
+        }
+
+        /**
+         * Waits until all tasks of this group have been executed. While waiting, the calling thread executes pending
+         * tasks of this group.
+         *
+         * If any of the tasks threw an exception, the first such exception is rethrown.
+         */
+        void wait() {
+            wait_for_tasks();
+
+            auto exception = std::exception_ptr{};
+            {
+                std::lock_guard<std::mutex> lock{m_state->mutex};
+                std::swap(exception, m_state->exception);
+            }
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+    private:
+        /**
+         * Takes the oldest pending task of the given group and executes it on the calling thread.
+         *
+         * @return true if a task was executed and false if the group had no pending tasks
+         */
+        static bool run_one(group_state& state) {
+            auto t = thread_pool::task{};
+            {
+                std::lock_guard<std::mutex> lock{state.mutex};
+                if (state.tasks.empty()) {
+                    // the task was already taken by a waiting thread
+                    return false;
+                }
+                t = std::move(state.tasks.front());
+                state.tasks.pop_front();
+            }
+
+            auto exception = std::exception_ptr{};
+            try {
+                t();
+            } catch (...) {
+                exception = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock{state.mutex};
+            if (exception && !state.exception) {
+                state.exception = exception;
+            }
+            if (--state.unfinished_tasks == 0u) {
+                state.done_condition.notify_all();
+            }
+            return true;
+        }
+
+        void wait_for_tasks() {
+            while (run_one(*m_state)) {}
+
+            // the remaining tasks are being executed by other threads
+            std::unique_lock<std::mutex> lock{m_state->mutex};
+            m_state->done_condition.wait(lock, [&]() { return m_state->unfinished_tasks == 0u; });
+        }
+    };
+}
@@ -0,0 +1,96 @@
+/*
+ Copyright 2022 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "kdl/fixed_size_pool.h"
+#include "kdl/parallel.h"
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl {
+    using test_pool = fixed_size_pool<24u, 8u>;
+
+    TEST_CASE("fixed_size_pool.allocate", "[fixed_size_pool_test]") {
+        auto blocks = std::vector<void*>{};
+        for (size_t i = 0; i < 10'000; ++i) {
+            auto* block = test_pool::allocate();
+            CHECK(reinterpret_cast<std::uintptr_t>(block) % 8u == 0u);
+            blocks.push_back(block);
+        }
+
+        // all blocks are distinct and don't overlap
+        const auto blockSet = std::set<void*>(blocks.begin(), blocks.end());
+        CHECK(blockSet.size() == blocks.size());
+        for (auto it = std::next(blockSet.begin()); it != blockSet.end(); ++it) {
+            CHECK(static_cast<char*>(*it) - static_cast<char*>(*std::prev(it)) >= 24);
+        }
+
+        for (auto* block : blocks) {
+            test_pool::deallocate(block);
+        }
+    }
+
+    TEST_CASE("fixed_size_pool.reuse", "[fixed_size_pool_test]") {
+        auto* block = test_pool::allocate();
+        test_pool::deallocate(block);
+        CHECK(test_pool::allocate() == block);
+        test_pool::deallocate(block);
+
+        test_pool::deallocate(nullptr);
+    }
+
+    TEST_CASE("fixed_size_pool.consecutive", "[fixed_size_pool_test]") {
+        // blocks taken from a fresh slab are adjacent
+        using pool = fixed_size_pool<40u, 8u>;
+        auto* first = static_cast<char*>(pool::allocate());
+        auto* second = static_cast<char*>(pool::allocate());
+        CHECK(second - first == 40);
+
+        pool::deallocate(second);
+        pool::deallocate(first);
+    }
+
+    TEST_CASE("fixed_size_pool.concurrent", "[fixed_size_pool_test]") {
+        // allocate on many threads and free on this thread
+        auto blocks = std::vector<void*>(10'000);
+        parallel_for(blocks.size(), [&](const size_t i) {
+            blocks[i] = test_pool::allocate();
+            *static_cast<size_t*>(blocks[i]) = i;
+        });
+
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            CHECK(*static_cast<size_t*>(blocks[i]) == i);
+        }
+        CHECK(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+
+        for (auto* block : blocks) {
+            test_pool::deallocate(block);
+        }
+
+        // the freed blocks are available to other threads again
+        parallel_for(blocks.size(), [&](const size_t i) {
+            blocks[i] = test_pool::allocate();
+        });
+        for (auto* block : blocks) {
+            test_pool::deallocate(block);
+        }
+    }
+}
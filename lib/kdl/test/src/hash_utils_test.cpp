@@ -0,0 +1,53 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "kdl/hash_utils.h"
+
+#include <cstdint>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+namespace kdl {
+    TEST_CASE("hash_utils_test.hash_bytes", "[hash_utils_test]") {
+        const auto str = std::string{"some string that is longer than a word"};
+
+        CHECK(hash_bytes(hash_offset_basis, str.data(), str.data()) == hash_offset_basis);
+        CHECK(hash_bytes(hash_offset_basis, str.data(), str.data() + str.size()) == hash_bytes(hash_offset_basis, str.data(), str.data() + str.size()));
+        CHECK(hash_bytes(hash_offset_basis, str.data(), str.data() + str.size()) != hash_bytes(hash_offset_basis, str.data(), str.data() + str.size() - 1u));
+        CHECK(hash_bytes(hash_offset_basis, str.data(), str.data() + 3u) != hash_bytes(hash_offset_basis, str.data() + 1u, str.data() + 4u));
+        CHECK(hash_bytes(1u, str.data(), str.data() + str.size()) != hash_bytes(2u, str.data(), str.data() + str.size()));
+    }
+
+    TEST_CASE("hash_utils_test.hash_value", "[hash_utils_test]") {
+        const auto value = std::uint64_t{12345u};
+        const auto* begin = reinterpret_cast<const char*>(&value);
+
+        CHECK(hash_value(hash_offset_basis, value) == hash_bytes(hash_offset_basis, begin, begin + sizeof(value)));
+        CHECK(hash_value(hash_offset_basis, value) != hash_value(hash_offset_basis, value + 1u));
+    }
+
+    TEST_CASE("hash_utils_test.hash_string", "[hash_utils_test]") {
+        CHECK(hash_string(hash_offset_basis, "abc") == hash_string(hash_offset_basis, "abc"));
+        CHECK(hash_string(hash_offset_basis, "abc") != hash_string(hash_offset_basis, "abd"));
+
+        // the sizes are hashed, too
+        CHECK(hash_string(hash_string(hash_offset_basis, "ab"), "c") != hash_string(hash_string(hash_offset_basis, "a"), "bc"));
+        CHECK(hash_string(hash_offset_basis, "") != hash_offset_basis);
+    }
+}
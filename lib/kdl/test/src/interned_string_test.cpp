@@ -0,0 +1,83 @@
+/*
+ Copyright 2022 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "kdl/interned_string.h"
+#include "kdl/parallel.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl {
+    TEST_CASE("interned_string.constructor", "[interned_string_test]") {
+        CHECK(interned_string{}.str() == "");
+        CHECK(interned_string{}.empty());
+        CHECK(interned_string{""} == interned_string{});
+        CHECK(interned_string{"asdf"}.str() == "asdf");
+        CHECK(interned_string{std::string{"asdf"}}.str() == "asdf");
+        CHECK(interned_string{std::string_view{"asdfgh"}.substr(0, 4)}.str() == "asdf");
+    }
+
+    TEST_CASE("interned_string.identity", "[interned_string_test]") {
+        const auto longString = std::string(100, 'x');
+
+        CHECK(interned_string{"asdf"}.id() == interned_string{std::string{"asdf"}}.id());
+        CHECK(interned_string{longString}.id() == interned_string{std::string(100, 'x')}.id());
+        CHECK(interned_string{"asdf"}.id() != interned_string{"fdsa"}.id());
+
+        // the pooled strings remain valid while the pool grows
+        const auto first = interned_string{"interned_string.identity"};
+        for (size_t i = 0; i < 1'000; ++i) {
+            interned_string{"interned_string.identity" + std::to_string(i)};
+        }
+        CHECK(first.str() == "interned_string.identity");
+        CHECK(first == interned_string{"interned_string.identity"});
+    }
+
+    TEST_CASE("interned_string.compare", "[interned_string_test]") {
+        CHECK(interned_string{"asdf"} == interned_string{"asdf"});
+        CHECK(interned_string{"asdf"} != interned_string{"asdF"});
+        CHECK(interned_string{"a"} < interned_string{"b"});
+        CHECK_FALSE(interned_string{"b"} < interned_string{"a"});
+        CHECK_FALSE(interned_string{"a"} < interned_string{"a"});
+        CHECK(interned_string{} < interned_string{"a"});
+    }
+
+    TEST_CASE("interned_string.hash", "[interned_string_test]") {
+        auto set = std::unordered_set<interned_string>{};
+        set.insert("asdf");
+        set.insert(std::string{"asdf"});
+        set.insert("fdsa");
+        CHECK(set.size() == 2u);
+        CHECK(set.count("asdf") == 1u);
+    }
+
+    TEST_CASE("interned_string.concurrent", "[interned_string_test]") {
+        auto ids = std::vector<const std::string*>(1'000);
+        parallel_for(ids.size(), [&](const size_t i) {
+            ids[i] = interned_string{"interned_string.concurrent" + std::to_string(i % 10)}.id();
+        });
+
+        for (size_t i = 0; i < ids.size(); ++i) {
+            CHECK(ids[i] == ids[i % 10]);
+            CHECK(*ids[i] == "interned_string.concurrent" + std::to_string(i % 10));
+        }
+    }
+}
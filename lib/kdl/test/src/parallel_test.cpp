@@ -21,6 +21,7 @@
 #include <atomic>
 #include <chrono>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -82,6 +83,99 @@ namespace kdl {
         CHECK(expected == kdl::vec_parallel_transform(input, [](int i){ return std::to_string(i); }));
     }
 
+    TEST_CASE("for with grain size", "[parallel_test]") {
+        constexpr size_t TestSize = 1'000;
+
+        std::array<std::atomic<size_t>, TestSize> indices;
+        for (size_t i = 0; i < TestSize; ++i) {
+            indices[i] = 0;
+        }
+
+        const auto grainSize = GENERATE(size_t(1), size_t(7), size_t(1'000), size_t(2'000));
+        kdl::parallel_for(indices.size(), [&](const size_t i) {
+            std::atomic_fetch_add(&indices[i], static_cast<size_t>(1));
+        }, grainSize);
+
+        for (size_t i = 0; i < TestSize; ++i) {
+            CHECK(indices[i] == 1u);
+        }
+    }
+
+    TEST_CASE("for chunks", "[parallel_test]") {
+        auto covered = std::atomic<size_t>{0};
+        auto maxChunkSize = std::atomic<size_t>{0};
+
+        kdl::parallel_for_chunks(1'003, [&](const size_t begin, const size_t end) {
+            CHECK(begin < end);
+            std::atomic_fetch_add(&covered, end - begin);
+
+            auto current = maxChunkSize.load();
+            while (current < end - begin && !maxChunkSize.compare_exchange_weak(current, end - begin)) {}
+        }, 10);
+
+        CHECK(covered == 1'003u);
+        CHECK(maxChunkSize == 10u);
+    }
+
+    TEST_CASE("nested for", "[parallel_test]") {
+        constexpr size_t OuterSize = 50;
+        constexpr size_t InnerSize = 50;
+
+        std::array<std::atomic<size_t>, OuterSize * InnerSize> indices;
+        for (size_t i = 0; i < OuterSize * InnerSize; ++i) {
+            indices[i] = 0;
+        }
+
+        kdl::parallel_for(OuterSize, [&](const size_t i) {
+            kdl::parallel_for(InnerSize, [&](const size_t j) {
+                std::atomic_fetch_add(&indices[i * InnerSize + j], static_cast<size_t>(1));
+            }, 1);
+        }, 1);
+
+        for (size_t i = 0; i < OuterSize * InnerSize; ++i) {
+            CHECK(indices[i] == 1u);
+        }
+    }
+
+    TEST_CASE("for propagates exceptions", "[parallel_test]") {
+        auto count = std::atomic<size_t>{0};
+        CHECK_THROWS_AS(kdl::parallel_for(100, [&](const size_t i) {
+            std::atomic_fetch_add(&count, static_cast<size_t>(1));
+            if (i == 50) {
+                throw std::runtime_error{"failed"};
+            }
+        }, 1), std::runtime_error);
+        CHECK(count == 100u);
+    }
+
+    TEST_CASE("reduce", "[parallel_test]") {
+        const auto square = [](const size_t i) { return i * i; };
+        const auto plus = [](const size_t lhs, const size_t rhs) { return lhs + rhs; };
+
+        CHECK(kdl::parallel_reduce(0, size_t(0), square, plus) == 0u);
+        CHECK(kdl::parallel_reduce(1, size_t(0), square, plus) == 0u);
+        CHECK(kdl::parallel_reduce(4, size_t(0), square, plus) == 14u);
+
+        size_t expected = 0;
+        for (size_t i = 0; i < 10'000; ++i) {
+            expected += i * i;
+        }
+        CHECK(kdl::parallel_reduce(10'000, size_t(0), square, plus) == expected);
+        CHECK(kdl::parallel_reduce(10'000, size_t(0), square, plus, 3) == expected);
+    }
+
+    TEST_CASE("reduce preserves order", "[parallel_test]") {
+        const auto toString = [](const size_t i) { return std::to_string(i % 10); };
+        const auto concat = [](std::string lhs, const std::string& rhs) { return lhs + rhs; };
+
+        std::string expected;
+        for (size_t i = 0; i < 1'000; ++i) {
+            expected += toString(i);
+        }
+
+        CHECK(kdl::parallel_reduce(1'000, std::string{}, toString, concat, 7) == expected);
+    }
+
     TEST_CASE("overhead for small work batches", "[parallel_test]") {
         constexpr size_t OuterLoop = 1'000;
         constexpr size_t InnerLoop = 10;
@@ -186,4 +186,47 @@ namespace kdl {
         CHECK(str_to_long_double(" ") == std::nullopt);
         CHECK(str_to_long_double("") == std::nullopt);
     }
+
+    TEST_CASE("string_utils_test.str_parse_long", "[string_utils_test]") {
+        CHECK(str_parse_long("0") == std::optional<long>{0l});
+        CHECK(str_parse_long("1") == std::optional<long>{1l});
+        CHECK(str_parse_long("+1") == std::optional<long>{1l});
+        CHECK(str_parse_long("123231") == std::optional<long>{123231l});
+        CHECK(str_parse_long("-123231") == std::optional<long>{-123231l});
+        CHECK(str_parse_long("2147483647") == std::optional<long>{2147483647l});
+        CHECK(str_parse_long("-2147483646") == std::optional<long>{-2147483646l});
+
+        // these are handled by str_to_long
+        CHECK(str_parse_long("123231b") == std::optional<long>{123231l});
+        CHECK(str_parse_long("   123231   ") == std::optional<long>{123231l});
+        CHECK(str_parse_long("a123231") == std::nullopt);
+        CHECK(str_parse_long("-") == std::nullopt);
+        CHECK(str_parse_long(" ") == std::nullopt);
+        CHECK(str_parse_long("") == std::nullopt);
+    }
+
+    TEST_CASE("string_utils_test.str_parse_double", "[string_utils_test]") {
+        CHECK(str_parse_double("0") == std::optional<double>{0.0});
+        CHECK(str_parse_double("1.0") == std::optional<double>{1.0});
+        CHECK(str_parse_double("-1.5") == std::optional<double>{-1.5});
+        CHECK(str_parse_double("+1.5") == std::optional<double>{1.5});
+        CHECK(str_parse_double(".5") == std::optional<double>{0.5});
+        CHECK(str_parse_double("5.") == std::optional<double>{5.0});
+        CHECK(str_parse_double("0.1") == std::optional<double>{0.1});
+        CHECK(str_parse_double("-0.000001") == std::optional<double>{-0.000001});
+        CHECK(str_parse_double("12328.38283") == std::optional<double>{12328.38283});
+        CHECK(str_parse_double("1e3") == std::optional<double>{1000.0});
+        CHECK(str_parse_double("1.5E-3") == std::optional<double>{0.0015});
+        CHECK(str_parse_double("-1024.0000000000002") == std::optional<double>{-1024.0000000000002});
+        CHECK(str_parse_double("0.30000000000000004") == std::optional<double>{0.30000000000000004});
+
+        // these are handled by str_to_double
+        CHECK(str_parse_double("123456789012345678901234567890") == std::optional<double>{123456789012345678901234567890.0});
+        CHECK(str_parse_double("1e100") == std::optional<double>{1e100});
+        CHECK(str_parse_double(" 1.0") == std::optional<double>{1.0});
+        CHECK(str_parse_double("a123231.0") == std::nullopt);
+        CHECK(str_parse_double(".") == std::nullopt);
+        CHECK(str_parse_double(" ") == std::nullopt);
+        CHECK(str_parse_double("") == std::nullopt);
+    }
 }
@@ -0,0 +1,146 @@
+/*
+ Copyright 2022 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/thread_pool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+namespace kdl {
+    TEST_CASE("thread_pool.thread_count", "[thread_pool_test]") {
+        CHECK(thread_pool{0}.thread_count() == 1u);
+        CHECK(thread_pool{3}.thread_count() == 3u);
+        CHECK(thread_pool{3}.concurrency() == 4u);
+        CHECK(global_thread_pool().thread_count() >= 1u);
+    }
+
+    TEST_CASE("thread_pool.is_worker_thread", "[thread_pool_test]") {
+        auto pool = thread_pool{2};
+        CHECK_FALSE(pool.is_worker_thread());
+
+        auto isWorkerThread = std::atomic<bool>{false};
+        auto group = task_group{pool};
+        group.run([&]() { isWorkerThread = pool.is_worker_thread(); });
+        group.wait();
+
+        // the task may have been executed by the waiting thread
+        CHECK((isWorkerThread || !pool.is_worker_thread()));
+    }
+
+    TEST_CASE("thread_pool.submit", "[thread_pool_test]") {
+        auto count = std::atomic<size_t>{0};
+        {
+            auto pool = thread_pool{2};
+            for (size_t i = 0; i < 100; ++i) {
+                pool.submit([&]() { std::atomic_fetch_add(&count, size_t(1)); });
+            }
+            // the destructor executes all pending tasks
+        }
+        CHECK(count == 100u);
+    }
+
+    TEST_CASE("task_group.wait", "[thread_pool_test]") {
+        auto pool = thread_pool{2};
+        auto count = std::atomic<size_t>{0};
+
+        auto group = task_group{pool};
+        for (size_t i = 0; i < 1'000; ++i) {
+            group.run([&]() { std::atomic_fetch_add(&count, size_t(1)); });
+        }
+        group.wait();
+        CHECK(count == 1'000u);
+
+        // groups can be reused after waiting
+        group.run([&]() { std::atomic_fetch_add(&count, size_t(1)); });
+        group.wait();
+        CHECK(count == 1'001u);
+    }
+
+    TEST_CASE("task_group.nested", "[thread_pool_test]") {
+        // use a single worker thread to make sure that the waiting threads help processing the tasks
+        auto pool = thread_pool{1};
+        auto count = std::atomic<size_t>{0};
+
+        auto outer = task_group{pool};
+        for (size_t i = 0; i < 10; ++i) {
+            outer.run([&]() {
+                auto inner = task_group{pool};
+                for (size_t j = 0; j < 10; ++j) {
+                    inner.run([&]() { std::atomic_fetch_add(&count, size_t(1)); });
+                }
+                inner.wait();
+            });
+        }
+        outer.wait();
+        CHECK(count == 100u);
+    }
+
+    TEST_CASE("task_group.wait_only_runs_own_tasks", "[thread_pool_test]") {
+        auto pool = thread_pool{1};
+        const auto waitingThread = std::this_thread::get_id();
+
+        // keep the worker busy until the waiting thread has finished
+        auto release = std::atomic<bool>{false};
+        auto blocker = task_group{pool};
+        blocker.run([&]() {
+            while (!release) {
+                std::this_thread::yield();
+            }
+        });
+
+        auto otherRanOnWaitingThread = std::atomic<bool>{false};
+        auto other = task_group{pool};
+        other.run([&]() { otherRanOnWaitingThread = std::this_thread::get_id() == waitingThread; });
+
+        auto count = std::atomic<size_t>{0};
+        auto own = task_group{pool};
+        for (size_t i = 0; i < 10; ++i) {
+            own.run([&]() { std::atomic_fetch_add(&count, size_t(1)); });
+        }
+        own.wait();
+
+        CHECK(count == 10u);
+        CHECK_FALSE(otherRanOnWaitingThread);
+
+        release = true;
+        blocker.wait();
+        other.wait();
+    }
+
+    TEST_CASE("task_group.exception", "[thread_pool_test]") {
+        auto pool = thread_pool{2};
+        auto count = std::atomic<size_t>{0};
+
+        auto group = task_group{pool};
+        for (size_t i = 0; i < 10; ++i) {
+            group.run([&, i]() {
+                std::atomic_fetch_add(&count, size_t(1));
+                if (i == 5) {
+                    throw std::runtime_error{"failed"};
+                }
+            });
+        }
+        CHECK_THROWS_AS(group.wait(), std::runtime_error);
+        CHECK(count == 10u);
+
+        // the exception is only rethrown once
+        CHECK_NOTHROW(group.wait());
+    }
+}